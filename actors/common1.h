@@ -217,6 +217,7 @@ extern const GeoLayout mist_geo[];
 extern const GeoLayout white_puff_geo[];
 extern const Gfx mist_seg3_dl_03000880[];
 extern const Gfx mist_seg3_dl_03000920[];
+extern const Gfx mist_particle_dl_begin[];
 
 // mushroom_1up
 extern const GeoLayout mushroom_1up_geo[];
@@ -245,6 +246,7 @@ extern const Gfx dl_breath_meter_health_segments_end[];
 
 // sand
 extern const Gfx sand_seg3_dl_particle[];
+extern const Gfx sand_particle_dl_begin[];
 
 // star
 extern const GeoLayout star_geo[];
@@ -284,6 +286,7 @@ extern const Collision warp_pipe_seg3_collision_03009AC8[];
 // white_particle
 extern const GeoLayout white_particle_geo[];
 extern const Gfx white_particle_dl[];
+extern const Gfx white_particle_dl_begin[];
 
 // wooden_signpost
 extern const GeoLayout wooden_signpost_geo[];
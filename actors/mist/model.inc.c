@@ -21,6 +21,16 @@ ALIGNED8 static const Texture mist_seg3_texture_03000080[] = {
 #include "actors/mist/mist.ia16.inc.c"
 };
 
+// Used by the particle system, which fades mist through the vertex alpha.
+const Gfx mist_particle_dl_begin[] = {
+    gsDPPipeSync(),
+    gsSPClearGeometryMode(G_LIGHTING),
+    gsDPSetCombineMode(G_CC_MODULATEIA, G_CC_MODULATEIA),
+    gsDPLoadTextureBlock(mist_seg3_texture_03000080, G_IM_FMT_IA, G_IM_SIZ_16b, 32, 32, 0, G_TX_CLAMP, G_TX_CLAMP, 5, 5, G_TX_NOLOD, G_TX_NOLOD),
+    gsSPTexture(0xFFFF, 0xFFFF, 0, G_TX_RENDERTILE, G_ON),
+    gsSPEndDisplayList(),
+};
+
 // 0x03000880 - 0x03000920
 const Gfx mist_seg3_dl_03000880[] = {
     gsDPPipeSync(),
@@ -13,6 +13,16 @@ ALIGNED8 static const Texture sand_seg3_texture_particle[] = {
 #include "actors/sand/sand_particle.rgba16.inc.c"
 };
 
+// Used by the particle system
+const Gfx sand_particle_dl_begin[] = {
+    gsDPPipeSync(),
+    gsSPClearGeometryMode(G_LIGHTING),
+    gsDPSetCombineMode(G_CC_DECALRGBA, G_CC_DECALRGBA),
+    gsDPLoadTextureBlock(sand_seg3_texture_particle, G_IM_FMT_RGBA, G_IM_SIZ_16b, 16, 16, 0, G_TX_CLAMP, G_TX_CLAMP, 4, 4, G_TX_NOLOD, G_TX_NOLOD),
+    gsSPTexture(0xFFFF, 0xFFFF, 0, G_TX_RENDERTILE, G_ON),
+    gsSPEndDisplayList(),
+};
+
 // 0x0302BCD0 - 0x0302BD60
 const Gfx sand_seg3_dl_particle[] = {
     gsDPPipeSync(),
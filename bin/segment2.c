@@ -2692,6 +2692,29 @@ const Gfx dl_shadow_end[] = {
     gsSPEndDisplayList(),
 };
 
+// Batched circle shadows take their solidity from the vertex alpha instead of the env color.
+// Fog is left alone like in dl_shadow_begin, since fogged display lists turn it off again when they end.
+const Gfx dl_shadow_batch_circle[] = {
+    gsDPPipeSync(),
+    gsSPClearGeometryMode(G_LIGHTING | G_CULL_BACK),
+    gsDPSetCombineMode(G_CC_MODULATEIA, G_CC_MODULATEIA),
+    gsSPTexture(0xFFFF, 0xFFFF, 0, G_TX_RENDERTILE, G_ON),
+#ifdef HD_SHADOWS
+    gsDPLoadTextureBlock(texture_shadow_quarter_circle_64, G_IM_FMT_IA, G_IM_SIZ_8b, 64, 64, 0, (G_TX_WRAP | G_TX_MIRROR), (G_TX_WRAP | G_TX_MIRROR), 6, 6, G_TX_NOLOD, G_TX_NOLOD),
+#else
+    gsDPLoadTextureBlock(texture_shadow_quarter_circle, G_IM_FMT_IA, G_IM_SIZ_8b, 16, 16, 0, (G_TX_WRAP | G_TX_MIRROR), (G_TX_WRAP | G_TX_MIRROR), 4, 4, G_TX_NOLOD, G_TX_NOLOD),
+#endif
+    gsSPEndDisplayList(),
+};
+
+const Gfx dl_shadow_batch_end[] = {
+    gsDPPipeSync(),
+    gsSPTexture(0xFFFF, 0xFFFF, 0, G_TX_RENDERTILE, G_OFF),
+    gsSPSetGeometryMode(G_LIGHTING | G_CULL_BACK),
+    gsDPSetCombineMode(G_CC_SHADE, G_CC_SHADE),
+    gsSPEndDisplayList(),
+};
+
 // 0x02014660 - 0x02014698
 const Gfx dl_proj_mtx_fullscreen[] = {
     gsDPPipeSync(),
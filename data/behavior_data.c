@@ -124,6 +124,7 @@ enum BehaviorCommands {
     /*0x35*/ BHV_CMD_DISABLE_RENDERING,
     /*0x36*/ BHV_CMD_SET_INT_UNUSED,
     /*0x37*/ BHV_CMD_SPAWN_WATER_DROPLET,
+    /*0x38*/ BHV_CMD_SLEEP_UNTIL_MARIO_WITHIN,
 };
 
 // Defines the start of the behavior script as well as the object list the object belongs to.
@@ -389,6 +390,10 @@ enum BehaviorCommands {
     BC_B(BHV_CMD_SPAWN_WATER_DROPLET), \
     BC_PTR(dropletParams)
 
+// Stops updating the object until Mario is within the given distance, then continues with the next command.
+#define SLEEP_UNTIL_MARIO_WITHIN(dist) \
+    BC_B0H(BHV_CMD_SLEEP_UNTIL_MARIO_WITHIN, dist)
+
 
 const BehaviorScript bhvStarDoor[] = {
     BEGIN(OBJ_LIST_SURFACE),
@@ -2,9 +2,9 @@
 $(BUILD_DIR)/%.gz: $(BUILD_DIR)/%.bin
 	$(call print,Compressing:,$<,$@)
 ifeq ($(GZIPVER),std)
-	$(V)$(GZIP) -c -9 -n $< > $@
+	$(V)$(call compress,$<,$@,$(GZIP) -c -9 -n {in})
 else
-	$(V)$(GZIP) -c -12 -n $< > $@
+	$(V)$(call compress,$<,$@,$(GZIP) -c -12 -n {in})
 endif
 
 # Strip gzip header
@@ -13,3 +13,7 @@
 // Uses a much better implementation of reverb over vanilla's fake echo reverb. Great for caves or eerie levels, as well as just a better audio experience in general.
 // Reverb parameters can be configured in audio/synthesis.c to meet desired aesthetic/performance needs. Currently US/JP only. Hurts emulator and console performance.
 // #define BETTER_REVERB
+
+// Limits the estimated synthesis cost of all playing notes per audio update (US/JP only). Once over budget, the lowest priority notes are faded out, quietest first.
+// A plain ADPCM note played at its recorded pitch costs 8, higher pitches and reverb cost more (see playback.h). Stolen notes are counted on the puppyprint audio page.
+// #define AUDIO_NOTE_COST_BUDGET 160
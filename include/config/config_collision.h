@@ -14,6 +14,12 @@
 // Allows all surfaces types to have force, (doesn't require setting force, just allows it to be optional).
 #define ALL_SURFACES_HAVE_FORCE
 
+// Sweeps Mario's whole air motion for the frame against the collision before stepping it, so the usual four quarter steps
+// are only used when something is actually in the way or the frame ends out of bounds.
+// This changes vanilla physics: Mario takes more than four air steps from 200 units/frame, and fast objects check walls
+// along their path, so they can't pass through walls. Speed tricks and ledge grabs at those speeds behave differently.
+// #define SWEPT_COLLISION
+
 // Number of walls that can push Mario at once. Vanilla is 4.
 #define MAX_REFERENCED_WALLS 4
 
@@ -32,6 +32,14 @@
 // Uses cycles instead of microseconds in Puppyprint debug output.
 // #define PUPPYPRINT_DEBUG_CYCLES
 
+// Samples the game thread's program counter from a timer and shows the hottest functions on a
+// PUPPYPRINT_DEBUG page. Press D-pad right on the page to dump the samples for tools/pcprof.py (needs UNF or ISVPRINT).
+// #define PC_PROFILER
+
+// Traces every allocation from the main pool, memory pools, audio heap and display list pool: each pool's
+// usage, peak and failures, the busiest call sites and the most recent allocations are shown on the crash screen.
+// #define ALLOC_TRACE
+
 // A vanilla style debug mode. It doesn't rely on a text engine, but it's much less powerful that PUPPYPRINT_DEBUG.
 // Press D-pad left to show the debug UI.
 // #define VANILLA_STYLE_CUSTOM_DEBUG
@@ -50,6 +58,11 @@
 // Removes the limit on FPS.
 // #define UNLOCK_FPS
 
+// With UNLOCK_FPS, keeps the game logic at 30 FPS and draws a frame every vblank, interpolating objects, animations
+// and the camera between the last two game steps. Frames are shown up to half a step late.
+// The frames in between are built after the step's frame in the same gfx pool, so GFX_POOL_SIZE may need raising.
+// #define UNLOCK_FPS_INTERPOLATION
+
 // Includes vanilla debug functionality.
 // #define VANILLA_DEBUG
 
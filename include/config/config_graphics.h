@@ -7,6 +7,12 @@
 // The size of the master display list (gDisplayListHead). 6400 is vanilla.
 #define GFX_POOL_SIZE 10000
 
+// Lets the game logic for the next frame run while the RCP is still rendering the current one, instead of waiting out
+// the vblank after every frame. Frames are shown one frame later, and any memory the display list points to must
+// either come from the gfx pool or be left alone until the frame is done (see display_and_vsync).
+// The CPU/RCP overlap is shown on the USE_PROFILER page.
+// #define PIPELINED_FRAMES
+
 // Show a watermark on the title screen that reads "Made with HackerSM64", instead of the copyright message.
 #define INTRO_CREDIT
 
@@ -85,6 +91,14 @@
 // Disables all object shadows. You'll probably only want this either as a last resort for performance or if you're making a super stylized hack.
 // #define DISABLE_SHADOWS
 
+// Draws all circle shadows on the same layer from one vertex buffer and display list per frame,
+// instead of loading a matrix, texture and render settings for each shadow.
+#define BATCH_CIRCLE_SHADOWS
+
+// Shadows further than this from the camera are skipped, and fade out over the last quarter of the distance.
+// Mario's shadow is always drawn.
+// #define SHADOW_DRAW_DISTANCE 4000
+
 // Uses old shadow IDs for Fast64 compatibility. This is a temporary fix until Fast64 is updated to use the enum defines.
 // NOTE: When this is enabled, The 49th hardcoded rectangle shadow will act as a regular circular shadow, due to Mario's shadow ID being 99 in vanilla.
 #define LEGACY_SHADOW_IDS
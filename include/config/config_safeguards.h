@@ -47,6 +47,8 @@
     #undef COMPLETE_SAVE_FILE
     #undef DEBUG_FORCE_CRASH_ON_BOOT
     #undef USE_PROFILER
+    #undef PC_PROFILER
+    #undef ALLOC_TRACE
 #endif // DISABLE_ALL
 
 #ifdef DEBUG_ALL
@@ -84,6 +86,23 @@
     #define UNLOCK_ALL
 #endif // COMPLETE_SAVE_FILE
 
+// Interpolation only draws the frames UNLOCK_FPS allows in between game steps.
+#ifndef UNLOCK_FPS
+    #undef UNLOCK_FPS_INTERPOLATION
+#endif // !UNLOCK_FPS
+
+// The PC profiler shows its results on a puppyprint page.
+#ifndef PUPPYPRINT_DEBUG
+    #undef PC_PROFILER
+#endif // !PUPPYPRINT_DEBUG
+
+// Counts floor/ceiling/wall queries and Mario's quarter steps in gNumCalls.
+// Also set on its own by the host tools in tools/mario_sim.
+#ifdef VANILLA_DEBUG
+    #undef COUNT_COLLISION_CALLS
+    #define COUNT_COLLISION_CALLS
+#endif // VANILLA_DEBUG
+
 
 /*****************
  * config_camera.h
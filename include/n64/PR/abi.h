@@ -233,9 +233,19 @@ typedef struct {
  * Generic Acmd Packet
  */
 
+/*
+ * The audio code steps through command lists as u64 words, so on a 64-bit host
+ * (tools/audio_render) both words stay 32 bits wide. DRAM addresses passed in
+ * commands must then lie below 4 GiB, which a -no-pie build guarantees.
+ */
 typedef struct {
+#if !defined(TARGET_N64) && UINTPTR_MAX > 0xFFFFFFFFU
+    unsigned int w0;
+    unsigned int w1;
+#else
     uintptr_t w0;
     uintptr_t w1;
+#endif
 } Awords;
 
 typedef union {
@@ -9,7 +9,7 @@ enum ObjActiveFlags {
     ACTIVE_FLAG_DEACTIVATED                    = (0 <<  0), // 0x0000
     ACTIVE_FLAG_ACTIVE                         = (1 <<  0), // 0x0001
     ACTIVE_FLAG_FAR_AWAY                       = (1 <<  1), // 0x0002
-    ACTIVE_FLAG_UNUSED                         = (1 <<  2), // 0x0004
+    ACTIVE_FLAG_SLEEPING                       = (1 <<  2), // 0x0004
     ACTIVE_FLAG_IN_DIFFERENT_ROOM              = (1 <<  3), // 0x0008
     ACTIVE_FLAG_UNIMPORTANT                    = (1 <<  4), // 0x0010
     ACTIVE_FLAG_INITIATED_TIME_STOP            = (1 <<  5), // 0x0020
@@ -0,0 +1,107 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <PR/ultratypes.h>
+
+#include "macros.h"
+
+/**
+ * Lock-free ring for passing entries from one thread to another.
+ *
+ * The ring only tracks indices; the entries live in an array owned by the caller, whose
+ * size must be a power of two. Exactly one thread may produce (reserve and submit) and
+ * exactly one may consume (peek and consume). The producer is the only one to write `head`
+ * and the consumer the only one to write `tail`, so neither side needs to disable
+ * interrupts or wait on an OSMesgQueue.
+ *
+ * The N64 has a single CPU, so the only reordering to guard against is the compiler's:
+ * entries are written before spsc_ring_submit() publishes them, and read before
+ * spsc_ring_consume() frees them.
+ *
+ * Producer:
+ *     count = spsc_ring_reserve(&ring, n, &start);
+ *     for (i = 0; i < count; i++) entries[SPSC_RING_INDEX(&ring, start + i)] = ...;
+ *     spsc_ring_submit(&ring, count);
+ *
+ * Consumer:
+ *     count = spsc_ring_peek(&ring, &start);
+ *     for (i = 0; i < count; i++) ... = entries[SPSC_RING_INDEX(&ring, start + i)];
+ *     spsc_ring_consume(&ring, count);
+ */
+struct SPSCRing {
+    volatile u32 head; // Entries submitted so far, only written by the producer
+    volatile u32 tail; // Entries consumed so far, only written by the consumer
+    u32 mask;          // Size of the entry array - 1
+    u32 overflows;     // Entries dropped because the ring was full, only written by the producer
+    u32 peak;          // Most entries pending at once, only written by the producer
+};
+
+#define SPSC_RING_INIT(size) { 0, 0, ((size) - 1), 0, 0 }
+#define SPSC_RING_INDEX(ring, i) ((i) & (ring)->mask)
+
+// Keeps the compiler from moving entry accesses across an index update.
+#define SPSC_RING_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+/**
+ * Empties the ring and clears its counters. Neither side may be using it.
+ */
+static ALWAYS_INLINE void spsc_ring_reset(struct SPSCRing *ring) {
+    ring->head = 0;
+    ring->tail = 0;
+    ring->overflows = 0;
+    ring->peak = 0;
+}
+
+/**
+ * Producer: reserves up to `count` entries to write, starting at `*start`. Returns how many
+ * were reserved; the rest are counted as overflows and should be dropped.
+ */
+static ALWAYS_INLINE u32 spsc_ring_reserve(struct SPSCRing *ring, u32 count, u32 *start) {
+    u32 space = ((ring->mask + 1) - (ring->head - ring->tail));
+
+    if (count > space) {
+        ring->overflows += (count - space);
+        count = space;
+    }
+
+    *start = ring->head;
+    return count;
+}
+
+/**
+ * Producer: hands the first `count` reserved entries to the consumer.
+ */
+static ALWAYS_INLINE void spsc_ring_submit(struct SPSCRing *ring, u32 count) {
+    u32 pending;
+
+    SPSC_RING_BARRIER();
+    ring->head += count;
+
+    pending = (ring->head - ring->tail);
+    if (pending > ring->peak) {
+        ring->peak = pending;
+    }
+}
+
+/**
+ * Consumer: returns how many entries are ready to read, starting at `*start`.
+ */
+static ALWAYS_INLINE u32 spsc_ring_peek(struct SPSCRing *ring, u32 *start) {
+    u32 count;
+
+    *start = ring->tail;
+    count = (ring->head - *start);
+    SPSC_RING_BARRIER();
+
+    return count;
+}
+
+/**
+ * Consumer: frees the first `count` entries returned by spsc_ring_peek() for the producer.
+ */
+static ALWAYS_INLINE void spsc_ring_consume(struct SPSCRing *ring, u32 count) {
+    SPSC_RING_BARRIER();
+    ring->tail += count;
+}
+
+#endif // SPSC_RING_H
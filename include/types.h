@@ -213,7 +213,7 @@ struct Animation {
     /*0x04*/ s16 startFrame;
     /*0x06*/ s16 loopStart;
     /*0x08*/ s16 loopEnd;
-    /*0x0A*/ s16 unusedBoneCount;
+    /*0x0A*/ s16 numParts; // Set by ANIMINDEX_NUMPARTS
     /*0x0C*/ const s16 *values;
     /*0x10*/ const u16 *index;
     /*0x14*/ u32 length; // only used with Mario animations to determine how much to load. 0 otherwise.
@@ -238,8 +238,30 @@ struct AnimInfo {
     /*0x0A 0x42*/ u16 animTimer;
     /*0x0C 0x44*/ s32 animFrameAccelAssist;
     /*0x10 0x48*/ s32 animAccel;
+#ifdef UNLOCK_FPS_INTERPOLATION
+    struct Animation *interpAnim[2];
+    s16 interpFrame[2];
+    u16 interpStep;
+#endif
+};
+
+#ifdef UNLOCK_FPS_INTERPOLATION
+// An object's transform in the last two game steps, for drawing the frames in between.
+struct GraphNodeObjectInterp {
+    Vec3f pos[2];
+    Vec3f scale[2];
+    Vec3s angle[2];
+    u16 step; // gInterpStep when [1] was saved
 };
 
+// The same for a camera.
+struct CameraInterp {
+    Vec3f pos[2];
+    Vec3f focus[2];
+    u16 step;
+};
+#endif
+
 struct GraphNodeObject {
     /*0x00*/ struct GraphNode node;
     /*0x14*/ struct GraphNode *sharedChild;
@@ -255,6 +277,9 @@ struct GraphNodeObject {
 #ifdef OBJECTS_REJ
     u16 ucode;
 #endif
+#ifdef UNLOCK_FPS_INTERPOLATION
+    struct GraphNodeObjectInterp interp;
+#endif
 };
 
 struct ObjectNode {
@@ -276,6 +301,14 @@ struct PuppyLight {
 };
 #endif
 
+// Conditions that wake a sleeping object. See cur_obj_sleep_until.
+struct ObjectSleep {
+    /*0x00*/ f32 wakeDistSq; // Squared distance from Mario to wake at, or 0 to ignore
+    /*0x04*/ u32 wakeFrame;  // gGlobalTimer value to wake at, or 0 to ignore
+    /*0x08*/ s32 *watch;     // Field to watch for a change, or NULL to ignore
+    /*0x0C*/ s32 watchValue;
+};
+
 // NOTE: Since ObjectNode is the first member of Object, it is difficult to determine
 // whether some of these pointers point to ObjectNode or Object.
 
@@ -342,6 +375,7 @@ struct Object {
     /*0x218*/ void *collisionData;
     /*0x21C*/ Mat4 transform;
     /*0x25C*/ void *respawnInfo;
+    /*0x260*/ struct ObjectSleep sleep;
 #ifdef PUPPYLIGHTS
     struct PuppyLight puppylight;
 #endif
@@ -1,7 +1,7 @@
 # Compress binary file
 $(BUILD_DIR)/%.szp: $(BUILD_DIR)/%.bin
 	$(call print,Compressing:,$<,$@)
-	$(V)$(MIO0TOOL) $< $@
+	$(V)$(call compress,$<,$@,$(MIO0TOOL) {in} {out})
 
 # convert binary szp to object file
 $(BUILD_DIR)/%.szp.o: $(BUILD_DIR)/%.szp
@@ -1,7 +1,7 @@
 # Compress binary file
 $(BUILD_DIR)/%.szp: $(BUILD_DIR)/%.bin
 	$(call print,Compressing:,$<,$@)
-	$(V)$(RNCPACK) p $< $@ -m2
+	$(V)$(call compress,$<,$@,$(RNCPACK) p {in} {out} -m2)
 
 # convert binary szp to object file
 $(BUILD_DIR)/%.szp.o: $(BUILD_DIR)/%.szp
@@ -125,9 +125,6 @@ s32 sDialogSpeakerVoice[] = {
 #endif
 };
 
-u8 sNumProcessedSoundRequests = 0;
-u8 sSoundRequestCount = 0;
-
 // Music dynamic tables. A dynamic describes which volumes to apply to which
 // channels of a sequence (I think?), and different parts of a level can have
 // different dynamics. Each table below specifies first the sequence to apply
@@ -338,6 +335,8 @@ struct UnkStruct80343D00 D_SH_80343D00;
 #endif
 
 struct Sound sSoundRequests[0x100];
+// Produced by play_sound on the game thread and consumed by process_all_sound_requests
+struct SPSCRing gSoundRequestRing = SPSC_RING_INIT(ARRAY_COUNT(sSoundRequests));
 // Curiously, this has size 3, despite SEQUENCE_PLAYERS == 4 on EU
 struct ChannelVolumeScaleFade D_80360928[3][CHANNELS_MAX];
 u8 sUsedChannelsForSoundBank[SOUND_BANK_COUNT];
@@ -687,9 +686,18 @@ struct SPTask *create_next_audio_frame_task(void) {
  * Called from threads: thread5_game_loop
  */
 void play_sound(s32 soundBits, f32 *pos) {
-    sSoundRequests[sSoundRequestCount].soundBits = soundBits;
-    sSoundRequests[sSoundRequestCount].position = pos;
-    sSoundRequestCount++;
+    struct Sound *sound;
+    u32 index;
+
+    // If the ring is full, the request is dropped and counted as an overflow.
+    if (spsc_ring_reserve(&gSoundRequestRing, 1, &index) == 0) {
+        return;
+    }
+
+    sound = &sSoundRequests[SPSC_RING_INDEX(&gSoundRequestRing, index)];
+    sound->soundBits = soundBits;
+    sound->position = pos;
+    spsc_ring_submit(&gSoundRequestRing, 1);
 }
 
 /**
@@ -780,12 +788,15 @@ static void process_sound_request(u32 bits, f32 *pos) {
  */
 static void process_all_sound_requests(void) {
     struct Sound *sound;
+    u32 start;
+    u32 count = spsc_ring_peek(&gSoundRequestRing, &start);
+    u32 i;
 
-    while (sSoundRequestCount != sNumProcessedSoundRequests) {
-        sound = &sSoundRequests[sNumProcessedSoundRequests];
+    for (i = 0; i < count; i++) {
+        sound = &sSoundRequests[SPSC_RING_INDEX(&gSoundRequestRing, start + i)];
         process_sound_request(sound->soundBits, sound->position);
-        sNumProcessedSoundRequests++;
     }
+    spsc_ring_consume(&gSoundRequestRing, count);
 }
 
 /**
@@ -1980,8 +1991,7 @@ void sound_init(void) {
     sBackgroundMusicMaxTargetVolume = TARGET_VOLUME_UNSET;
     D_80332120 = 0;
     D_80332124 = 0;
-    sNumProcessedSoundRequests = 0;
-    sSoundRequestCount = 0;
+    spsc_ring_reset(&gSoundRequestRing);
 }
 
 // (unused)
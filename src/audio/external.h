@@ -4,6 +4,7 @@
 #include <PR/ultratypes.h>
 
 #include "types.h"
+#include "spsc_ring.h"
 
 // Sequence arguments, passed to seq_player_play_sequence. seqId may be bit-OR'ed with
 // SEQ_VARIATION; this will load the same sequence, but set a variation
@@ -30,6 +31,7 @@ struct SequenceQueueItem {
 
 extern s32 gAudioErrorFlags;
 extern f32 gGlobalSoundSource[3];
+extern struct SPSCRing gSoundRequestRing;
 
 // defined in data.c, used by the game
 extern u32 gAudioRandom;
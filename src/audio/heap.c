@@ -6,6 +6,7 @@
 #include "synthesis.h"
 #include "seqplayer.h"
 #include "effects.h"
+#include "boot/alloc_trace.h"
 #include "game/game_init.h"
 #include "game/puppyprint.h"
 #include "game/vc_check.h"
@@ -234,9 +235,11 @@ void *soundAlloc(struct SoundAllocPool *pool, u32 size) {
         pool->cur += alignedSize;
     } else {
         eu_stubbed_printf_1("Heap OverFlow : Not Allocate %d!\n", size);
+        ALLOC_TRACE_ALLOC(ALLOC_TRACE_SOUND, pool, alignedSize, NULL, (pool->cur - pool->start), pool->size);
         return NULL;
     }
     pool->numAllocatedEntries++;
+    ALLOC_TRACE_ALLOC(ALLOC_TRACE_SOUND, pool, alignedSize, start, (pool->cur - pool->start), pool->size);
     return start;
 #else
     u32 alignedSize = ALIGN16(size);
@@ -246,8 +249,10 @@ void *soundAlloc(struct SoundAllocPool *pool, u32 size) {
         bzero(start, alignedSize);
         pool->cur += alignedSize;
     } else {
+        ALLOC_TRACE_ALLOC(ALLOC_TRACE_SOUND, pool, alignedSize, NULL, (pool->cur - pool->start), pool->size);
         return NULL;
     }
+    ALLOC_TRACE_ALLOC(ALLOC_TRACE_SOUND, pool, alignedSize, start, (pool->cur - pool->start), pool->size);
     return start;
 #endif
 }
@@ -261,10 +266,12 @@ void *sound_alloc_uninitialized(struct SoundAllocPool *pool, u32 size) {
     if (start + alignedSize <= pool->start + pool->size) {
         pool->cur += alignedSize;
     } else {
+        ALLOC_TRACE_ALLOC(ALLOC_TRACE_SOUND, pool, alignedSize, NULL, (pool->cur - pool->start), pool->size);
         return NULL;
     }
 
     pool->numAllocatedEntries++;
+    ALLOC_TRACE_ALLOC(ALLOC_TRACE_SOUND, pool, alignedSize, start, (pool->cur - pool->start), pool->size);
     return start;
 }
 #endif
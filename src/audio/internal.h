@@ -188,7 +188,7 @@ struct AudioBankSample {
     struct AdpcmLoop *loop;
     struct AdpcmBook *book;
 #ifndef VERSION_SH
-    u32 sampleSize; // never read. either 0 or 1 mod 9, depending on padding
+    u32 sampleSize; // either 0 or 1 mod 9, depending on padding
 #endif
 };
 
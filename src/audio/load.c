@@ -11,15 +11,33 @@
 
 #define ALIGN16(val) (((val) + 0xF) & ~0xF)
 
+#define SAMPLE_DMA_NONE 0xFF
+// Must be larger than the largest sample DMA buffer.
+#define SAMPLE_DMA_BLOCK_SIZE 0x800
+#define SAMPLE_DMA_HASH_SIZE 64
+// Audio tasks run a frame after their command list is built, so a buffer read from during the last two frames can't be refilled yet.
+#define SAMPLE_DMA_MIN_AGE 2
+// DMA queue slots that read-ahead leaves free for demand loads.
+#define SAMPLE_DMA_DEMAND_RESERVE 8
+
+enum SampleDmaPools {
+    SAMPLE_DMA_POOL_STREAM,
+    SAMPLE_DMA_POOL_START,
+    SAMPLE_DMA_POOL_COUNT,
+};
+
 struct SharedDma {
-    /*0x0*/ u8 *buffer;       // target, points to pre-allocated buffer
-    /*0x4*/ uintptr_t source; // device address
-    /*0x8*/ u16 sizeUnused;   // set to bufSize, never read
-    /*0xA*/ u16 bufSize;      // size of buffer
-    /*0xC*/ u8 unused2;       // set to 0, never read
-    /*0xD*/ u8 reuseIndex;    // position in sSampleDmaReuseQueue1/2, if ttl == 0
-    /*0xE*/ u8 ttl;           // duration after which the DMA can be discarded
-};                            // size = 0x10
+    /*0x00*/ u8 *buffer;       // target, points to pre-allocated buffer
+    /*0x04*/ uintptr_t source; // device address
+    /*0x08*/ u16 bufSize;      // size of buffer
+    /*0x0A*/ u16 lastUsed;     // value of sSampleDmaFrame when the buffer was last read from
+    /*0x0C*/ u8 pool;          // SampleDmaPools
+    /*0x0D*/ u8 bucket;        // hash bucket the buffer is linked into, or SAMPLE_DMA_NONE if it holds no data
+    /*0x0E*/ u8 hashNext;      // next buffer in the same hash bucket
+    /*0x0F*/ u8 lruPrev;       // more recently used buffer in the same pool
+    /*0x10*/ u8 lruNext;       // less recently used buffer in the same pool
+    /*0x11*/ u8 prefetched;    // read ahead and not read from yet
+};                             // size = 0x14
 
 // EU only
 void port_eu_init(void);
@@ -46,15 +64,17 @@ OSIoMesg gAudioDmaIoMesg;
 
 struct SharedDma sSampleDmas[0x60];
 u32 gSampleDmaNumListItems; // sh: 0x803503D4
-u32 sSampleDmaListSize1; // sh: 0x803503D8
 
-// Circular buffer of DMAs with ttl = 0. tail <= head, wrapping around mod 256.
-u8 sSampleDmaReuseQueue1[256];
-u8 sSampleDmaReuseQueue2[256];
-u8 sSampleDmaReuseQueueTail1;
-u8 sSampleDmaReuseQueueTail2;
-u8 sSampleDmaReuseQueueHead1; // sh: 0x803505E2
-u8 sSampleDmaReuseQueueHead2; // sh: 0x803505E3
+// Buffers are hashed by the SAMPLE_DMA_BLOCK_SIZE block their source lies in. Buffers are smaller than a block,
+// so a range can only be held by a buffer from its own block or the one before it.
+u8 sSampleDmaHash[SAMPLE_DMA_HASH_SIZE];
+
+// Most and least recently used buffer of each pool.
+u8 sSampleDmaLruHead[SAMPLE_DMA_POOL_COUNT];
+u8 sSampleDmaLruTail[SAMPLE_DMA_POOL_COUNT];
+
+u16 sSampleDmaFrame;
+struct SampleDmaStats gSampleDmaStats;
 
 // bss correct up to here
 
@@ -156,131 +176,213 @@ void audio_dma_partial_copy_async(uintptr_t *devAddr, u8 **vAddr, ssize_t *remai
     *vAddr += transfer;
 }
 
-void decrease_sample_dma_ttls() {
-    u32 i;
+static void sample_dma_lru_unlink(struct SharedDma *dma) {
+    if (dma->lruPrev != SAMPLE_DMA_NONE) {
+        sSampleDmas[dma->lruPrev].lruNext = dma->lruNext;
+    } else {
+        sSampleDmaLruHead[dma->pool] = dma->lruNext;
+    }
+    if (dma->lruNext != SAMPLE_DMA_NONE) {
+        sSampleDmas[dma->lruNext].lruPrev = dma->lruPrev;
+    } else {
+        sSampleDmaLruTail[dma->pool] = dma->lruPrev;
+    }
+}
 
-    for (i = 0; i < sSampleDmaListSize1; i++) {
-#if defined(VERSION_EU)
-        struct SharedDma *temp = &sSampleDmas[i];
-#else
-        struct SharedDma *temp = sSampleDmas + i;
-#endif
-        if (temp->ttl != 0) {
-            temp->ttl--;
-            if (temp->ttl == 0) {
-                temp->reuseIndex = sSampleDmaReuseQueueHead1;
-                sSampleDmaReuseQueue1[sSampleDmaReuseQueueHead1++] = (u8) i;
-            }
-        }
+static void sample_dma_lru_push(u32 index) {
+    struct SharedDma *dma = &sSampleDmas[index];
+    u8 head = sSampleDmaLruHead[dma->pool];
+
+    dma->lruPrev = SAMPLE_DMA_NONE;
+    dma->lruNext = head;
+    if (head != SAMPLE_DMA_NONE) {
+        sSampleDmas[head].lruPrev = index;
+    } else {
+        sSampleDmaLruTail[dma->pool] = index;
     }
+    sSampleDmaLruHead[dma->pool] = index;
+}
 
-    for (i = sSampleDmaListSize1; i < gSampleDmaNumListItems; i++) {
-#if defined(VERSION_EU)
-        struct SharedDma *temp = &sSampleDmas[i];
-#else
-        struct SharedDma *temp = sSampleDmas + i;
-#endif
-        if (temp->ttl != 0) {
-            temp->ttl--;
-            if (temp->ttl == 0) {
-                temp->reuseIndex = sSampleDmaReuseQueueHead2;
-                sSampleDmaReuseQueue2[sSampleDmaReuseQueueHead2++] = (u8) i;
-            }
-        }
+/**
+ * Marks a buffer as read from this frame and moves it to the front of its pool.
+ */
+static void sample_dma_touch(u32 index) {
+    struct SharedDma *dma = &sSampleDmas[index];
+
+    dma->lastUsed = sSampleDmaFrame;
+    if (dma->prefetched) {
+        dma->prefetched = FALSE;
+        gSampleDmaStats.prefetchHits++;
+    }
+    if (sSampleDmaLruHead[dma->pool] != index) {
+        sample_dma_lru_unlink(dma);
+        sample_dma_lru_push(index);
     }
 }
 
-void *dma_sample_data(uintptr_t devAddr, u32 size, s32 arg2, u8 *dmaIndexRef) {
-    s32 hasDma = FALSE;
-    struct SharedDma *dma;
-    uintptr_t dmaDevAddr;
-    u32 transfer;
+static void sample_dma_hash_remove(u32 index) {
+    struct SharedDma *dma = &sSampleDmas[index];
+    u8 *link = &sSampleDmaHash[dma->bucket];
+
+    while (*link != index) {
+        link = &sSampleDmas[*link].hashNext;
+    }
+    *link = dma->hashNext;
+    dma->bucket = SAMPLE_DMA_NONE;
+}
+
+static s32 sample_dma_contains(struct SharedDma *dma, uintptr_t devAddr, u32 size) {
+    ssize_t bufferPos = devAddr - dma->source;
+    return (dma->bucket != SAMPLE_DMA_NONE && 0 <= bufferPos && (size_t) bufferPos <= dma->bufSize - size);
+}
+
+/**
+ * Returns the index of a buffer holding [devAddr, devAddr + size), or SAMPLE_DMA_NONE.
+ */
+static u32 sample_dma_lookup(uintptr_t devAddr, u32 size) {
+    u32 block = devAddr / SAMPLE_DMA_BLOCK_SIZE;
     u32 i;
-    u32 dmaIndex;
-    ssize_t bufferPos;
-
-    if (arg2 != 0 || *dmaIndexRef >= sSampleDmaListSize1) {
-        for (i = sSampleDmaListSize1; i < gSampleDmaNumListItems; i++) {
-            dma = &sSampleDmas[i];
-            bufferPos = devAddr - dma->source;
-            if (0 <= bufferPos && (size_t) bufferPos <= dma->bufSize - size) {
-                // We already have a DMA request for this memory range.
-                if (dma->ttl == 0 && sSampleDmaReuseQueueTail2 != sSampleDmaReuseQueueHead2) {
-                    // Move the DMA out of the reuse queue, by swapping it with the
-                    // tail, and then incrementing the tail.
-                    if (dma->reuseIndex != sSampleDmaReuseQueueTail2) {
-                        sSampleDmaReuseQueue2[dma->reuseIndex] =
-                            sSampleDmaReuseQueue2[sSampleDmaReuseQueueTail2];
-                        sSampleDmas[sSampleDmaReuseQueue2[sSampleDmaReuseQueueTail2]].reuseIndex =
-                            dma->reuseIndex;
-                    }
-                    sSampleDmaReuseQueueTail2++;
-                }
-                dma->ttl = 60;
-                *dmaIndexRef = (u8) i;
-                return (devAddr - dma->source) + dma->buffer;
-            }
-        }
+    u8 index;
 
-        if (sSampleDmaReuseQueueTail2 != sSampleDmaReuseQueueHead2 && arg2 != 0) {
-            // Allocate a DMA from reuse queue 2. This queue can be empty, since
-            // TTL 60 is pretty large.
-            dmaIndex = sSampleDmaReuseQueue2[sSampleDmaReuseQueueTail2];
-            sSampleDmaReuseQueueTail2++;
-            dma = sSampleDmas + dmaIndex;
-            hasDma = TRUE;
-        }
-    } else {
-        dma = sSampleDmas + *dmaIndexRef;
-        bufferPos = devAddr - dma->source;
-        if (0 <= bufferPos && (size_t) bufferPos <= dma->bufSize - size) {
-            // We already have DMA for this memory range.
-            if (dma->ttl == 0) {
-                // Move the DMA out of the reuse queue, by swapping it with the
-                // tail, and then incrementing the tail.
-                if (dma->reuseIndex != sSampleDmaReuseQueueTail1) {
-                    sSampleDmaReuseQueue1[dma->reuseIndex] =
-                        sSampleDmaReuseQueue1[sSampleDmaReuseQueueTail1];
-                    sSampleDmas[sSampleDmaReuseQueue1[sSampleDmaReuseQueueTail1]].reuseIndex =
-                        dma->reuseIndex;
-                }
-                sSampleDmaReuseQueueTail1++;
+    for (i = 0; i < 2; i++) {
+        for (index = sSampleDmaHash[(block - i) % SAMPLE_DMA_HASH_SIZE]; index != SAMPLE_DMA_NONE; index = sSampleDmas[index].hashNext) {
+            if (sample_dma_contains(&sSampleDmas[index], devAddr, size)) {
+                return index;
             }
-            dma->ttl = 2;
-            return dma->buffer + (devAddr - dma->source);
         }
     }
+    return SAMPLE_DMA_NONE;
+}
 
-    if (!hasDma) {
-        // Allocate a DMA from reuse queue 1. This queue will hopefully never
-        // be empty, since TTL 2 is so small.
-        dmaIndex = sSampleDmaReuseQueue1[sSampleDmaReuseQueueTail1++];
-        dma = sSampleDmas + dmaIndex;
-        hasDma = TRUE;
+/**
+ * Returns the least recently used buffer of a pool, unless an audio task that hasn't run yet may still read from it.
+ */
+static u32 sample_dma_find_victim(s32 pool) {
+    u8 index = sSampleDmaLruTail[pool];
+
+    if (index == SAMPLE_DMA_NONE || (u16)(sSampleDmaFrame - sSampleDmas[index].lastUsed) < SAMPLE_DMA_MIN_AGE) {
+        return SAMPLE_DMA_NONE;
     }
+    return index;
+}
+
+static void sample_dma_fill(u32 index, uintptr_t devAddr) {
+    struct SharedDma *dma = &sSampleDmas[index];
+    u32 block;
+
+    if (dma->bucket != SAMPLE_DMA_NONE) {
+        sample_dma_hash_remove(index);
+        gSampleDmaStats.evictions++;
+    }
+
+    dma->source = devAddr & ~0xF;
+    block = (dma->source / SAMPLE_DMA_BLOCK_SIZE) % SAMPLE_DMA_HASH_SIZE;
+    dma->bucket = block;
+    dma->hashNext = sSampleDmaHash[block];
+    sSampleDmaHash[block] = index;
 
-    transfer = dma->bufSize;
-    dmaDevAddr = devAddr & ~0xF;
-    dma->ttl = 2;
-    dma->source = dmaDevAddr;
-    dma->sizeUnused = transfer;
 #ifdef VERSION_US // TODO: Is there a reason this only exists in US?
-    osInvalDCache(dma->buffer, transfer);
+    osInvalDCache(dma->buffer, dma->bufSize);
 #endif
     osPiStartDma(&gCurrAudioFrameDmaIoMesgBufs[gCurrAudioFrameDmaCount++], OS_MESG_PRI_NORMAL,
-                     OS_READ, dmaDevAddr, dma->buffer, transfer, &gCurrAudioFrameDmaQueue);
-    *dmaIndexRef = dmaIndex;
-    return (devAddr - dmaDevAddr) + dma->buffer;
+                     OS_READ, dma->source, dma->buffer, dma->bufSize, &gCurrAudioFrameDmaQueue);
+}
+
+/**
+ * Called once per audio frame. Buffers become reusable SAMPLE_DMA_MIN_AGE frames after they were last read from.
+ */
+void decrease_sample_dma_ttls() {
+    sSampleDmaFrame++;
 }
 
+/**
+ * Returns a pointer to [devAddr, devAddr + size) of a sample, DMAing it in if no buffer holds it yet.
+ * arg2 is set when a note (re)starts a sample. Those are kept in a separate pool, since short sound effects keep
+ * restarting from the same address. Once a note nears the end of its buffer, the next part of the sample up to
+ * sampleEnd is read ahead into another buffer, so streaming samples don't wait on a miss every few frames.
+ * Returns NULL if there are no sample buffers at all.
+ */
+void *dma_sample_data(uintptr_t devAddr, u32 size, s32 arg2, u8 *dmaIndexRef, uintptr_t sampleEnd) {
+    struct SharedDma *dma;
+    uintptr_t nextAddr;
+    u32 index = *dmaIndexRef;
+    u32 ahead;
+
+    // Notes usually keep reading from the buffer they used last time.
+    if (index >= gSampleDmaNumListItems || !sample_dma_contains(&sSampleDmas[index], devAddr, size)) {
+        index = sample_dma_lookup(devAddr, size);
+    }
+
+    if (index != SAMPLE_DMA_NONE) {
+        gSampleDmaStats.hits++;
+    } else {
+        gSampleDmaStats.misses++;
+        if (arg2 != 0) {
+            index = sample_dma_find_victim(SAMPLE_DMA_POOL_START);
+        }
+        if (index == SAMPLE_DMA_NONE) {
+            index = sample_dma_find_victim(SAMPLE_DMA_POOL_STREAM);
+        }
+        if (index == SAMPLE_DMA_NONE) {
+            // Every buffer is in use. This overwrites data a pending audio task still reads, but it's the best we can do.
+            gSampleDmaStats.overflows++;
+            index = sSampleDmaLruTail[SAMPLE_DMA_POOL_STREAM];
+            if (index == SAMPLE_DMA_NONE) {
+                index = sSampleDmaLruTail[SAMPLE_DMA_POOL_START];
+            }
+            if (index == SAMPLE_DMA_NONE) {
+                // Neither pool got any buffers, so there is nowhere to read the sample to.
+                return NULL;
+            }
+        }
+        sample_dma_fill(index, devAddr);
+    }
+
+    sample_dma_touch(index);
+    dma = &sSampleDmas[index];
+    *dmaIndexRef = index;
+
+    // The next request starts at the last frame of this one at the earliest.
+    nextAddr = devAddr + size - 9;
+    if (dma->source + dma->bufSize - (devAddr + size) < size
+     && nextAddr < sampleEnd
+     && gCurrAudioFrameDmaCount < AUDIO_FRAME_DMA_QUEUE_SIZE - SAMPLE_DMA_DEMAND_RESERVE
+     && sample_dma_lookup(nextAddr, size) == SAMPLE_DMA_NONE) {
+        ahead = sample_dma_find_victim(SAMPLE_DMA_POOL_STREAM);
+        if (ahead != SAMPLE_DMA_NONE) {
+            sample_dma_fill(ahead, nextAddr);
+            sample_dma_touch(ahead);
+            sSampleDmas[ahead].prefetched = TRUE;
+            gSampleDmaStats.prefetches++;
+        }
+    }
+
+    return (devAddr - dma->source) + dma->buffer;
+}
+
+static void init_sample_dma_buffer(s32 pool) {
+    struct SharedDma *dma = &sSampleDmas[gSampleDmaNumListItems];
+
+    dma->bufSize = sDmaBufSize;
+    dma->source = 0;
+    dma->lastUsed = sSampleDmaFrame - SAMPLE_DMA_MIN_AGE;
+    dma->pool = pool;
+    dma->bucket = SAMPLE_DMA_NONE;
+    dma->prefetched = FALSE;
+    sample_dma_lru_push(gSampleDmaNumListItems);
+    gSampleDmaNumListItems++;
+}
 
 void init_sample_dma_buffers(UNUSED s32 arg0) {
     s32 i;
-#if defined(VERSION_EU)
-#define j i
-#else
-    s32 j;
-#endif
+
+    for (i = 0; i < SAMPLE_DMA_HASH_SIZE; i++) {
+        sSampleDmaHash[i] = SAMPLE_DMA_NONE;
+    }
+    for (i = 0; i < SAMPLE_DMA_POOL_COUNT; i++) {
+        sSampleDmaLruHead[i] = SAMPLE_DMA_NONE;
+        sSampleDmaLruTail[i] = SAMPLE_DMA_NONE;
+    }
 
 #if defined(VERSION_EU)
     sDmaBufSize = 0x400;
@@ -293,37 +395,15 @@ void init_sample_dma_buffers(UNUSED s32 arg0) {
 #else
     for (i = 0; i < gMaxSimultaneousNotes * 3; i++) {
 #endif
+        if ((s32) gSampleDmaNumListItems >= ARRAY_COUNT(sSampleDmas)) {
+            break;
+        }
         sSampleDmas[gSampleDmaNumListItems].buffer = soundAlloc(&gNotesAndBuffersPool, sDmaBufSize);
         if (sSampleDmas[gSampleDmaNumListItems].buffer == NULL) {
-#if defined(VERSION_EU)
             break;
-#else
-            goto out1;
-#endif
         }
-        sSampleDmas[gSampleDmaNumListItems].bufSize = sDmaBufSize;
-        sSampleDmas[gSampleDmaNumListItems].source = 0;
-        sSampleDmas[gSampleDmaNumListItems].sizeUnused = 0;
-        sSampleDmas[gSampleDmaNumListItems].unused2 = 0;
-        sSampleDmas[gSampleDmaNumListItems].ttl = 0;
-        gSampleDmaNumListItems++;
+        init_sample_dma_buffer(SAMPLE_DMA_POOL_STREAM);
     }
-#if defined(VERSION_JP) || defined(VERSION_US)
-out1:
-#endif
-
-    for (i = 0; (u32) i < gSampleDmaNumListItems; i++) {
-        sSampleDmaReuseQueue1[i] = (u8) i;
-        sSampleDmas[i].reuseIndex = (u8) i;
-    }
-
-    for (j = gSampleDmaNumListItems; j < 0x100; j++) {
-        sSampleDmaReuseQueue1[j] = 0;
-    }
-
-    sSampleDmaReuseQueueTail1 = 0;
-    sSampleDmaReuseQueueHead1 = (u8) gSampleDmaNumListItems;
-    sSampleDmaListSize1 = gSampleDmaNumListItems;
 
 #if defined(VERSION_EU)
     sDmaBufSize = 0x200;
@@ -331,41 +411,15 @@ out1:
     sDmaBufSize = 160 * 9;
 #endif
     for (i = 0; i < gMaxSimultaneousNotes; i++) {
+        if ((s32) gSampleDmaNumListItems >= ARRAY_COUNT(sSampleDmas)) {
+            break;
+        }
         sSampleDmas[gSampleDmaNumListItems].buffer = soundAlloc(&gNotesAndBuffersPool, sDmaBufSize);
         if (sSampleDmas[gSampleDmaNumListItems].buffer == NULL) {
-#if defined(VERSION_EU)
             break;
-#else
-            goto out2;
-#endif
         }
-        sSampleDmas[gSampleDmaNumListItems].bufSize = sDmaBufSize;
-        sSampleDmas[gSampleDmaNumListItems].source = 0;
-        sSampleDmas[gSampleDmaNumListItems].sizeUnused = 0;
-        sSampleDmas[gSampleDmaNumListItems].unused2 = 0;
-        sSampleDmas[gSampleDmaNumListItems].ttl = 0;
-        gSampleDmaNumListItems++;
+        init_sample_dma_buffer(SAMPLE_DMA_POOL_START);
     }
-#if defined(VERSION_JP) || defined(VERSION_US)
-out2:
-#endif
-
-    for (i = sSampleDmaListSize1; (u32) i < gSampleDmaNumListItems; i++) {
-        sSampleDmaReuseQueue2[i - sSampleDmaListSize1] = (u8) i;
-        sSampleDmas[i].reuseIndex = (u8)(i - sSampleDmaListSize1);
-    }
-
-    // This probably meant to touch the range size1..size2 as well... but it
-    // doesn't matter, since these values are never read anyway.
-    for (j = gSampleDmaNumListItems; j < 0x100; j++) {
-        sSampleDmaReuseQueue2[j] = sSampleDmaListSize1;
-    }
-
-    sSampleDmaReuseQueueTail2 = 0;
-    sSampleDmaReuseQueueHead2 = gSampleDmaNumListItems - sSampleDmaListSize1;
-#if defined(VERSION_EU)
-#undef j
-#endif
 }
 
 #if defined(VERSION_JP) || defined(VERSION_US)
@@ -7,6 +7,17 @@
 
 #define AUDIO_FRAME_DMA_QUEUE_SIZE 0x40
 
+#ifndef VERSION_SH
+struct SampleDmaStats {
+    u32 hits;
+    u32 misses;
+    u32 prefetches;
+    u32 prefetchHits;
+    u32 evictions;
+    u32 overflows; // misses with every buffer still in use
+};
+#endif
+
 enum Preloads {
     PRELOAD_NONE,
     PRELOAD_SEQUENCE,
@@ -34,6 +45,9 @@ extern struct NotePool gNoteFreeLists;
 
 extern OSMesgQueue gCurrAudioFrameDmaQueue;
 extern u32 gSampleDmaNumListItems;
+#ifndef VERSION_SH
+extern struct SampleDmaStats gSampleDmaStats;
+#endif
 extern ALSeqFile *gAlCtlHeader;
 extern ALSeqFile *gAlTbl;
 extern ALSeqFile *gSeqFileHeader;
@@ -85,7 +99,7 @@ void decrease_sample_dma_ttls(void);
 #ifdef VERSION_SH
 void *dma_sample_data(uintptr_t devAddr, u32 size, s32 arg2, u8 *dmaIndexRef, s32 medium);
 #else
-void *dma_sample_data(uintptr_t devAddr, u32 size, s32 arg2, u8 *dmaIndexRef);
+void *dma_sample_data(uintptr_t devAddr, u32 size, s32 arg2, u8 *dmaIndexRef, uintptr_t sampleEnd);
 #endif
 void init_sample_dma_buffers(s32 arg0);
 #if defined(VERSION_SH)
@@ -334,6 +334,86 @@ void note_disable2(struct Note *note) {
 }
 #endif // VERSION_EU || VERSION_SH
 
+#if defined(AUDIO_NOTE_COST_BUDGET) && (defined(VERSION_JP) || defined(VERSION_US))
+struct NoteBudgetStats gNoteBudgetStats;
+
+/**
+ * Rough synthesis cost of a note for one audio update. Envelope, mixing and resampling cost about the same for every
+ * note, while ADPCM decoding scales with how many input samples are consumed per output sample.
+ */
+static s32 note_get_cost(struct Note *note) {
+    s32 cost = NOTE_COST_BASE;
+
+    if (note->sound != NULL) {
+        cost += (s32)(note->frequency * NOTE_COST_ADPCM);
+    }
+    if (note->reverbVol != 0) {
+        cost += NOTE_COST_REVERB;
+    }
+    if (note->usesHeadsetPanEffects) {
+        cost += NOTE_COST_HEADSET;
+    }
+    return cost;
+}
+
+/**
+ * Notes being released fade out within a frame, so they neither count towards the budget nor get stolen.
+ */
+static s32 note_is_fading_out(struct Note *note) {
+    return (note->adsr.state == ADSR_STATE_RELEASE || (note->adsr.action & ADSR_ACTION_RELEASE));
+}
+
+/**
+ * Keeps the estimated cost of all playing notes under AUDIO_NOTE_COST_BUDGET by releasing the lowest priority notes,
+ * quietest first. Stolen notes fade out like notes that lost their layer to a higher priority one.
+ */
+static void enforce_note_cost_budget(void) {
+    struct Note *note;
+    struct Note *victim;
+    s32 totalCost = 0;
+    s32 i;
+
+    for (i = 0; i < gMaxSimultaneousNotes; i++) {
+        note = &gNotes[i];
+        if (note->enabled && note->priority != NOTE_PRIORITY_DISABLED && !note_is_fading_out(note)) {
+            totalCost += note_get_cost(note);
+        }
+    }
+
+    gNoteBudgetStats.cost = totalCost;
+    if (totalCost > gNoteBudgetStats.peakCost) {
+        gNoteBudgetStats.peakCost = totalCost;
+    }
+
+    while (totalCost > AUDIO_NOTE_COST_BUDGET) {
+        victim = NULL;
+        for (i = 0; i < gMaxSimultaneousNotes; i++) {
+            note = &gNotes[i];
+            if (!note->enabled || note->priority == NOTE_PRIORITY_DISABLED || note_is_fading_out(note)) {
+                continue;
+            }
+            if (victim == NULL || note->priority < victim->priority
+             || (note->priority == victim->priority
+              && note->targetVolLeft + note->targetVolRight < victim->targetVolLeft + victim->targetVolRight)) {
+                victim = note;
+            }
+        }
+        if (victim == NULL) {
+            break;
+        }
+
+        totalCost -= note_get_cost(victim);
+        if (victim->parentLayer != NO_LAYER) {
+            seq_channel_layer_note_release(victim->parentLayer);
+        } else {
+            victim->adsr.fadeOutVel = 0x8000 / gAudioUpdatesPerFrame;
+            victim->adsr.action |= ADSR_ACTION_RELEASE;
+        }
+        gNoteBudgetStats.steals++;
+    }
+}
+#endif
+
 void process_notes(void) {
     f32 scale;
 #ifndef VERSION_SH
@@ -610,6 +690,10 @@ void process_notes(void) {
     }
 #undef PREPEND
 #undef POP
+
+#if defined(AUDIO_NOTE_COST_BUDGET) && (defined(VERSION_JP) || defined(VERSION_US))
+    enforce_note_cost_budget();
+#endif
 }
 
 #if defined(VERSION_SH)
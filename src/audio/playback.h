@@ -18,6 +18,22 @@ enum NoteAlloc {
     NOTE_ALLOC_GLOBAL_FREELIST = (1 << 3), // 0x8
 };
 
+#if defined(AUDIO_NOTE_COST_BUDGET) && (defined(VERSION_JP) || defined(VERSION_US))
+// Estimated per-update cost of a note, see note_get_cost. A plain ADPCM note played at its recorded pitch costs 8.
+#define NOTE_COST_BASE    4
+#define NOTE_COST_ADPCM   4 // times the resampling ratio
+#define NOTE_COST_REVERB  2
+#define NOTE_COST_HEADSET 2
+
+struct NoteBudgetStats {
+    u16 cost;     // estimated cost of the last audio update
+    u16 peakCost; // highest estimated cost before stealing
+    u32 steals;   // notes released to stay under AUDIO_NOTE_COST_BUDGET
+};
+
+extern struct NoteBudgetStats gNoteBudgetStats;
+#endif
+
 void process_notes(void);
 void seq_channel_layer_note_decay(struct SequenceChannelLayer *seqLayer);
 void seq_channel_layer_note_release(struct SequenceChannelLayer *seqLayer);
@@ -0,0 +1,247 @@
+/**
+ * Allocation tracing for every RAM allocator: the main pool, allocation-only pools, memory pools,
+ * the audio heap's pools and the display list pool.
+ *
+ * Each allocator reports its allocations and frees here, with how much of the pool is in use
+ * afterwards. That is kept per pool (live bytes, peak, failures) and per call site, and the most
+ * recent allocations are kept in a ring. All of it can be read after a crash on the crash screen,
+ * where the call sites are symbolized.
+ *
+ * This lives in the main segment since the main pool is in use before the engine is loaded.
+ * The audio thread allocates too, so every update is done with interrupts disabled.
+ */
+
+#include <ultra64.h>
+#include <PR/os_internal_reg.h>
+
+#include "config.h"
+#include "alloc_trace.h"
+#include "game/main.h"
+
+#ifdef ALLOC_TRACE
+
+const char *gAllocTraceKindNames[ALLOC_TRACE_KIND_COUNT] = {
+    "MAIN", "ONLY", "MEM", "SND", "GFX",
+};
+
+struct AllocTracePool gAllocTracePools[ALLOC_TRACE_NUM_POOLS];
+struct AllocTraceSite gAllocTraceSites[ALLOC_TRACE_NUM_SITES];
+struct AllocTraceEntry gAllocTraceRecent[ALLOC_TRACE_NUM_RECENT];
+u32 gAllocTraceNumRecent = 0;
+
+/**
+ * Returns the slot of a pool, claiming a free one the first time the pool is seen.
+ * Returns -1 if every slot is taken.
+ */
+static s32 alloc_trace_find_pool(void *pool, s32 create) {
+    s32 freeSlot = -1;
+    s32 i;
+
+    // Released slots leave holes, so every slot has to be checked.
+    for (i = 0; i < ALLOC_TRACE_NUM_POOLS; i++) {
+        if (gAllocTracePools[i].pool == pool) {
+            return i;
+        }
+        if (gAllocTracePools[i].pool == NULL && freeSlot < 0) {
+            freeSlot = i;
+        }
+    }
+
+    if (!create || freeSlot < 0) {
+        return -1;
+    }
+    gAllocTracePools[freeSlot].pool = pool;
+    return freeSlot;
+}
+
+/**
+ * Returns the slot of a call site, claiming a free one the first time it is seen.
+ * Returns NULL if the table is full.
+ */
+static struct AllocTraceSite *alloc_trace_find_site(u32 caller) {
+    u32 slot = ((caller * 2654435761U) >> (32 - ALLOC_TRACE_SITE_BITS));
+    s32 i;
+
+    // Linear probing.
+    for (i = 0; i < ALLOC_TRACE_NUM_SITES; i++) {
+        struct AllocTraceSite *site = &gAllocTraceSites[slot];
+
+        if (site->caller == caller) {
+            return site;
+        }
+        if (site->caller == 0) {
+            site->caller = caller;
+            return site;
+        }
+        slot = ((slot + 1) & (ALLOC_TRACE_NUM_SITES - 1));
+    }
+
+    return NULL;
+}
+
+/**
+ * Records an allocation of size bytes from pool, which returned addr (NULL if it failed) and left
+ * used of the pool's total bytes in use.
+ *
+ * Display lists and the display list heap's nodes are allocated many times a frame and their pools
+ * are emptied every frame, so only their usage and failures are recorded; the rest would flush the
+ * ring of recent allocations and the call site table.
+ */
+void alloc_trace_alloc(enum AllocTraceKind kind, void *pool, u32 size, void *addr, u32 used, u32 total, void *caller) {
+    u32 saved = __osDisableInt();
+    s32 poolIndex = alloc_trace_find_pool(pool, TRUE);
+
+    if (poolIndex >= 0) {
+        struct AllocTracePool *tracePool = &gAllocTracePools[poolIndex];
+
+        tracePool->kind = kind;
+        tracePool->total = total;
+        tracePool->used = used;
+        tracePool->allocs++;
+        if (used > tracePool->peak) {
+            tracePool->peak = used;
+        }
+        if (addr == NULL) {
+            tracePool->failures++;
+        }
+    }
+
+    if (kind != ALLOC_TRACE_DISPLAY_LIST || addr == NULL) {
+        struct AllocTraceSite *site = alloc_trace_find_site((u32) caller);
+        struct AllocTraceEntry *entry = &gAllocTraceRecent[gAllocTraceNumRecent & (ALLOC_TRACE_NUM_RECENT - 1)];
+
+        if (site != NULL) {
+            site->kind = kind;
+            site->allocs++;
+            if (addr == NULL) {
+                site->failures++;
+            } else {
+                site->bytes += size;
+            }
+        }
+
+        entry->caller = (u32) caller;
+        entry->addr = addr;
+        entry->size = size;
+        entry->vblank = gNumVblanks;
+        entry->kind = kind;
+        gAllocTraceNumRecent++;
+    }
+
+    __osRestoreInt(saved);
+}
+
+/**
+ * Records that pool has used bytes in use after a free. The main pool also reports the usage of a
+ * transient block here, so this can raise the peak.
+ */
+void alloc_trace_free(void *pool, u32 used) {
+    u32 saved = __osDisableInt();
+    s32 poolIndex = alloc_trace_find_pool(pool, FALSE);
+
+    if (poolIndex >= 0) {
+        gAllocTracePools[poolIndex].used = used;
+        if (used > gAllocTracePools[poolIndex].peak) {
+            gAllocTracePools[poolIndex].peak = used;
+        }
+    }
+
+    __osRestoreInt(saved);
+}
+
+/**
+ * Releases the slots of every pool in [start, end), whose memory has been freed or is being reused
+ * for a new pool. A level's pools are made again on every load, often at the same addresses.
+ */
+void alloc_trace_release(void *start, void *end) {
+    u32 saved = __osDisableInt();
+    s32 i;
+
+    for (i = 0; i < ALLOC_TRACE_NUM_POOLS; i++) {
+        u8 *pool = gAllocTracePools[i].pool;
+
+        if (pool != NULL && pool >= (u8 *) start && pool < (u8 *) end) {
+            bzero(&gAllocTracePools[i], sizeof(gAllocTracePools[i]));
+        }
+    }
+
+    __osRestoreInt(saved);
+}
+
+// Pools are at most a few megabytes, so this can't overflow.
+#define ALLOC_TRACE_PERCENT(used, total) (((total) != 0) ? (((used) * 100) / (total)) : 0)
+
+static s32 alloc_trace_pool_used(s32 i) {
+    return (gAllocTracePools[i].pool != NULL);
+}
+
+// Pools that failed first, then the ones that came closest to full.
+static s32 alloc_trace_pool_before(s32 a, s32 b) {
+    struct AllocTracePool *poolA = &gAllocTracePools[a];
+    struct AllocTracePool *poolB = &gAllocTracePools[b];
+
+    if (poolA->failures != poolB->failures) {
+        return (poolA->failures > poolB->failures);
+    }
+
+    return (ALLOC_TRACE_PERCENT(poolA->peak, poolA->total) > ALLOC_TRACE_PERCENT(poolB->peak, poolB->total));
+}
+
+static s32 alloc_trace_site_used(s32 i) {
+    return (gAllocTraceSites[i].caller != 0);
+}
+
+// Call sites that failed first, then the ones that allocated the most.
+static s32 alloc_trace_site_before(s32 a, s32 b) {
+    struct AllocTraceSite *siteA = &gAllocTraceSites[a];
+    struct AllocTraceSite *siteB = &gAllocTraceSites[b];
+
+    if (siteA->failures != siteB->failures) {
+        return (siteA->failures > siteB->failures);
+    }
+
+    return (siteA->bytes > siteB->bytes);
+}
+
+/**
+ * Picks the best ranked slots with a selection sort, since only a handful are shown.
+ */
+static s32 alloc_trace_top(s32 *top, s32 maxCount, s32 numSlots, s32 (*isUsed)(s32), s32 (*isBefore)(s32, s32)) {
+    s32 numTop = 0;
+    s32 i, j;
+
+    while (numTop < maxCount) {
+        s32 best = -1;
+
+        for (i = 0; i < numSlots; i++) {
+            if (!isUsed(i) || (best >= 0 && !isBefore(i, best))) {
+                continue;
+            }
+            for (j = 0; j < numTop; j++) {
+                if (top[j] == i) {
+                    break;
+                }
+            }
+            if (j == numTop) {
+                best = i;
+            }
+        }
+
+        if (best < 0) {
+            break;
+        }
+        top[numTop++] = best;
+    }
+
+    return numTop;
+}
+
+s32 alloc_trace_top_pools(s32 *top, s32 maxCount) {
+    return alloc_trace_top(top, maxCount, ALLOC_TRACE_NUM_POOLS, alloc_trace_pool_used, alloc_trace_pool_before);
+}
+
+s32 alloc_trace_top_sites(s32 *top, s32 maxCount) {
+    return alloc_trace_top(top, maxCount, ALLOC_TRACE_NUM_SITES, alloc_trace_site_used, alloc_trace_site_before);
+}
+
+#endif
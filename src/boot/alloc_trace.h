@@ -0,0 +1,77 @@
+#ifndef ALLOC_TRACE_H
+#define ALLOC_TRACE_H
+
+#include <PR/ultratypes.h>
+
+#include "config.h"
+
+enum AllocTraceKind {
+    ALLOC_TRACE_MAIN,
+    ALLOC_TRACE_ALLOC_ONLY,
+    ALLOC_TRACE_MEM_POOL,
+    ALLOC_TRACE_SOUND,
+    ALLOC_TRACE_DISPLAY_LIST,
+    ALLOC_TRACE_KIND_COUNT
+};
+
+#ifdef ALLOC_TRACE
+
+#define ALLOC_TRACE_NUM_POOLS    32
+#define ALLOC_TRACE_SITE_BITS     7
+#define ALLOC_TRACE_NUM_SITES    (1 << ALLOC_TRACE_SITE_BITS)
+#define ALLOC_TRACE_NUM_RECENT   64 // Must be a power of two
+
+struct AllocTracePool {
+    void *pool; // NULL for an unused slot
+    u8 kind;
+    u32 total;
+    u32 used; // As of the pool's last allocation or free
+    u32 peak;
+    u32 allocs;
+    u32 failures;
+};
+
+struct AllocTraceSite {
+    u32 caller; // 0 for an unused slot
+    u8 kind;
+    u32 allocs;
+    u32 bytes;
+    u32 failures;
+};
+
+struct AllocTraceEntry {
+    u32 caller;
+    void *addr; // NULL if the allocation failed
+    u32 size;
+    u16 vblank;
+    u8 kind;
+};
+
+extern const char *gAllocTraceKindNames[ALLOC_TRACE_KIND_COUNT];
+extern struct AllocTracePool gAllocTracePools[ALLOC_TRACE_NUM_POOLS];
+extern struct AllocTraceSite gAllocTraceSites[ALLOC_TRACE_NUM_SITES];
+extern struct AllocTraceEntry gAllocTraceRecent[ALLOC_TRACE_NUM_RECENT];
+extern u32 gAllocTraceNumRecent; // Entries written so far, the newest is at (gAllocTraceNumRecent - 1)
+
+void alloc_trace_alloc(enum AllocTraceKind kind, void *pool, u32 size, void *addr, u32 used, u32 total, void *caller);
+void alloc_trace_free(void *pool, u32 used);
+void alloc_trace_release(void *start, void *end);
+void main_pool_trace_transient(enum AllocTraceKind kind);
+s32 alloc_trace_top_pools(s32 *top, s32 maxCount);
+s32 alloc_trace_top_sites(s32 *top, s32 maxCount);
+
+// Must be used in the allocator itself, so the caller it records is whoever asked for the memory.
+#define ALLOC_TRACE_ALLOC(kind, pool, size, addr, used, total) \
+    alloc_trace_alloc((kind), (pool), (size), (addr), (used), (total), __builtin_return_address(0))
+#define ALLOC_TRACE_FREE(pool, used) alloc_trace_free((pool), (used))
+#define ALLOC_TRACE_RELEASE(start, end) alloc_trace_release((start), (end))
+// Marks the next main pool allocation as an allocation-only pool that takes the rest of the main pool for a while.
+#define ALLOC_TRACE_TRANSIENT(kind) main_pool_trace_transient(kind)
+#else
+#define ALLOC_TRACE_ALLOC(kind, pool, size, addr, used, total)
+#define ALLOC_TRACE_FREE(pool, used)
+#define ALLOC_TRACE_RELEASE(start, end)
+#define ALLOC_TRACE_TRANSIENT(kind)
+#endif
+
+#endif // ALLOC_TRACE_H
@@ -20,6 +20,7 @@
 #include "game/puppyprint.h"
 #include "game/puppylights.h"
 #include "game/profiling.h"
+#include "game/pc_profiler.h"
 
 // Message IDs
 enum MessageIDs {
@@ -28,6 +29,9 @@ enum MessageIDs {
     MESG_VI_VBLANK,
     MESG_START_GFX_SPTASK,
     MESG_NMI_REQUEST,
+#ifdef PC_PROFILER
+    MESG_PC_PROFILER_SAMPLE,
+#endif
 };
 
 // OSThread gUnkThread; // unused?
@@ -297,6 +301,7 @@ void handle_dp_complete(void) {
     }
     sCurrentDisplaySPTask->state = SPTASK_STATE_FINISHED_DP;
     sCurrentDisplaySPTask = NULL;
+    profiler_gfx_done();
 }
 extern void crash_screen_init(void);
 
@@ -307,6 +312,9 @@ void thread3_main(UNUSED void *arg) {
 #ifndef UNF
     crash_screen_init();
 #endif
+#ifdef PC_PROFILER
+    pc_profiler_init(&gIntrMesgQueue, (OSMesg) MESG_PC_PROFILER_SAMPLE);
+#endif
 
 #ifdef UNF
     debug_initialize();
@@ -346,6 +354,11 @@ void thread3_main(UNUSED void *arg) {
             case MESG_NMI_REQUEST:
                 handle_nmi_request();
                 break;
+#ifdef PC_PROFILER
+            case MESG_PC_PROFILER_SAMPLE:
+                pc_profiler_sample();
+                break;
+#endif
         }
     }
 }
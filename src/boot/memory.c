@@ -3,6 +3,7 @@
 #include "sm64.h"
 
 #include "buffers/buffers.h"
+#include "alloc_trace.h"
 #include "slidec.h"
 #include "game/game_init.h"
 #include "game/main.h"
@@ -27,6 +28,11 @@
 #define ALIGN8(val) (((val) + 0x7) & ~0x7)
 #define ALIGN16(val) (((val) + 0xF) & ~0xF)
 
+// The main pool is traced under the address of sPoolFreeSpace, since its first block starts at sPoolStart.
+#define MAIN_POOL_TRACE_ID ((void *) &sPoolFreeSpace)
+// A transient block isn't counted until it's freed, when what it actually used is known.
+#define MAIN_POOL_USED() (((u32) (sPoolEnd - sPoolStart) - sPoolFreeSpace) - sPoolTransientSize)
+
 struct MainPoolState {
     u32 freeSpace;
     struct MainPoolBlock *listHeadL;
@@ -48,6 +54,9 @@ struct MemoryPool {
     u32 totalSpace;
     struct MemoryBlock *firstBlock;
     struct MemoryBlock freeList;
+#ifdef ALLOC_TRACE
+    u32 usedSpace;
+#endif
 };
 
 extern uintptr_t sSegmentTable[32];
@@ -75,6 +84,26 @@ struct MainPoolBlock *sPoolListHeadR;
 
 static struct MainPoolState *gMainPoolState = NULL;
 
+#ifdef ALLOC_TRACE
+/**
+ * The level pool and the display list heap take the rest of the main pool for a while, and would
+ * otherwise show it as full. The next allocation after main_pool_trace_transient is such a block.
+ */
+static u8 sPoolNextTransient = FALSE;
+static u8 sPoolTransientKind;
+static void *sPoolTransientBlock = NULL;
+static u32 sPoolTransientSize = 0;
+
+/**
+ * Marks the next main pool allocation as an allocation-only pool that is only held until it is
+ * freed or resized. Its allocations are traced as kind.
+ */
+void main_pool_trace_transient(enum AllocTraceKind kind) {
+    sPoolNextTransient = TRUE;
+    sPoolTransientKind = kind;
+}
+#endif
+
 uintptr_t set_segment_base_addr(s32 segment, void *addr) {
     sSegmentTable[segment] = ((uintptr_t) addr & 0x1FFFFFFF);
     return sSegmentTable[segment];
@@ -167,6 +196,14 @@ void *main_pool_alloc(u32 size, u32 side) {
             addr = (u8 *) sPoolListHeadR + 16;
         }
     }
+#ifdef ALLOC_TRACE
+    if (sPoolNextTransient && addr != NULL) {
+        sPoolTransientBlock = addr;
+        sPoolTransientSize = size;
+    }
+    sPoolNextTransient = FALSE;
+#endif
+    ALLOC_TRACE_ALLOC(ALLOC_TRACE_MAIN, MAIN_POOL_TRACE_ID, size, addr, MAIN_POOL_USED(), (u32) (sPoolEnd - sPoolStart));
     return addr;
 }
 
@@ -180,6 +217,20 @@ u32 main_pool_free(void *addr) {
     struct MainPoolBlock *block = (struct MainPoolBlock *) ((u8 *) addr - 16);
     struct MainPoolBlock *oldListHead = (struct MainPoolBlock *) ((u8 *) addr - 16);
 
+#ifdef ALLOC_TRACE
+    if (addr == sPoolTransientBlock) {
+        // Charge what the transient pool used, then free it like any other block.
+        ALLOC_TRACE_FREE(MAIN_POOL_TRACE_ID, MAIN_POOL_USED() + 16 + sizeof(struct AllocOnlyPool)
+                                             + ((struct AllocOnlyPool *) addr)->usedSpace);
+        sPoolTransientBlock = NULL;
+        sPoolTransientSize = 0;
+    } else if (oldListHead < sPoolListHeadL) {
+        // Pools inside the freed blocks are gone.
+        ALLOC_TRACE_RELEASE(block, sPoolListHeadL);
+    } else {
+        ALLOC_TRACE_RELEASE(sPoolListHeadR, block->next);
+    }
+#endif
     if (oldListHead < sPoolListHeadL) {
         while (oldListHead->next != NULL) {
             oldListHead = oldListHead->next;
@@ -195,6 +246,7 @@ u32 main_pool_free(void *addr) {
         sPoolListHeadR->prev = NULL;
         sPoolFreeSpace += (uintptr_t) sPoolListHeadR - (uintptr_t) oldListHead;
     }
+    ALLOC_TRACE_FREE(MAIN_POOL_TRACE_ID, MAIN_POOL_USED());
     return sPoolFreeSpace;
 }
 
@@ -246,10 +298,20 @@ u32 main_pool_push_state(void) {
  * amount of free space left in the pool.
  */
 u32 main_pool_pop_state(void) {
+    // Pools allocated since the state was pushed are gone.
+    ALLOC_TRACE_RELEASE(gMainPoolState->listHeadL, sPoolListHeadL);
+    ALLOC_TRACE_RELEASE(sPoolListHeadR, gMainPoolState->listHeadR);
+#ifdef ALLOC_TRACE
+    if ((u8 *) sPoolTransientBlock > (u8 *) gMainPoolState->listHeadL) {
+        sPoolTransientBlock = NULL;
+        sPoolTransientSize = 0;
+    }
+#endif
     sPoolFreeSpace = gMainPoolState->freeSpace;
     sPoolListHeadL = gMainPoolState->listHeadL;
     sPoolListHeadR = gMainPoolState->listHeadR;
     gMainPoolState = gMainPoolState->prev;
+    ALLOC_TRACE_FREE(MAIN_POOL_TRACE_ID, MAIN_POOL_USED());
     return sPoolFreeSpace;
 }
 
@@ -488,6 +550,12 @@ struct AllocOnlyPool *alloc_only_pool_init(u32 size, u32 side) {
         subPool->usedSpace = 0;
         subPool->startPtr = (u8 *) addr + sizeof(struct AllocOnlyPool);
         subPool->freePtr = (u8 *) addr + sizeof(struct AllocOnlyPool);
+#ifdef ALLOC_TRACE
+        // A transient pool keeps its slot and peak from one use to the next.
+        if (addr != sPoolTransientBlock) {
+            ALLOC_TRACE_RELEASE(addr, (u8 *) addr + 1);
+        }
+#endif
     }
     return subPool;
 }
@@ -505,6 +573,8 @@ void *alloc_only_pool_alloc(struct AllocOnlyPool *pool, s32 size) {
         pool->freePtr += size;
         pool->usedSpace += size;
     }
+    ALLOC_TRACE_ALLOC(((void *) pool == sPoolTransientBlock) ? sPoolTransientKind : ALLOC_TRACE_ALLOC_ONLY,
+                      pool, size, addr, pool->usedSpace, pool->totalSpace);
     return addr;
 }
 
@@ -547,6 +617,10 @@ struct MemoryPool *mem_pool_init(u32 size, u32 side) {
         block = pool->firstBlock;
         block->next = NULL;
         block->size = pool->totalSpace;
+#ifdef ALLOC_TRACE
+        pool->usedSpace = 0;
+        ALLOC_TRACE_RELEASE(addr, (u8 *) addr + 1);
+#endif
     }
     return pool;
 }
@@ -562,6 +636,10 @@ void *mem_pool_alloc(struct MemoryPool *pool, u32 size) {
     while (freeBlock->next != NULL) {
         if (freeBlock->next->size >= size) {
             addr = (u8 *) freeBlock->next + sizeof(struct MemoryBlock);
+#ifdef ALLOC_TRACE
+            // A remainder too small to split off stays with the block, and is freed with it.
+            pool->usedSpace += ((freeBlock->next->size - size <= sizeof(struct MemoryBlock)) ? freeBlock->next->size : size);
+#endif
             if (freeBlock->next->size - size <= sizeof(struct MemoryBlock)) {
                 freeBlock->next = freeBlock->next->next;
             } else {
@@ -575,6 +653,7 @@ void *mem_pool_alloc(struct MemoryPool *pool, u32 size) {
         }
         freeBlock = freeBlock->next;
     }
+    ALLOC_TRACE_ALLOC(ALLOC_TRACE_MEM_POOL, pool, size, addr, pool->usedSpace, pool->totalSpace);
     return addr;
 }
 
@@ -585,6 +664,10 @@ void mem_pool_free(struct MemoryPool *pool, void *addr) {
     struct MemoryBlock *block = (struct MemoryBlock *) ((u8 *) addr - sizeof(struct MemoryBlock));
     struct MemoryBlock *freeList = pool->freeList.next;
 
+#ifdef ALLOC_TRACE
+    pool->usedSpace -= block->size;
+    ALLOC_TRACE_FREE(pool, pool->usedSpace);
+#endif
     if (pool->freeList.next == NULL) {
         pool->freeList.next = block;
         block->next = NULL;
@@ -628,6 +711,9 @@ void *alloc_display_list(u32 size) {
         gGfxPoolEnd -= size;
         ptr = gGfxPoolEnd;
     }
+    // The display list grows up from the start of the pool and these allocations down from the end.
+    ALLOC_TRACE_ALLOC(ALLOC_TRACE_DISPLAY_LIST, gGfxPool, size, ptr,
+                      (sizeof(gGfxPool->buffer) - (gGfxPoolEnd - (u8 *) gDisplayListHead)), sizeof(gGfxPool->buffer));
     return ptr;
 }
 
@@ -19,6 +19,6 @@
  * the HVQM2 data.
  * (Note) Please locate at a 16byte aligned address with the spec file.
  */
-ALIGNED16 u8 hvqbuf[HVQ_DATASIZE_MAX];
+ALIGNED16 u8 hvqbuf[HVQM_RECORDS_AHEAD * HVQ_RECORD_BUF_SIZE];
 
 /* end */
@@ -738,6 +738,21 @@ static s32 bhv_cmd_spawn_water_droplet(void) {
     return BHV_PROC_CONTINUE;
 }
 
+// Command 0x38: Puts the object to sleep until Mario is within the given distance, then moves to the next command.
+// If the object is woken early (e.g. by an interaction), it goes back to sleep.
+// Usage: SLEEP_UNTIL_MARIO_WITHIN(dist)
+static s32 bhv_cmd_sleep_until_mario_within(void) {
+    f32 dist = BHV_CMD_GET_2ND_S16(0);
+
+    if (gMarioObject != NULL && dist_between_objects(gCurrentObject, gMarioObject) < dist) {
+        gCurBhvCommand++;
+        return BHV_PROC_CONTINUE;
+    }
+
+    cur_obj_sleep_until(dist, 0, NULL);
+    return BHV_PROC_BREAK;
+}
+
 // Command 0x34: Animates an object using texture animation. <field> is always set to oAnimState.
 // Usage: ANIMATE_TEXTURE(field, rate)
 static s32 bhv_cmd_animate_texture(void) {
@@ -811,6 +826,7 @@ static BhvCommandProc BehaviorCmdTable[] = {
     /*BHV_CMD_DISABLE_RENDERING     */ bhv_cmd_disable_rendering,
     /*BHV_CMD_SET_INT_UNUSED        */ bhv_cmd_set_int_unused,
     /*BHV_CMD_SPAWN_WATER_DROPLET   */ bhv_cmd_spawn_water_droplet,
+    /*BHV_CMD_SLEEP_UNTIL_MARIO_WITHIN */ bhv_cmd_sleep_until_mario_within,
 };
 
 // Execute the behavior script of the current object, process the object flags, and other miscellaneous code for updating objects.
@@ -192,6 +192,9 @@ struct GraphNodeCamera *init_graph_node_camera(struct AllocOnlyPool *pool,
         graphNode->config.mode = mode;
         graphNode->roll = 0;
         graphNode->rollScreen = 0;
+#ifdef UNLOCK_FPS_INTERPOLATION
+        graphNode->interp.step = INTERP_STEP_STALE;
+#endif
 
         if (func != NULL) {
             func(GEO_CONTEXT_CREATE, &graphNode->fnNode.node, pool);
@@ -718,6 +721,11 @@ void geo_obj_init(struct GraphNodeObject *graphNode, void *sharedChild, Vec3f po
     graphNode->spawnInfo = 0;
     graphNode->throwMatrix = NULL;
     graphNode->animInfo.curAnim = NULL;
+#ifdef UNLOCK_FPS_INTERPOLATION
+    // Don't slide from wherever the last object in this slot was.
+    graphNode->interp.step = INTERP_STEP_STALE;
+    graphNode->animInfo.interpStep = INTERP_STEP_STALE;
+#endif
 
     graphNode->node.flags |=  GRAPH_RENDER_ACTIVE;
     graphNode->node.flags &= ~GRAPH_RENDER_INVISIBLE;
@@ -740,6 +748,10 @@ void geo_obj_init_spawninfo(struct GraphNodeObject *graphNode, struct SpawnInfo
     graphNode->spawnInfo = spawn;
     graphNode->throwMatrix = NULL;
     graphNode->animInfo.curAnim = 0;
+#ifdef UNLOCK_FPS_INTERPOLATION
+    graphNode->interp.step = INTERP_STEP_STALE;
+    graphNode->animInfo.interpStep = INTERP_STEP_STALE;
+#endif
 
     graphNode->node.flags |= GRAPH_RENDER_ACTIVE;
     graphNode->node.flags &= ~GRAPH_RENDER_INVISIBLE;
@@ -801,6 +813,23 @@ s32 retrieve_animation_index(s32 frame, u16 **attributes) {
     return result;
 }
 
+/**
+ * Decode every channel of an animation at the given frame into dest, in the order
+ * the animated parts read them: the root translation, then a rotation for each part.
+ * A channel holds its last value past its length, so constant channels have length 1.
+ */
+void decode_animation_frame(struct Animation *anim, s32 frame, s16 *dest) {
+    const u16 *index = segmented_to_virtual((void *) anim->index);
+    const s16 *values = segmented_to_virtual((void *) anim->values);
+    s32 numChannels = (anim->numParts + 1) * 3;
+    s32 i;
+
+    for (i = 0; i < numChannels; i++) {
+        dest[i] = values[index[1] + MIN(frame, index[0] - 1)];
+        index += 2;
+    }
+}
+
 /**
  * Update the animation frame of an object. The animation flags determine
  * whether it plays forwards or backwards, and whether it stops or loops at
@@ -242,6 +242,9 @@ struct GraphNodeCamera {
     /*0x34*/ Mat4 *matrixPtr; // pointer to look-at matrix of this camera as a Mat4
     /*0x38*/ s16 roll; // roll in look at matrix. Doesn't account for light direction unlike rollScreen.
     /*0x3A*/ s16 rollScreen; // rolls screen while keeping the light direction consistent
+#ifdef UNLOCK_FPS_INTERPOLATION
+    struct CameraInterp interp;
+#endif
 };
 
 /** GraphNode that translates and rotates its children.
@@ -446,6 +449,7 @@ void geo_obj_init_animation(struct GraphNodeObject *graphNode, struct Animation
 void geo_obj_init_animation_accel(struct GraphNodeObject *graphNode, struct Animation **animPtrAddr, u32 animAccel);
 
 s32  retrieve_animation_index(s32 frame, u16 **attributes);
+void decode_animation_frame(struct Animation *anim, s32 frame, s16 *dest);
 
 s32  geo_update_animation_frame(struct AnimInfo *obj, s32 *accelAssist);
 void geo_retreive_animation_translation(struct GraphNodeObject *obj, Vec3f position);
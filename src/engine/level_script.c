@@ -28,6 +28,7 @@
 #include "game/puppycam2.h"
 #include "game/puppyprint.h"
 #include "game/puppylights.h"
+#include "boot/alloc_trace.h"
 
 #include "config.h"
 
@@ -367,6 +368,7 @@ static void level_cmd_clear_level(void) {
 
 static void level_cmd_alloc_level_pool(void) {
     if (sLevelPool == NULL) {
+        ALLOC_TRACE_TRANSIENT(ALLOC_TRACE_ALLOC_ONLY);
         sLevelPool = alloc_only_pool_init(main_pool_available() - sizeof(struct AllocOnlyPool),
                                           MEMORY_POOL_LEFT);
     }
@@ -451,6 +451,7 @@ extern f32 gSineTable[];
 
 #define ABS(x)  (((x) > 0) ? (x) : -(x))
 
+#ifdef TARGET_N64
 /// From Wiseguy
 ALWAYS_INLINE s32 roundf(f32 in) {
     f32 tmp;
@@ -459,14 +460,24 @@ ALWAYS_INLINE s32 roundf(f32 in) {
     __asm__("mfc1      %0,%1" : "=r" (out) : "f" (tmp));
     return out;
 }
+#else
+// Host builds (tools/audio_render) can't use the MIPS instructions. Rounds half to even like round.w.s.
+ALWAYS_INLINE s32 roundf(f32 in) {
+    return __builtin_lrintf(in);
+}
+#endif
 // backwards compatibility
 #define round_float(in) roundf(in)
 
 /// Absolute value
 ALWAYS_INLINE f32 absf(f32 in) {
+#ifdef TARGET_N64
     f32 out;
     __asm__("abs.s %0,%1" : "=f" (out) : "f" (in));
     return out;
+#else
+    return __builtin_fabsf(in);
+#endif
 }
 ALWAYS_INLINE s32 absi(s32 in) {
     return ABS(in);
@@ -607,6 +618,5 @@ f32 atan2f(f32 a, f32 b);
 void spline_get_weights(Vec4f result, f32 t, UNUSED s32 c);
 void anim_spline_init(Vec4s *keyFrames);
 s32  anim_spline_poll(Vec3f result);
-void find_surface_on_ray(Vec3f orig, Vec3f dir, struct Surface **hit_surface, Vec3f hit_pos, s32 flags);
 
 #endif // MATH_UTIL_H
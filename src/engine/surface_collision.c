@@ -197,7 +197,7 @@ s32 find_wall_collisions(struct WallCollisionData *colData) {
     numCollisions += find_wall_collisions_from_list(node, colData);
 
     gCollisionFlags &= ~(COLLISION_FLAG_RETURN_FIRST | COLLISION_FLAG_EXCLUDE_DYNAMIC | COLLISION_FLAG_INCLUDE_INTANGIBLE);
-#ifdef VANILLA_DEBUG
+#ifdef COUNT_COLLISION_CALLS
     // Increment the debug tracker.
     gNumCalls.wall++;
 #endif
@@ -360,7 +360,7 @@ f32 find_ceil(f32 posX, f32 posY, f32 posZ, struct Surface **pceil) {
 
     // Return the ceiling.
     *pceil = ceil;
-#ifdef VANILLA_DEBUG
+#ifdef COUNT_COLLISION_CALLS
     // Increment the debug tracker.
     gNumCalls.ceil++;
 #endif
@@ -598,7 +598,7 @@ f32 find_floor(f32 xPos, f32 yPos, f32 zPos, struct Surface **pfloor) {
 
     // Return the floor.
     *pfloor = floor;
-#ifdef VANILLA_DEBUG
+#ifdef COUNT_COLLISION_CALLS
     // Increment the debug tracker.
     gNumCalls.floor++;
 #endif
@@ -635,7 +635,7 @@ f32 find_water_floor(s32 xPos, s32 yPos, s32 zPos, struct Surface **pfloor) {
     } else {
         *pfloor = floor;
     }
-#ifdef VANILLA_DEBUG
+#ifdef COUNT_COLLISION_CALLS
     // Increment the debug tracker.
     gNumCalls.floor++;
 #endif
@@ -753,6 +753,315 @@ s32 find_poison_gas_level(s32 x, s32 z) {
     return gasLevel;
 }
 
+// The RaycastFlags bit for each spatial partition.
+static const s32 sPartitionRaycastFlags[] = {
+    [SPATIAL_PARTITION_FLOORS] = RAYCAST_FIND_FLOOR,
+    [SPATIAL_PARTITION_CEILS ] = RAYCAST_FIND_CEIL,
+    [SPATIAL_PARTITION_WALLS ] = RAYCAST_FIND_WALL,
+    [SPATIAL_PARTITION_WATER ] = RAYCAST_FIND_WATER,
+};
+
+/**************************************************
+ *                    RAYCASTING                  *
+ **************************************************/
+
+#define RAY_OFFSET 30.0f /* How many units to extrapolate surfaces when testing for a raycast */
+
+/**
+ * Checks if a ray intersects a surface using the Möller–Trumbore algorithm. Surfaces are
+ * moved RAY_OFFSET units forward along their normal, and are only hit from the front.
+ * Returns the distance along the ray, or a negative value if there is no hit closer than maxLength.
+ */
+static f32 ray_surface_intersect(Vec3f orig, Vec3f dir, f32 maxLength, struct Surface *surf) {
+    Vec3f v0, e1, e2, h, s, q;
+
+    // Ignore surfaces the camera should pass through.
+    if (surf->type == SURFACE_INTANGIBLE || (surf->flags & SURFACE_FLAG_NO_CAM_COLLISION)) return -1.0f;
+
+    // Move the face forward by RAY_OFFSET.
+    v0[0] = surf->vertex1[0] + (surf->normal.x * RAY_OFFSET);
+    v0[1] = surf->vertex1[1] + (surf->normal.y * RAY_OFFSET);
+    v0[2] = surf->vertex1[2] + (surf->normal.z * RAY_OFFSET);
+    vec3_diff(e1, surf->vertex2, surf->vertex1);
+    vec3_diff(e2, surf->vertex3, surf->vertex1);
+
+    vec3f_cross(h, dir, e2);
+    f32 det = vec3f_dot(e1, h);
+    // Reject rays parallel to or hitting the back of the surface.
+    if (det < NEAR_ZERO) return -1.0f;
+
+    f32 invDet = 1.0f / det;
+    vec3f_diff(s, orig, v0);
+    f32 u = invDet * vec3f_dot(s, h);
+    if (u < 0.0f || u > 1.0f) return -1.0f;
+
+    vec3f_cross(q, s, e1);
+    f32 v = invDet * vec3f_dot(dir, q);
+    if (v < 0.0f || (u + v) > 1.0f) return -1.0f;
+
+    f32 length = invDet * vec3f_dot(e2, q);
+    if (length <= NEAR_ZERO || length > maxLength) return -1.0f;
+
+    return length;
+}
+
+/**
+ * Test every surface in a list against the ray, keeping the nearest hit in *maxLength.
+ */
+static void find_surface_on_ray_list(struct SurfaceNode *surfaceNode, Vec3f orig, Vec3f dir, f32 bottom, f32 top, struct Surface **hitSurface, f32 *maxLength) {
+    register struct Surface *surf;
+    f32 length;
+
+    while (surfaceNode != NULL) {
+        surf = surfaceNode->surface;
+        surfaceNode = surfaceNode->next;
+
+        // Reject the surface if it's out of the ray's vertical range, allowing for RAY_OFFSET.
+        if (surf->lowerY - RAY_OFFSET > top || surf->upperY + RAY_OFFSET < bottom) continue;
+
+        length = ray_surface_intersect(orig, dir, *maxLength, surf);
+        if (length >= 0.0f) {
+            *hitSurface = surf;
+            *maxLength = length;
+        }
+    }
+}
+
+/**
+ * Test the surfaces of one cell, selected by RaycastFlags, against the ray.
+ */
+static void find_surface_on_ray_cell(s32 cellX, s32 cellZ, Vec3f orig, Vec3f dir, f32 bottom, f32 top, struct Surface **hitSurface, f32 *maxLength, s32 flags) {
+    s32 partition;
+
+    for (partition = SPATIAL_PARTITION_FLOORS; partition <= SPATIAL_PARTITION_WATER; partition++) {
+        if (!(flags & sPartitionRaycastFlags[partition])) continue;
+        // A ray going straight up can't hit the front of a floor, nor one going straight down a ceiling.
+        if (partition == SPATIAL_PARTITION_FLOORS && dir[1] >=  NEAR_ONE) continue;
+        if (partition == SPATIAL_PARTITION_CEILS  && dir[1] <= -NEAR_ONE) continue;
+        find_surface_on_ray_list( gStaticSurfacePartition[cellZ][cellX][partition].next, orig, dir, bottom, top, hitSurface, maxLength);
+        find_surface_on_ray_list(gDynamicSurfacePartition[cellZ][cellX][partition].next, orig, dir, bottom, top, hitSurface, maxLength);
+    }
+}
+
+/**
+ * Cast a ray from orig along dir and find the nearest surface it hits, selected by RaycastFlags.
+ * hitPos is set to the hit position, or to orig + dir if nothing was hit.
+ *
+ * The cells the ray crosses are walked in order (Amanatides & Woo), each one once, and the walk
+ * stops as soon as the nearest hit so far lies inside the cells already checked.
+ */
+void find_surface_on_ray(Vec3f orig, Vec3f dir, struct Surface **hitSurface, Vec3f hitPos, s32 flags) {
+    Vec3f normDir;
+    f32 tMaxX, tMaxZ, tDeltaX, tDeltaZ, tExit;
+    s32 cellX, cellZ, stepX, stepZ;
+
+    *hitSurface = NULL;
+    vec3f_sum(hitPos, orig, dir);
+
+    f32 dirLength = vec3_mag(dir);
+    if (dirLength < NEAR_ZERO) return;
+    f32 maxLength = dirLength;
+    vec3_quot_val(normDir, dir, dirLength);
+
+    // Vertical range of the ray, used to reject surfaces before the triangle test.
+    f32 bottom = MIN(orig[1], hitPos[1]);
+    f32 top    = MAX(orig[1], hitPos[1]);
+
+    f32 cellPosX = (orig[0] + LEVEL_BOUNDARY_MAX) / CELL_SIZE;
+    f32 cellPosZ = (orig[2] + LEVEL_BOUNDARY_MAX) / CELL_SIZE;
+    cellX = cellPosX;
+    cellZ = cellPosZ;
+
+    // Distance along the ray to the first cell boundary on each axis, and between boundaries.
+    if (normDir[0] > NEAR_ZERO) {
+        stepX = 1;
+        tDeltaX = CELL_SIZE / normDir[0];
+        tMaxX = (cellX + 1 - cellPosX) * tDeltaX;
+    } else if (normDir[0] < -NEAR_ZERO) {
+        stepX = -1;
+        tDeltaX = CELL_SIZE / -normDir[0];
+        tMaxX = (cellPosX - cellX) * tDeltaX;
+    } else {
+        stepX = 0;
+        tDeltaX = tMaxX = F32_MAX;
+    }
+    if (normDir[2] > NEAR_ZERO) {
+        stepZ = 1;
+        tDeltaZ = CELL_SIZE / normDir[2];
+        tMaxZ = (cellZ + 1 - cellPosZ) * tDeltaZ;
+    } else if (normDir[2] < -NEAR_ZERO) {
+        stepZ = -1;
+        tDeltaZ = CELL_SIZE / -normDir[2];
+        tMaxZ = (cellPosZ - cellZ) * tDeltaZ;
+    } else {
+        stepZ = 0;
+        tDeltaZ = tMaxZ = F32_MAX;
+    }
+
+    while (TRUE) {
+        if (cellX >= 0 && cellX < NUM_CELLS && cellZ >= 0 && cellZ < NUM_CELLS) {
+            find_surface_on_ray_cell(cellX, cellZ, orig, normDir, bottom, top, hitSurface, &maxLength, flags);
+        } else if ((cellX < 0 && stepX <= 0) || (cellX >= NUM_CELLS && stepX >= 0)
+                || (cellZ < 0 && stepZ <= 0) || (cellZ >= NUM_CELLS && stepZ >= 0)) {
+            // Heading away from the level, so no more cells can be reached.
+            break;
+        }
+
+        // Stop once the ray (or its nearest hit) ends inside this cell.
+        tExit = MIN(tMaxX, tMaxZ);
+        if (maxLength <= tExit) break;
+
+        if (tMaxX < tMaxZ) {
+            cellX += stepX;
+            tMaxX += tDeltaX;
+        } else {
+            cellZ += stepZ;
+            tMaxZ += tDeltaZ;
+        }
+    }
+
+    if (*hitSurface != NULL) {
+        vec3_prod_val(hitPos, normDir, maxLength);
+        vec3f_add(hitPos, orig);
+    }
+
+#ifdef COUNT_COLLISION_CALLS
+    // Increment the debug tracker.
+    gNumCalls.ray++;
+#endif
+}
+
+#undef RAY_OFFSET
+
+/**************************************************
+ *                 SWEPT COLLISION                *
+ **************************************************/
+
+#ifdef SWEPT_COLLISION
+
+/**
+ * Returns the earliest time in [0, 1] at which the range [min0, max0], moving by rate per unit
+ * of time, overlaps [lo, hi], or a time past 1 if it never does.
+ */
+static f32 sweep_entry_time(f32 min0, f32 max0, f32 rate, f32 lo, f32 hi) {
+    if (min0 <= hi && max0 >= lo) return 0.0f;
+    if (min0 > hi) {
+        if (rate >= 0.0f) return 2.0f;
+        return ((hi - min0) / rate);
+    }
+    if (rate <= 0.0f) return 2.0f;
+    return ((lo - max0) / rate);
+}
+
+/**
+ * Check a surface list against the swept cylinder. The triangle bounds are only tested against
+ * the bounding box of the sweep, so this can report surfaces the cylinder passes beside, but
+ * never misses one it touches.
+ */
+static void find_swept_collision_from_list(struct SurfaceNode *surfaceNode, Vec3f pos, Vec3f motion, Vec3f boxMin, Vec3f boxMax, struct SweptCollisionData *data) {
+    register struct Surface *surf;
+    f32 lo, hi, min0, max0, rate, t;
+
+    while (surfaceNode != NULL) {
+        surf = surfaceNode->surface;
+        surfaceNode = surfaceNode->next;
+
+        if (surf->type == SURFACE_CAMERA_BOUNDARY) continue;
+        if (surf->lowerY > boxMax[1] || surf->upperY < boxMin[1]) continue;
+        if (MIN(surf->vertex1[0], MIN(surf->vertex2[0], surf->vertex3[0])) > boxMax[0]) continue;
+        if (MAX(surf->vertex1[0], MAX(surf->vertex2[0], surf->vertex3[0])) < boxMin[0]) continue;
+        if (MIN(surf->vertex1[2], MIN(surf->vertex2[2], surf->vertex3[2])) > boxMax[2]) continue;
+        if (MAX(surf->vertex1[2], MAX(surf->vertex2[2], surf->vertex3[2])) < boxMin[2]) continue;
+
+        // Signed distance from the surface's plane to the bottom of the cylinder, and how fast it changes.
+        min0 = (surf->normal.x * pos[0]) + (surf->normal.y * (pos[1] + data->bottom)) + (surf->normal.z * pos[2]) + surf->originOffset;
+        rate = (surf->normal.x * motion[0]) + (surf->normal.y * motion[1]) + (surf->normal.z * motion[2]);
+
+        if (surf->normal.y >= NORMAL_FLOOR_THRESHOLD) {
+            // Floors are found up to FIND_FLOOR_BUFFER units above the bottom of the cylinder.
+            if (surf->type == SURFACE_INTANGIBLE) continue;
+            lo = -FIND_FLOOR_BUFFER * surf->normal.y;
+            hi = 0.0f;
+            max0 = min0;
+        } else if (surf->normal.y <= NORMAL_CEIL_THRESHOLD) {
+            // Ceilings are hit when the top of the cylinder reaches them from below.
+            lo = (data->top - data->bottom) * surf->normal.y;
+            hi = 0.0f;
+            min0 += (data->top - data->bottom) * surf->normal.y;
+            max0 = min0;
+        } else {
+            // Walls are hit when any height of the cylinder comes within its radius of the plane.
+            lo = -data->radius;
+            hi =  data->radius;
+            max0 = min0 + ((data->top - data->bottom) * surf->normal.y);
+            if (max0 < min0) {
+                t = max0;
+                max0 = min0;
+                min0 = t;
+            }
+        }
+
+        t = sweep_entry_time(min0, max0, rate, lo, hi);
+        if (t < data->t || (t == data->t && data->surface == NULL)) {
+            data->t = t;
+            data->surface = surf;
+        }
+    }
+}
+
+/**
+ * Sweep a vertical cylinder from pos along motion, and find the first floor, wall or ceiling
+ * (selected by RaycastFlags) it would run into. data->t is set to the fraction of the motion
+ * before contact, or 1.0f if nothing is in the way. Returns whether a surface was found.
+ *
+ * This is meant as a cheap test for whether the exact collision checks can be skipped,
+ * not as a replacement for them.
+ */
+s32 find_swept_collision(Vec3f pos, Vec3f motion, struct SweptCollisionData *data, s32 flags) {
+    Vec3f boxMin, boxMax;
+    s32 minCellX, minCellZ, maxCellX, maxCellZ;
+    s32 cellX, cellZ, i;
+    s32 partition;
+
+    data->t = 1.0f;
+    data->surface = NULL;
+
+    for (i = 0; i < 3; i++) {
+        boxMin[i] = MIN(pos[i], pos[i] + motion[i]);
+        boxMax[i] = MAX(pos[i], pos[i] + motion[i]);
+    }
+    boxMin[0] -= data->radius;
+    boxMax[0] += data->radius;
+    boxMin[1] += data->bottom;
+    // Floors are found slightly above the bottom of the cylinder.
+    boxMax[1] += MAX(data->top, data->bottom + FIND_FLOOR_BUFFER);
+    boxMin[2] -= data->radius;
+    boxMax[2] += data->radius;
+
+    minCellX = GET_CELL_COORD(CLAMP(boxMin[0], -LEVEL_BOUNDARY_MAX, LEVEL_BOUNDARY_MAX - 1));
+    minCellZ = GET_CELL_COORD(CLAMP(boxMin[2], -LEVEL_BOUNDARY_MAX, LEVEL_BOUNDARY_MAX - 1));
+    maxCellX = GET_CELL_COORD(CLAMP(boxMax[0], -LEVEL_BOUNDARY_MAX, LEVEL_BOUNDARY_MAX - 1));
+    maxCellZ = GET_CELL_COORD(CLAMP(boxMax[2], -LEVEL_BOUNDARY_MAX, LEVEL_BOUNDARY_MAX - 1));
+
+    for (cellZ = minCellZ; cellZ <= maxCellZ; cellZ++) {
+        for (cellX = minCellX; cellX <= maxCellX; cellX++) {
+            for (partition = SPATIAL_PARTITION_FLOORS; partition <= SPATIAL_PARTITION_WALLS; partition++) {
+                if (!(flags & sPartitionRaycastFlags[partition])) continue;
+                find_swept_collision_from_list(gDynamicSurfacePartition[cellZ][cellX][partition].next, pos, motion, boxMin, boxMax, data);
+                find_swept_collision_from_list(gStaticSurfacePartition[cellZ][cellX][partition].next, pos, motion, boxMin, boxMax, data);
+            }
+        }
+    }
+
+#ifdef COUNT_COLLISION_CALLS
+    // Increment the debug tracker.
+    gNumCalls.sweep++;
+#endif
+
+    return (data->surface != NULL);
+}
+#endif
+
 /**************************************************
  *                      DEBUG                     *
  **************************************************/
@@ -42,6 +42,13 @@ struct WallCollisionData {
     /*0x18*/ struct Surface *walls[MAX_REFERENCED_WALLS];
 };
 
+struct SweptCollisionData {
+    /*0x00*/ f32 radius;
+    /*0x04*/ f32 bottom, top; // Heights of the cylinder's ends relative to the swept position
+    /*0x0C*/ f32 t;           // Fraction of the motion before the first contact, 1.0f if none
+    /*0x10*/ struct Surface *surface;
+};
+
 s32 f32_find_wall_collision(f32 *xPtr, f32 *yPtr, f32 *zPtr, f32 offsetY, f32 radius);
 s32 find_wall_collisions(struct WallCollisionData *colData);
 void resolve_and_return_wall_collisions(Vec3f pos, f32 offset, f32 radius, struct WallCollisionData *collisionData);
@@ -58,6 +65,10 @@ f32 find_room_floor(f32 x, f32 y, f32 z, struct Surface **pfloor);
 s32 find_water_level_and_floor(s32 x, s32 y, s32 z, struct Surface **pfloor);
 s32 find_water_level(s32 x, s32 z);
 s32 find_poison_gas_level(s32 x, s32 z);
+void find_surface_on_ray(Vec3f orig, Vec3f dir, struct Surface **hitSurface, Vec3f hitPos, s32 flags);
+#ifdef SWEPT_COLLISION
+s32 find_swept_collision(Vec3f pos, Vec3f motion, struct SweptCollisionData *data, s32 flags);
+#endif
 #ifdef VANILLA_DEBUG
 void debug_surface_list_info(f32 xPos, f32 zPos);
 #endif
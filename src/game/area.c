@@ -375,11 +375,58 @@ void play_transition_after_delay(s16 transType, s16 time, u8 red, u8 green, u8 b
     play_transition(transType, time, red, green, blue);
 }
 
+#ifdef UNLOCK_FPS_INTERPOLATION
+// What the latest game step drew, so the frames until the next one can draw the scene again.
+static struct GraphNodeRoot *sStepGraphNode = NULL;
+static Vp *sStepViewportOverride = NULL;
+static Vp *sStepViewportClip = NULL;
+static RGBA16FILL sStepFBSetColor = 0;
+static Gfx *sStepOverlayDL = NULL;
+static Gfx *sStepOverlaySkip = NULL;
+
+/**
+ * Everything render_game draws after the scene goes in its own display list, which the
+ * in between frames call again. The step's own frame branches over it and calls it too.
+ */
+static void begin_step_overlay(struct GraphNodeRoot *graphNode) {
+    sStepGraphNode = graphNode;
+    sStepViewportOverride = gViewportOverride;
+    sStepViewportClip = gViewportClip;
+    sStepFBSetColor = gFBSetColor;
+    sStepOverlaySkip = gDisplayListHead++;
+    sStepOverlayDL = gDisplayListHead;
+}
+
+static void end_step_overlay(void) {
+    gSPEndDisplayList(gDisplayListHead++);
+    gSPBranchList(sStepOverlaySkip, VIRTUAL_TO_PHYSICAL(gDisplayListHead));
+    gSPDisplayList(gDisplayListHead++, VIRTUAL_TO_PHYSICAL(sStepOverlayDL));
+}
+
+/**
+ * Draws the scene of the latest game step again, interpolated by gInterpAlpha, under the same HUD and menus.
+ * Only valid until the next step, since the overlay is in that step's gfx pool.
+ */
+void render_game_interpolated(void) {
+    gInterpFrame = TRUE;
+    if (sStepGraphNode != NULL) {
+        geo_process_root(sStepGraphNode, sStepViewportOverride, sStepViewportClip, sStepFBSetColor);
+    }
+    if (sStepOverlayDL != NULL) {
+        gSPDisplayList(gDisplayListHead++, VIRTUAL_TO_PHYSICAL(sStepOverlayDL));
+    }
+    gInterpFrame = FALSE;
+}
+#endif
+
 void render_game(void) {
     if (gCurrentArea != NULL && !gWarpTransition.pauseRendering) {
         if (gCurrentArea->graphNode) {
             geo_process_root(gCurrentArea->graphNode, gViewportOverride, gViewportClip, gFBSetColor);
         }
+#ifdef UNLOCK_FPS_INTERPOLATION
+        begin_step_overlay(gCurrentArea->graphNode);
+#endif
 
         gSPViewport(gDisplayListHead++, VIRTUAL_TO_PHYSICAL(&gViewport));
 
@@ -421,6 +468,9 @@ void render_game(void) {
             }
         }
     } else {
+#ifdef UNLOCK_FPS_INTERPOLATION
+        begin_step_overlay(NULL);
+#endif
         render_text_labels();
         if (gViewportClip != NULL) {
             clear_viewport(gViewportClip, gWarpTransFBSetColor);
@@ -437,4 +487,7 @@ void render_game(void) {
 #if PUPPYPRINT_DEBUG
     puppyprint_render_profiler();
 #endif
+#ifdef UNLOCK_FPS_INTERPOLATION
+    end_step_overlay();
+#endif
 }
@@ -1847,7 +1847,8 @@ Gfx *geo_switch_bowser_eyes(s32 callContext, struct GraphNode *node, UNUSED Mat4
     struct Object *obj = (struct Object *) gCurGraphNodeObject;
     struct GraphNodeSwitchCase *switchCase = (struct GraphNodeSwitchCase *) node;
 
-    if (callContext == GEO_CONTEXT_RENDER) {
+    // The eyes timer counts game steps, so the frames between steps keep the step's eyes.
+    if (callContext == GEO_CONTEXT_RENDER && !IS_INTERP_FRAME()) {
         if (gCurGraphNodeHeldObject != NULL) {
             obj = gCurGraphNodeHeldObject->objNode;
         }
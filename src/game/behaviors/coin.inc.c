@@ -238,6 +238,9 @@ void bhv_coin_formation_loop(void) {
                     }
                 }
                 o->oAction = COIN_FORMATION_ACT_ACTIVE;
+            } else {
+                // Nothing to do until Mario is close enough to spawn the coins.
+                cur_obj_sleep_until(COIN_FORMATION_DISTANCE, 0, NULL);
             }
             break;
         case COIN_FORMATION_ACT_ACTIVE:
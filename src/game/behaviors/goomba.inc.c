@@ -96,6 +96,8 @@ void bhv_goomba_triplet_spawner_update(void) {
             }
 
             o->oAction++;
+        } else {
+            cur_obj_sleep_until(3000.0f, 0, NULL);
         }
     } else if (o->oDistanceToMario > 4000.0f) {
         // If mario is too far away, enter the unloaded action. The goombas
@@ -24,6 +24,7 @@
 #include "object_list_processor.h"
 #include "paintings.h"
 #include "engine/graph_node.h"
+#include "rendering_graph_node.h"
 #include "level_table.h"
 #include "config.h"
 #include "puppyprint.h"
@@ -2425,14 +2426,13 @@ void exit_c_up(struct Camera *c) {
     struct Surface *surface;
     Vec3f checkFoc;
     Vec3f curPos;
+    Vec3f rayDir;
+    Vec3f hitPos;
     // Variables for searching for an open direction
     s32 searching = FALSE;
     /// The current sector of the circle that we are checking
     s32 sector;
-    f32 ceilHeight;
-    f32 floorHeight;
     f32 curDist;
-    f32 d;
     s16 curPitch;
     s16 curYaw;
     s16 checkYaw = 0;
@@ -2457,29 +2457,13 @@ void exit_c_up(struct Camera *c) {
                 // If there are no walls this way,
                 if (f32_find_wall_collision(&curPos[0], &curPos[1], &curPos[2], 20.f, 50.f) == 0) {
 
-                    // Start close to Mario, check for walls, floors, and ceilings all the way to the
-                    // zoomed out distance
-                    for (d = curDist; d < gCameraZoomDist; d += 20.f) {
-                        vec3f_set_dist_and_angle(checkFoc, curPos, d, 0, curYaw + checkYaw);
-
-                        // Check if we're zooming out into a floor or ceiling
-                        ceilHeight = find_ceil(curPos[0], curPos[1] - 150.f, curPos[2], &surface) + -10.f;
-                        if (surface != NULL && ceilHeight < curPos[1]) {
-                            break;
-                        }
-                        floorHeight = find_floor(curPos[0], curPos[1] + 150.f, curPos[2], &surface) + 10.f;
-                        if (surface != NULL && floorHeight > curPos[1]) {
-                            break;
-                        }
-
-                        // Stop checking this direction if there is a wall blocking the way
-                        if (f32_find_wall_collision(&curPos[0], &curPos[1], &curPos[2], 20.f, 50.f) == 1) {
-                            break;
-                        }
-                    }
+                    // Start close to Mario, and cast a ray for walls, floors, and ceilings all the way
+                    // to the zoomed out distance
+                    vec3f_set_dist_and_angle(gVec3fZero, rayDir, gCameraZoomDist - curDist, 0, curYaw + checkYaw);
+                    find_surface_on_ray(curPos, rayDir, &surface, hitPos, RAYCAST_FIND_FLOOR | RAYCAST_FIND_CEIL | RAYCAST_FIND_WALL);
 
                     // If there was no collision found all the way to the max distance, it's an opening
-                    if (d >= gCameraZoomDist) {
+                    if (surface == NULL) {
                         searching = FALSE;
                     }
                 }
@@ -3375,7 +3359,7 @@ void zoom_out_if_paused_and_outside(struct GraphNodeCamera *camera) {
                 }
 #endif
             }
-        } else {
+        } else if (!IS_INTERP_FRAME()) {
             sFramesPaused++;
         }
     } else {
@@ -6364,6 +6348,9 @@ s16 camera_course_processing(struct Camera *c) {
 
 /**
  * Move `pos` between the nearest floor and ceiling
+ *
+ * This clamps a point rather than tracing a path, so it stays on the point queries
+ * instead of find_surface_on_ray.
  */
 void resolve_geometry_collisions(Vec3f pos) {
     struct Surface *surf;
@@ -6410,6 +6397,10 @@ void resolve_geometry_collisions(Vec3f pos) {
  * @param yawRange      how wide of an arc to check for walls obscuring Mario.
  *
  * @return 3 if a wall is covering Mario, 1 if a wall is only near the camera.
+ *
+ * The steps look for walls within up to 250 units of the line from Mario to the camera, so the
+ * camera turns before a wall actually blocks the view. find_surface_on_ray only finds walls the
+ * line crosses, so it can't replace them without changing how the camera behaves.
  */
 s32 rotate_camera_around_walls(UNUSED struct Camera *c, Vec3f cPos, s16 *avoidYaw, s16 yawRange) {
     struct WallCollisionData colData;
@@ -10988,6 +10979,11 @@ Gfx *geo_camera_fov(s32 callContext, struct GraphNode *g, UNUSED void *context)
     struct MarioState *marioState = &gMarioStates[0];
     u8 fovFunc = sFOVState.fovFunc;
 
+    // The fov approaches and shakes once per game step, so the frames between steps keep the step's fov.
+    if (IS_INTERP_FRAME()) {
+        return NULL;
+    }
+
     if (callContext == GEO_CONTEXT_RENDER) {
         switch (fovFunc) {
             case CAM_FOV_SET_45:
@@ -11,6 +11,7 @@
 #include "main.h"
 #include "debug.h"
 #include "rumble_init.h"
+#include "boot/alloc_trace.h"
 
 #include "sm64.h"
 
@@ -24,6 +25,9 @@ enum crashPages {
     PAGE_STACKTRACE,
     PAGE_DISASM,
     PAGE_ASSERTS,
+#ifdef ALLOC_TRACE
+    PAGE_ALLOCS,
+#endif
     PAGE_COUNT
 };
 
@@ -322,6 +326,80 @@ void draw_assert(UNUSED OSThread *thread) {
     osWritebackDCacheAll();
 }
 
+#ifdef ALLOC_TRACE
+#define ALLOC_PAGE_NUM_POOLS  6
+#define ALLOC_PAGE_NUM_SITES  5
+#define ALLOC_PAGE_NUM_RECENT 5
+
+static char *alloc_caller_name(u32 caller) {
+    if ((u32) parse_map == MAP_PARSER_ADDRESS) {
+        return NULL;
+    }
+    return parse_map(caller);
+}
+
+// Pools that failed or came closest to full, the call sites that failed or allocated the most,
+// and the newest allocations.
+void draw_allocs(UNUSED OSThread *thread) {
+    s32 top[ALLOC_PAGE_NUM_SITES];
+    s32 numTop;
+    s32 i;
+    s32 y = 25;
+
+    crash_screen_draw_rect(25, 20, 270, 210);
+
+    crash_screen_print(30, y, "POOL ADDR       USED/SIZE     PEAK FAIL");
+    y += 10;
+    numTop = alloc_trace_top_pools(top, ALLOC_PAGE_NUM_POOLS);
+    for (i = 0; i < numTop; i++) {
+        struct AllocTracePool *pool = &gAllocTracePools[top[i]];
+
+        crash_screen_print(30, y, "%-4s %08X %6X/%-6X %6X %4d", gAllocTraceKindNames[pool->kind],
+                           (u32) pool->pool, pool->used, pool->total, pool->peak, pool->failures);
+        y += 10;
+    }
+    y = (35 + (ALLOC_PAGE_NUM_POOLS * 10));
+
+    crash_screen_print(30, y, "TOP CALLERS             ALLOCS  BYTES FAIL");
+    y += 10;
+    numTop = alloc_trace_top_sites(top, ALLOC_PAGE_NUM_SITES);
+    for (i = 0; i < numTop; i++) {
+        struct AllocTraceSite *site = &gAllocTraceSites[top[i]];
+        char *fname = alloc_caller_name(site->caller);
+
+        if (fname == NULL) {
+            crash_screen_print(30, y, "%08X                %5d %6X %4d", site->caller, site->allocs, site->bytes, site->failures);
+        } else {
+            crash_screen_print(30, y, "%-23.23s %5d %6X %4d", fname, site->allocs, site->bytes, site->failures);
+        }
+        y += 10;
+    }
+    y = (45 + ((ALLOC_PAGE_NUM_POOLS + ALLOC_PAGE_NUM_SITES) * 10));
+
+    crash_screen_print(30, y, "RECENT (VBLANK POOL SIZE ADDR CALLER)");
+    y += 10;
+    for (i = 0; i < ALLOC_PAGE_NUM_RECENT && i < (s32) gAllocTraceNumRecent && i < ALLOC_TRACE_NUM_RECENT; i++) {
+        struct AllocTraceEntry *entry = &gAllocTraceRecent[(gAllocTraceNumRecent - 1 - i) & (ALLOC_TRACE_NUM_RECENT - 1)];
+        char *fname = alloc_caller_name(entry->caller);
+        char addr[9];
+
+        if (entry->addr == NULL) {
+            sprintf(addr, "FAILED");
+        } else {
+            sprintf(addr, "%08X", (u32) entry->addr);
+        }
+        if (fname == NULL) {
+            crash_screen_print(30, y, "%04X %-4s %6X %-8s %08X", entry->vblank, gAllocTraceKindNames[entry->kind], entry->size, addr, entry->caller);
+        } else {
+            crash_screen_print(30, y, "%04X %-4s %6X %-8s %.18s", entry->vblank, gAllocTraceKindNames[entry->kind], entry->size, addr, fname);
+        }
+        y += 10;
+    }
+
+    osWritebackDCacheAll();
+}
+#endif
+
 void draw_crash_screen(OSThread *thread) {
     __OSThreadContext *tc = &thread->context;
 
@@ -367,6 +445,9 @@ void draw_crash_screen(OSThread *thread) {
             case PAGE_STACKTRACE: draw_stacktrace(thread, cause); break;
             case PAGE_DISASM:     draw_disasm(thread); break;
             case PAGE_ASSERTS:    draw_assert(thread); break;
+#ifdef ALLOC_TRACE
+            case PAGE_ALLOCS:     draw_allocs(thread); break;
+#endif
         }
 
         osWritebackDCacheAll();
@@ -2,15 +2,14 @@
 
 #include "sm64.h"
 #include "game_init.h"
-#include "memory.h"
 #include "envfx_snow.h"
 #include "envfx_bubbles.h"
 #include "engine/surface_collision.h"
 #include "engine/math_util.h"
 #include "engine/behavior_script.h"
 #include "audio/external.h"
-#include "textures.h"
 #include "level_geo.h"
+#include "particle_system.h"
 
 /**
  * This file implements environment effects that are not snow:
@@ -22,16 +21,16 @@
  */
 
 s16 gEnvFxBubbleConfig[10];
-static Gfx *sGfxCursor; // points to end of display list for bubble particles
 static s32 sBubbleParticleCount;
 static s32 sBubbleParticleMaxCount;
 
-/// Template for a bubble particle triangle
-Vtx_t gBubbleTempVtx[3] = {
-    { { 0, 0, 0 }, 0, { 1544, 964 }, { 0xFF, 0xFF, 0xFF, 0xFF } },
-    { { 0, 0, 0 }, 0, { 522, -568 }, { 0xFF, 0xFF, 0xFF, 0xFF } },
-    { { 0, 0, 0 }, 0, { -498, 964 }, { 0xFF, 0xFF, 0xFF, 0xFF } },
-};
+#define xPos(i)       gParticles.posX[i]
+#define yPos(i)       gParticles.posY[i]
+#define zPos(i)       gParticles.posZ[i]
+#define animFrame(i)  gParticles.frame[i]
+#define angle(i)      gParticles.envfxAngle[i]
+#define dist(i)       gParticles.envfxDist[i]
+#define bubbleY(i)    gParticles.envfxBaseY[i]
 
 /**
  * Check whether the particle with the given index is
@@ -39,10 +38,10 @@ Vtx_t gBubbleTempVtx[3] = {
  * kill flower and bubble particles.
  */
 s32 particle_is_laterally_close(s32 index, s32 x, s32 z, s32 distance) {
-    s32 xPos = (gEnvFxBuffer + index)->xPos;
-    s32 zPos = (gEnvFxBuffer + index)->zPos;
+    s32 posX = xPos(index);
+    s32 posZ = zPos(index);
 
-    if (sqr(xPos - x) + sqr(zPos - z) > sqr(distance)) {
+    if (sqr(posX - x) + sqr(posZ - z) > sqr(distance)) {
         return FALSE;
     }
 
@@ -76,17 +75,15 @@ void envfx_update_flower(Vec3s centerPos) {
     s16 centerZ = centerPos[2];
 
     for (i = 0; i < sBubbleParticleMaxCount; i++) {
-        (gEnvFxBuffer + i)->isAlive = particle_is_laterally_close(i, centerX, centerZ, 3000);
-        if (!(gEnvFxBuffer + i)->isAlive) {
-            (gEnvFxBuffer + i)->xPos = random_flower_offset() + centerX;
-            (gEnvFxBuffer + i)->zPos = random_flower_offset() + centerZ;
-            (gEnvFxBuffer + i)->yPos = find_floor_height((gEnvFxBuffer + i)->xPos, 10000.0f, (gEnvFxBuffer + i)->zPos);
-            (gEnvFxBuffer + i)->isAlive = TRUE;
-            (gEnvFxBuffer + i)->animFrame = random_float() * 5.0f;
+        if (!particle_is_laterally_close(i, centerX, centerZ, 3000)) {
+            xPos(i) = random_flower_offset() + centerX;
+            zPos(i) = random_flower_offset() + centerZ;
+            yPos(i) = find_floor_height(xPos(i), 10000.0f, zPos(i));
+            animFrame(i) = random_float() * 5.0f;
         } else if (!(globalTimer & 3)) {
-            (gEnvFxBuffer + i)->animFrame++;
-            if ((gEnvFxBuffer + i)->animFrame > 5) {
-                (gEnvFxBuffer + i)->animFrame = 0;
+            animFrame(i)++;
+            if (animFrame(i) > 5) {
+                animFrame(i) = 0;
             }
         }
     }
@@ -104,39 +101,42 @@ void envfx_update_flower(Vec3s centerPos) {
 void envfx_set_lava_bubble_position(s32 index, Vec3s centerPos) {
     struct Surface *surface;
     s16 floorY;
+    s32 x, z;
 
     s16 centerX = centerPos[0];
     s16 centerY = centerPos[1];
     s16 centerZ = centerPos[2];
 
-    (gEnvFxBuffer + index)->xPos = random_float() * 6000.0f - 3000.0f + centerX;
-    (gEnvFxBuffer + index)->zPos = random_float() * 6000.0f - 3000.0f + centerZ;
+    x = random_float() * 6000.0f - 3000.0f + centerX;
+    z = random_float() * 6000.0f - 3000.0f + centerZ;
 
-    if ((gEnvFxBuffer + index)->xPos > 8000) {
-        (gEnvFxBuffer + index)->xPos = 16000 - (gEnvFxBuffer + index)->xPos;
+    if (x > 8000) {
+        x = 16000 - x;
     }
-    if ((gEnvFxBuffer + index)->xPos < -8000) {
-        (gEnvFxBuffer + index)->xPos = -16000 - (gEnvFxBuffer + index)->xPos;
+    if (x < -8000) {
+        x = -16000 - x;
     }
 
-    if ((gEnvFxBuffer + index)->zPos > 8000) {
-        (gEnvFxBuffer + index)->zPos = 16000 - (gEnvFxBuffer + index)->zPos;
+    if (z > 8000) {
+        z = 16000 - z;
     }
-    if ((gEnvFxBuffer + index)->zPos < -8000) {
-        (gEnvFxBuffer + index)->zPos = -16000 - (gEnvFxBuffer + index)->zPos;
+    if (z < -8000) {
+        z = -16000 - z;
     }
 
-    floorY =
-        find_floor((gEnvFxBuffer + index)->xPos, centerY + 500, (gEnvFxBuffer + index)->zPos, &surface);
+    xPos(index) = x;
+    zPos(index) = z;
+
+    floorY = find_floor(x, centerY + 500, z, &surface);
     if (surface == NULL) {
-        (gEnvFxBuffer + index)->yPos = FLOOR_LOWER_LIMIT_MISC;
+        yPos(index) = FLOOR_LOWER_LIMIT_MISC;
         return;
     }
 
     if (surface->type == SURFACE_BURNING) {
-        (gEnvFxBuffer + index)->yPos = floorY;
+        yPos(index) = floorY;
     } else {
-        (gEnvFxBuffer + index)->yPos = FLOOR_LOWER_LIMIT_MISC;
+        yPos(index) = FLOOR_LOWER_LIMIT_MISC;
     }
 }
 
@@ -149,14 +149,14 @@ void envfx_update_lava(Vec3s centerPos) {
     s32 globalTimer = gGlobalTimer;
 
     for (i = 0; i < sBubbleParticleMaxCount; i++) {
-        if (!(gEnvFxBuffer + i)->isAlive) {
+        if (!(gParticles.flags[i] & PARTICLE_FLAG_ALIVE)) {
             envfx_set_lava_bubble_position(i, centerPos);
-            (gEnvFxBuffer + i)->isAlive = TRUE;
+            gParticles.flags[i] |= PARTICLE_FLAG_ALIVE;
         } else if (!(globalTimer & 1)) {
-            (gEnvFxBuffer + i)->animFrame += 1;
-            if ((gEnvFxBuffer + i)->animFrame > 8) {
-                (gEnvFxBuffer + i)->isAlive = FALSE;
-                (gEnvFxBuffer + i)->animFrame = 0;
+            animFrame(i) += 1;
+            if (animFrame(i) > 8) {
+                gParticles.flags[i] &= ~PARTICLE_FLAG_ALIVE;
+                animFrame(i) = 0;
             }
         }
     }
@@ -193,11 +193,11 @@ void envfx_rotate_around_whirlpool(s32 *x, s32 *y, s32 *z) {
  * low or close to the center.
  */
 s32 envfx_is_whirlpool_bubble_alive(s32 index) {
-    if ((gEnvFxBuffer + index)->bubbleY < gEnvFxBubbleConfig[ENVFX_STATE_DEST_Y] - 100) {
+    if (bubbleY(index) < gEnvFxBubbleConfig[ENVFX_STATE_DEST_Y] - 100) {
         return FALSE;
     }
 
-    if ((gEnvFxBuffer + index)->angleAndDist[1] < 10) {
+    if (dist(index) < 10) {
         return FALSE;
     }
 
@@ -210,42 +210,26 @@ s32 envfx_is_whirlpool_bubble_alive(s32 index) {
  */
 void envfx_update_whirlpool(void) {
     s32 i;
+    s32 x, y, z;
 
     for (i = 0; i < sBubbleParticleMaxCount; i++) {
-        (gEnvFxBuffer + i)->isAlive = envfx_is_whirlpool_bubble_alive(i);
-        if (!(gEnvFxBuffer + i)->isAlive) {
-            (gEnvFxBuffer + i)->angleAndDist[1] = random_float() * 1000.0f;
-            (gEnvFxBuffer + i)->angleAndDist[0] = random_float() * 65536.0f;
-            (gEnvFxBuffer + i)->xPos =
-                gEnvFxBubbleConfig[ENVFX_STATE_SRC_X]
-                + sins((gEnvFxBuffer + i)->angleAndDist[0]) * (gEnvFxBuffer + i)->angleAndDist[1];
-            (gEnvFxBuffer + i)->zPos =
-                gEnvFxBubbleConfig[ENVFX_STATE_SRC_Z]
-                + coss((gEnvFxBuffer + i)->angleAndDist[0]) * (gEnvFxBuffer + i)->angleAndDist[1];
-            (gEnvFxBuffer + i)->bubbleY =
-                gEnvFxBubbleConfig[ENVFX_STATE_SRC_Y] + (random_float() * 100.0f - 50.0f);
-            (gEnvFxBuffer + i)->yPos = (i + gEnvFxBuffer)->bubbleY;
-            (gEnvFxBuffer + i)->unusedBubbleVar = 0;
-            (gEnvFxBuffer + i)->isAlive = TRUE;
-
-            envfx_rotate_around_whirlpool(&(gEnvFxBuffer + i)->xPos, &(gEnvFxBuffer + i)->yPos,
-                                          &(gEnvFxBuffer + i)->zPos);
+        if (!envfx_is_whirlpool_bubble_alive(i)) {
+            dist(i) = random_float() * 1000.0f;
+            angle(i) = random_float() * 65536.0f;
+            bubbleY(i) = gEnvFxBubbleConfig[ENVFX_STATE_SRC_Y] + (random_float() * 100.0f - 50.0f);
         } else {
-            (gEnvFxBuffer + i)->angleAndDist[1] -= 40;
-            (gEnvFxBuffer + i)->angleAndDist[0] +=
-                (s16)(3000 - (gEnvFxBuffer + i)->angleAndDist[1] * 2) + 0x400;
-            (gEnvFxBuffer + i)->xPos =
-                gEnvFxBubbleConfig[ENVFX_STATE_SRC_X]
-                + sins((gEnvFxBuffer + i)->angleAndDist[0]) * (gEnvFxBuffer + i)->angleAndDist[1];
-            (gEnvFxBuffer + i)->zPos =
-                gEnvFxBubbleConfig[ENVFX_STATE_SRC_Z]
-                + coss((gEnvFxBuffer + i)->angleAndDist[0]) * (gEnvFxBuffer + i)->angleAndDist[1];
-            (gEnvFxBuffer + i)->bubbleY -= 40 - ((s16)(gEnvFxBuffer + i)->angleAndDist[1] / 100);
-            (gEnvFxBuffer + i)->yPos = (i + gEnvFxBuffer)->bubbleY;
-
-            envfx_rotate_around_whirlpool(&(gEnvFxBuffer + i)->xPos, &(gEnvFxBuffer + i)->yPos,
-                                          &(gEnvFxBuffer + i)->zPos);
+            dist(i) -= 40;
+            angle(i) += (s16)(3000 - dist(i) * 2) + 0x400;
+            bubbleY(i) -= 40 - ((s16) dist(i) / 100);
         }
+
+        x = gEnvFxBubbleConfig[ENVFX_STATE_SRC_X] + sins(angle(i)) * dist(i);
+        y = bubbleY(i);
+        z = gEnvFxBubbleConfig[ENVFX_STATE_SRC_Z] + coss(angle(i)) * dist(i);
+        envfx_rotate_around_whirlpool(&x, &y, &z);
+        xPos(i) = x;
+        yPos(i) = y;
+        zPos(i) = z;
     }
 }
 
@@ -256,7 +240,7 @@ void envfx_update_whirlpool(void) {
 s32 envfx_is_jestream_bubble_alive(s32 index) {
     if (!particle_is_laterally_close(index, gEnvFxBubbleConfig[ENVFX_STATE_SRC_X],
                                      gEnvFxBubbleConfig[ENVFX_STATE_SRC_Z], 1000)
-        || gEnvFxBubbleConfig[ENVFX_STATE_SRC_Y] + 1500 < (gEnvFxBuffer + index)->yPos) {
+        || gEnvFxBubbleConfig[ENVFX_STATE_SRC_Y] + 1500 < yPos(index)) {
         return FALSE;
     }
 
@@ -271,33 +255,28 @@ void envfx_update_jetstream(void) {
     s32 i;
 
     for (i = 0; i < sBubbleParticleMaxCount; i++) {
-        (gEnvFxBuffer + i)->isAlive = envfx_is_jestream_bubble_alive(i);
-        if (!(gEnvFxBuffer + i)->isAlive) {
-            (gEnvFxBuffer + i)->angleAndDist[1] = random_float() * 300.0f;
-            (gEnvFxBuffer + i)->angleAndDist[0] = random_u16();
-            (gEnvFxBuffer + i)->xPos =
-                gEnvFxBubbleConfig[ENVFX_STATE_SRC_X]
-                + sins((gEnvFxBuffer + i)->angleAndDist[0]) * (gEnvFxBuffer + i)->angleAndDist[1];
-            (gEnvFxBuffer + i)->zPos =
-                gEnvFxBubbleConfig[ENVFX_STATE_SRC_Z]
-                + coss((gEnvFxBuffer + i)->angleAndDist[0]) * (gEnvFxBuffer + i)->angleAndDist[1];
-            (gEnvFxBuffer + i)->yPos =
-                gEnvFxBubbleConfig[ENVFX_STATE_SRC_Y] + (random_float() * 400.0f - 200.0f);
+        if (!envfx_is_jestream_bubble_alive(i)) {
+            dist(i) = random_float() * 300.0f;
+            angle(i) = random_u16();
+            xPos(i) = gEnvFxBubbleConfig[ENVFX_STATE_SRC_X] + sins(angle(i)) * dist(i);
+            zPos(i) = gEnvFxBubbleConfig[ENVFX_STATE_SRC_Z] + coss(angle(i)) * dist(i);
+            yPos(i) = gEnvFxBubbleConfig[ENVFX_STATE_SRC_Y] + (random_float() * 400.0f - 200.0f);
         } else {
-            (gEnvFxBuffer + i)->angleAndDist[1] += 10;
-            (gEnvFxBuffer + i)->xPos += sins((gEnvFxBuffer + i)->angleAndDist[0]) * 10.0f;
-            (gEnvFxBuffer + i)->zPos += coss((gEnvFxBuffer + i)->angleAndDist[0]) * 10.0f;
-            (gEnvFxBuffer + i)->yPos -= ((gEnvFxBuffer + i)->angleAndDist[1] / 30) - 50;
+            dist(i) += 10;
+            xPos(i) += sins(angle(i)) * 10.0f;
+            zPos(i) += coss(angle(i)) * 10.0f;
+            yPos(i) -= (dist(i) / 30) - 50;
         }
     }
 }
 
 /**
- * Initialize bubble (or flower) effect by allocating a buffer to store
- * the state of each particle and setting the initial and max count.
+ * Initialize bubble (or flower) effect by clearing the particle slots
+ * and setting the initial and max count.
  * Analogous to init_snow_particles, but for bubbles.
  */
 s32 envfx_init_bubble(s32 mode) {
+    s32 material;
     s32 i;
 
     switch (mode) {
@@ -307,35 +286,44 @@ s32 envfx_init_bubble(s32 mode) {
         case ENVFX_FLOWERS:
             sBubbleParticleCount = 30;
             sBubbleParticleMaxCount = 30;
+            material = PARTICLE_MAT_FLOWER;
             break;
 
         case ENVFX_LAVA_BUBBLES:
             sBubbleParticleCount = 15;
             sBubbleParticleMaxCount = 15;
+            material = PARTICLE_MAT_LAVA_BUBBLE;
             break;
 
         case ENVFX_WHIRLPOOL_BUBBLES:
-            sBubbleParticleCount = 60;
-            break;
-
         case ENVFX_JETSTREAM_BUBBLES:
             sBubbleParticleCount = 60;
+            material = PARTICLE_MAT_BUBBLE;
             break;
-    }
 
-    gEnvFxBuffer = mem_pool_alloc(gEffectsMemoryPool,
-                                  sBubbleParticleCount * sizeof(struct EnvFxParticle));
-    if (gEnvFxBuffer == NULL) {
-        return FALSE;
+        default:
+            return FALSE;
     }
 
-    bzero(gEnvFxBuffer, sBubbleParticleCount * sizeof(struct EnvFxParticle));
+    for (i = 0; i < sBubbleParticleCount; i++) {
+        xPos(i) = 0.0f;
+        yPos(i) = 0.0f;
+        zPos(i) = 0.0f;
+        angle(i) = 0;
+        dist(i) = 0;
+        bubbleY(i) = 0;
+        gParticles.size[i] = 1.0f;
+        gParticles.material[i] = material;
+        gParticles.frame[i] = 0;
+        gParticles.alpha[i] = 255;
+        gParticles.flags[i] = 0;
+    }
     bzero(gEnvFxBubbleConfig, sizeof(gEnvFxBubbleConfig));
 
     switch (mode) {
         case ENVFX_LAVA_BUBBLES:
             for (i = 0; i < sBubbleParticleCount; i++) {
-                (gEnvFxBuffer + i)->animFrame = random_float() * 7.0f;
+                animFrame(i) = random_float() * 7.0f;
             }
             break;
     }
@@ -344,153 +332,6 @@ s32 envfx_init_bubble(s32 mode) {
     return TRUE;
 }
 
-/**
- * Update particles depending on mode.
- * Also sets the given vertices to the correct shape for each mode,
- * though they are not being rotated yet.
- */
-void envfx_bubbles_update_switch(s32 mode, Vec3s camTo, Vec3s vertex1, Vec3s vertex2, Vec3s vertex3) {
-    switch (mode) {
-        case ENVFX_FLOWERS:
-            envfx_update_flower(camTo);
-            vertex1[0] = 50;  vertex1[1] = 0;  vertex1[2] = 0;
-            vertex2[0] = 0;   vertex2[1] = 75; vertex2[2] = 0;
-            vertex3[0] = -50; vertex3[1] = 0;  vertex3[2] = 0;
-            break;
-
-        case ENVFX_LAVA_BUBBLES:
-            envfx_update_lava(camTo);
-            vertex1[0] = 100;  vertex1[1] = 0;   vertex1[2] = 0;
-            vertex2[0] = 0;    vertex2[1] = 150; vertex2[2] = 0;
-            vertex3[0] = -100; vertex3[1] = 0;   vertex3[2] = 0;
-            break;
-
-        case ENVFX_WHIRLPOOL_BUBBLES:
-            envfx_update_whirlpool();
-            vertex1[0] = 40;  vertex1[1] = 0;  vertex1[2] = 0;
-            vertex2[0] = 0;   vertex2[1] = 60; vertex2[2] = 0;
-            vertex3[0] = -40; vertex3[1] = 0;  vertex3[2] = 0;
-            break;
-
-        case ENVFX_JETSTREAM_BUBBLES:
-            envfx_update_jetstream();
-            vertex1[0] = 40;  vertex1[1] = 0;  vertex1[2] = 0;
-            vertex2[0] = 0;   vertex2[1] = 60; vertex2[2] = 0;
-            vertex3[0] = -40; vertex3[1] = 0;  vertex3[2] = 0;
-            break;
-    }
-}
-
-/**
- * Append 15 vertices to 'gfx', which is enough for 5 bubbles starting at
- * 'index'. The 3 input vertices represent the rotated triangle around (0,0,0)
- * that will be translated to bubble positions to draw the bubble image
- */
-void append_bubble_vertex_buffer(Gfx *gfx, s32 index, Vec3s vertex1, Vec3s vertex2, Vec3s vertex3,
-                                 Vtx *template) {
-    s32 i = 0;
-    Vtx *vertBuf = alloc_display_list(15 * sizeof(Vtx));
-
-    if (vertBuf == NULL) {
-        return;
-    }
-
-    for (i = 0; i < 15; i += 3) {
-        vertBuf[i] = template[0];
-        (vertBuf + i)->v.ob[0] = (gEnvFxBuffer + (index + i / 3))->xPos + vertex1[0];
-        (vertBuf + i)->v.ob[1] = (gEnvFxBuffer + (index + i / 3))->yPos + vertex1[1];
-        (vertBuf + i)->v.ob[2] = (gEnvFxBuffer + (index + i / 3))->zPos + vertex1[2];
-
-        vertBuf[i + 1] = template[1];
-        (vertBuf + i + 1)->v.ob[0] = (gEnvFxBuffer + (index + i / 3))->xPos + vertex2[0];
-        (vertBuf + i + 1)->v.ob[1] = (gEnvFxBuffer + (index + i / 3))->yPos + vertex2[1];
-        (vertBuf + i + 1)->v.ob[2] = (gEnvFxBuffer + (index + i / 3))->zPos + vertex2[2];
-
-        vertBuf[i + 2] = template[2];
-        (vertBuf + i + 2)->v.ob[0] = (gEnvFxBuffer + (index + i / 3))->xPos + vertex3[0];
-        (vertBuf + i + 2)->v.ob[1] = (gEnvFxBuffer + (index + i / 3))->yPos + vertex3[1];
-        (vertBuf + i + 2)->v.ob[2] = (gEnvFxBuffer + (index + i / 3))->zPos + vertex3[2];
-    }
-
-    gSPVertex(gfx, VIRTUAL_TO_PHYSICAL(vertBuf), 15, 0);
-}
-
-/**
- * Appends to the enfvx display list a command setting the appropriate texture
- * for a specific particle. The display list is not passed as parameter but uses
- * the global sGfxCursor instead.
- */
-void envfx_set_bubble_texture(s32 mode, s16 index) {
-    void **imageArr;
-    s16 frame = (gEnvFxBuffer + index)->animFrame;
-
-    switch (mode) {
-        case ENVFX_FLOWERS:
-            imageArr = segmented_to_virtual(&flower_bubbles_textures_ptr_0B002008);
-            frame = (gEnvFxBuffer + index)->animFrame;
-            break;
-
-        case ENVFX_LAVA_BUBBLES:
-            imageArr = segmented_to_virtual(&lava_bubble_ptr_0B006020);
-            frame = (gEnvFxBuffer + index)->animFrame;
-            break;
-
-        case ENVFX_WHIRLPOOL_BUBBLES:
-        case ENVFX_JETSTREAM_BUBBLES:
-            imageArr = segmented_to_virtual(&bubble_ptr_0B006848);
-            frame = 0;
-            break;
-        default:
-            return;
-    }
-
-    gDPSetTextureImage(sGfxCursor++, G_IM_FMT_RGBA, G_IM_SIZ_16b, 1, *(imageArr + frame));
-    gSPDisplayList(sGfxCursor++, &tiny_bubble_dl_0B006D68);
-}
-
-/**
- * Updates the bubble particle positions, then generates and returns a display
- * list drawing them.
- */
-Gfx *envfx_update_bubble_particles(s32 mode, UNUSED Vec3s marioPos, Vec3s camFrom, Vec3s camTo) {
-    s32 i;
-    s16 radius, pitch, yaw;
-
-    Vec3s vertex1;
-    Vec3s vertex2;
-    Vec3s vertex3;
-
-    Gfx *gfxStart = alloc_display_list(((sBubbleParticleMaxCount / 5) * 10 + sBubbleParticleMaxCount + 3)
-                                       * sizeof(Gfx));
-    if (gfxStart == NULL) {
-        return NULL;
-    }
-
-    sGfxCursor = gfxStart;
-
-    orbit_from_positions(camTo, camFrom, &radius, &pitch, &yaw);
-    envfx_bubbles_update_switch(mode, camTo, vertex1, vertex2, vertex3);
-    rotate_triangle_vertices(vertex1, vertex2, vertex3, pitch, yaw);
-
-    gSPDisplayList(sGfxCursor++, &tiny_bubble_dl_0B006D38);
-
-    for (i = 0; i < sBubbleParticleMaxCount; i += 5) {
-        gDPPipeSync(sGfxCursor++);
-        envfx_set_bubble_texture(mode, i);
-        append_bubble_vertex_buffer(sGfxCursor++, i, vertex1, vertex2, vertex3, (Vtx *) gBubbleTempVtx);
-        gSP1Triangle(sGfxCursor++, 0, 1, 2, 0);
-        gSP1Triangle(sGfxCursor++, 3, 4, 5, 0);
-        gSP1Triangle(sGfxCursor++, 6, 7, 8, 0);
-        gSP1Triangle(sGfxCursor++, 9, 10, 11, 0);
-        gSP1Triangle(sGfxCursor++, 12, 13, 14, 0);
-    }
-
-    gSPDisplayList(sGfxCursor++, &tiny_bubble_dl_0B006AB0);
-    gSPEndDisplayList(sGfxCursor++);
-
-    return gfxStart;
-}
-
 /**
  * Set the maximum particle count from the gEnvFxBubbleConfig variable,
  * which is set by the whirlpool or jet stream behavior.
@@ -509,41 +350,41 @@ void envfx_set_max_bubble_particles(s32 mode) {
 /**
  * Update bubble-like environment effects. Assumes the mode is larger than 10,
  * lower modes are snow effects which are updated in a different function.
- * Returns a display list drawing the particles.
+ * The particles are drawn by particles_render.
  */
-Gfx *envfx_update_bubbles(s32 mode, Vec3s marioPos, Vec3s camTo, Vec3s camFrom) {
-    Gfx *gfx;
-
+void envfx_update_bubbles(s32 mode, UNUSED Vec3s marioPos, Vec3s camTo, UNUSED Vec3s camFrom) {
     if (gEnvFxMode == ENVFX_MODE_NONE && !envfx_init_bubble(mode)) {
-        return NULL;
+        return;
     }
 
     envfx_set_max_bubble_particles(mode);
 
+    // Whirlpools and jet streams only have as many slots as envfx_init_bubble cleared
+    sBubbleParticleMaxCount = MIN(sBubbleParticleMaxCount, sBubbleParticleCount);
     if (sBubbleParticleMaxCount == 0) {
-        return NULL;
+        return;
     }
 
     switch (mode) {
         case ENVFX_FLOWERS:
-            gfx = envfx_update_bubble_particles(ENVFX_FLOWERS, marioPos, camFrom, camTo);
+            envfx_update_flower(camTo);
             break;
 
         case ENVFX_LAVA_BUBBLES:
-            gfx = envfx_update_bubble_particles(ENVFX_LAVA_BUBBLES, marioPos, camFrom, camTo);
+            envfx_update_lava(camTo);
             break;
 
         case ENVFX_WHIRLPOOL_BUBBLES:
-            gfx = envfx_update_bubble_particles(ENVFX_WHIRLPOOL_BUBBLES, marioPos, camFrom, camTo);
+            envfx_update_whirlpool();
             break;
 
         case ENVFX_JETSTREAM_BUBBLES:
-            gfx = envfx_update_bubble_particles(ENVFX_JETSTREAM_BUBBLES, marioPos, camFrom, camTo);
+            envfx_update_jetstream();
             break;
 
         default:
-            return NULL;
+            return;
     }
 
-    return gfx;
+    gParticles.numEnvFx = sBubbleParticleMaxCount;
 }
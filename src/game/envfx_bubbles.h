@@ -2,7 +2,7 @@
 #define ENVFX_BUBBLES_H
 
 #include <PR/ultratypes.h>
-#include <PR/gbi.h>
+#include "types.h"
 
 enum EnvfxBubblesState {
     ENVFX_STATE_UNUSED,
@@ -22,6 +22,6 @@ enum EnvfxBubblesState {
 
 // Used to communicate from whirlpool behavior to envfx
 extern s16 gEnvFxBubbleConfig[10];
-Gfx *envfx_update_bubbles(s32 mode, Vec3s marioPos, Vec3s camTo, Vec3s camFrom);
+void envfx_update_bubbles(s32 mode, Vec3s marioPos, Vec3s camTo, Vec3s camFrom);
 
 #endif // ENVFX_BUBBLES_H
@@ -3,7 +3,6 @@
 #include "sm64.h"
 #include "dialog_ids.h"
 #include "game_init.h"
-#include "memory.h"
 #include "ingame_menu.h"
 #include "envfx_snow.h"
 #include "envfx_bubbles.h"
@@ -13,12 +12,14 @@
 #include "audio/external.h"
 #include "obj_behaviors.h"
 #include "level_geo.h"
+#include "particle_system.h"
 
 /**
  * This file contains the function that handles 'environment effects',
  * which are particle effects related to the level type that, unlike
- * object-based particle effects, are rendered more efficiently by manually
- * generating display lists instead of drawing each particle separately.
+ * object-based particle effects, live in the environment effect slots of
+ * the particle pool (see particle_system.c) which draws them as a few
+ * batched display lists instead of drawing each particle separately.
  * This file implements snow effects, while in 'envfx_bubbles.c' the
  * implementation for flowers (unused), lava bubbles and jet stream bubbles
  * can be found.
@@ -26,14 +27,6 @@
  * called from geo_envfx_main in level_geo.c
  */
 
-// Might be duplicate
-struct SnowFlakeVertex {
-    s16 x;
-    s16 y;
-    s16 z;
-};
-
-struct EnvFxParticle *gEnvFxBuffer;
 Vec3i gSnowCylinderLastPos;
 s16 gSnowParticleCount;
 s16 gSnowParticleMaxCount;
@@ -41,25 +34,12 @@ s16 gSnowParticleMaxCount;
 /* DATA */
 s8 gEnvFxMode = ENVFX_MODE_NONE;
 
-/// Template for a snow particle triangle
-Vtx gSnowTempVtx[3] = { { { { -5, 5, 0 }, 0, { 0, 0 }, { 0x7F, 0x7F, 0x7F, 0xFF } } },
-                        { { { -5, -5, 0 }, 0, { 0, 960 }, { 0x7F, 0x7F, 0x7F, 0xFF } } },
-                        { { { 5, 5, 0 }, 0, { 960, 0 }, { 0x7F, 0x7F, 0x7F, 0xFF } } } };
-
-// Change these to make snowflakes smaller or bigger
-struct SnowFlakeVertex gSnowFlakeVertex1 = { -5, 5, 0 };
-struct SnowFlakeVertex gSnowFlakeVertex2 = { -5, -5, 0 };
-struct SnowFlakeVertex gSnowFlakeVertex3 = { 5, 5, 0 };
-
-extern void *tiny_bubble_dl_0B006AB0;
-extern void *tiny_bubble_dl_0B006A50;
-extern void *tiny_bubble_dl_0B006CD8;
-
 /**
- * Initialize snow particles by allocating a buffer for storing their state
- * and setting a start amount.
+ * Initialize snow particles by clearing their slots and setting a start amount.
  */
 s32 envfx_init_snow(s32 mode) {
+    s32 i;
+
     switch (mode) {
         case ENVFX_MODE_NONE:
             return FALSE;
@@ -80,14 +60,17 @@ s32 envfx_init_snow(s32 mode) {
             break;
     }
 
-    gEnvFxBuffer = mem_pool_alloc(gEffectsMemoryPool,
-                                  gSnowParticleMaxCount * sizeof(struct EnvFxParticle));
-    if (gEnvFxBuffer == NULL) {
-        return FALSE;
+    for (i = 0; i < gSnowParticleMaxCount; i++) {
+        gParticles.posX[i] = 0.0f;
+        gParticles.posY[i] = 0.0f;
+        gParticles.posZ[i] = 0.0f;
+        gParticles.size[i] = 1.0f;
+        gParticles.material[i] = (mode == ENVFX_SNOW_WATER) ? PARTICLE_MAT_SNOW_WATER : PARTICLE_MAT_SNOW;
+        gParticles.frame[i] = 0;
+        gParticles.alpha[i] = 255;
+        gParticles.flags[i] = 0;
     }
 
-    bzero(gEnvFxBuffer, gSnowParticleMaxCount * sizeof(struct EnvFxParticle));
-
     gEnvFxMode = mode;
     return TRUE;
 }
@@ -133,16 +116,11 @@ void envfx_update_snowflake_count(s32 mode, Vec3s marioPos) {
 }
 
 /**
- * Deallocate the buffer storing snow particles and set the environment effect
- * to none.
+ * Stop drawing the environment effect and set it to none.
  */
-void envfx_cleanup_snow(void *snowParticleArray) {
-    if (gEnvFxMode != ENVFX_MODE_NONE) {
-        if (snowParticleArray) {
-            mem_pool_free(gEffectsMemoryPool, snowParticleArray);
-        }
-        gEnvFxMode = ENVFX_MODE_NONE;
-    }
+void envfx_cleanup(void) {
+    gParticles.numEnvFx = 0;
+    gEnvFxMode = ENVFX_MODE_NONE;
 }
 
 /**
@@ -175,9 +153,9 @@ void pos_from_orbit(Vec3s origin, Vec3s result, s16 radius, s16 pitch, s16 yaw)
  * x, y and z.
  */
 s32 envfx_is_snowflake_alive(s32 index, s32 snowCylinderX, s32 snowCylinderY, s32 snowCylinderZ) {
-    s32 x = (gEnvFxBuffer + index)->xPos;
-    s32 y = (gEnvFxBuffer + index)->yPos;
-    s32 z = (gEnvFxBuffer + index)->zPos;
+    s32 x = gParticles.posX[index];
+    s32 y = gParticles.posY[index];
+    s32 z = gParticles.posZ[index];
 
     if (sqr(x - snowCylinderX) + sqr(z - snowCylinderZ) > sqr(300)) {
         return FALSE;
@@ -211,19 +189,14 @@ void envfx_update_snow_normal(s32 snowCylinderX, s32 snowCylinderY, s32 snowCyli
     s32 deltaZ = snowCylinderZ - gSnowCylinderLastPos[2];
 
     for (i = 0; i < gSnowParticleCount; i++) {
-        (gEnvFxBuffer + i)->isAlive =
-            envfx_is_snowflake_alive(i, snowCylinderX, snowCylinderY, snowCylinderZ);
-        if (!(gEnvFxBuffer + i)->isAlive) {
-            (gEnvFxBuffer + i)->xPos =
-                400.0f * random_float() - 200.0f + snowCylinderX + (s16)(deltaX * 2);
-            (gEnvFxBuffer + i)->zPos =
-                400.0f * random_float() - 200.0f + snowCylinderZ + (s16)(deltaZ * 2);
-            (gEnvFxBuffer + i)->yPos = 200.0f * random_float() + snowCylinderY;
-            (gEnvFxBuffer + i)->isAlive = TRUE;
+        if (!envfx_is_snowflake_alive(i, snowCylinderX, snowCylinderY, snowCylinderZ)) {
+            gParticles.posX[i] = 400.0f * random_float() - 200.0f + snowCylinderX + (s16)(deltaX * 2);
+            gParticles.posZ[i] = 400.0f * random_float() - 200.0f + snowCylinderZ + (s16)(deltaZ * 2);
+            gParticles.posY[i] = 200.0f * random_float() + snowCylinderY;
         } else {
-            (gEnvFxBuffer + i)->xPos += random_float() * 2 - 1.0f + (s16)(deltaX / 1.2);
-            (gEnvFxBuffer + i)->yPos -= 2 -(s16)(deltaY * 0.8);
-            (gEnvFxBuffer + i)->zPos += random_float() * 2 - 1.0f + (s16)(deltaZ / 1.2);
+            gParticles.posX[i] += random_float() * 2 - 1.0f + (s16)(deltaX / 1.2);
+            gParticles.posY[i] -= 2 -(s16)(deltaY * 0.8);
+            gParticles.posZ[i] += random_float() * 2 - 1.0f + (s16)(deltaZ / 1.2);
         }
     }
 
@@ -245,19 +218,14 @@ void envfx_update_snow_blizzard(s32 snowCylinderX, s32 snowCylinderY, s32 snowCy
     s32 deltaZ = snowCylinderZ - gSnowCylinderLastPos[2];
 
     for (i = 0; i < gSnowParticleCount; i++) {
-        (gEnvFxBuffer + i)->isAlive =
-            envfx_is_snowflake_alive(i, snowCylinderX, snowCylinderY, snowCylinderZ);
-        if (!(gEnvFxBuffer + i)->isAlive) {
-            (gEnvFxBuffer + i)->xPos =
-                400.0f * random_float() - 200.0f + snowCylinderX + (s16)(deltaX * 2);
-            (gEnvFxBuffer + i)->zPos =
-                400.0f * random_float() - 200.0f + snowCylinderZ + (s16)(deltaZ * 2);
-            (gEnvFxBuffer + i)->yPos = 400.0f * random_float() - 200.0f + snowCylinderY;
-            (gEnvFxBuffer + i)->isAlive = TRUE;
+        if (!envfx_is_snowflake_alive(i, snowCylinderX, snowCylinderY, snowCylinderZ)) {
+            gParticles.posX[i] = 400.0f * random_float() - 200.0f + snowCylinderX + (s16)(deltaX * 2);
+            gParticles.posZ[i] = 400.0f * random_float() - 200.0f + snowCylinderZ + (s16)(deltaZ * 2);
+            gParticles.posY[i] = 400.0f * random_float() - 200.0f + snowCylinderY;
         } else {
-            (gEnvFxBuffer + i)->xPos += random_float() * 2 - 1.0f + (s16)(deltaX / 1.2) + 20.0f;
-            (gEnvFxBuffer + i)->yPos -= 5 -(s16)(deltaY * 0.8);
-            (gEnvFxBuffer + i)->zPos += random_float() * 2 - 1.0f + (s16)(deltaZ / 1.2);
+            gParticles.posX[i] += random_float() * 2 - 1.0f + (s16)(deltaX / 1.2) + 20.0f;
+            gParticles.posY[i] -= 5 -(s16)(deltaY * 0.8);
+            gParticles.posZ[i] += random_float() * 2 - 1.0f + (s16)(deltaZ / 1.2);
         }
     }
 
@@ -290,110 +258,20 @@ void envfx_update_snow_water(s32 snowCylinderX, s32 snowCylinderY, s32 snowCylin
     s32 i;
 
     for (i = 0; i < gSnowParticleCount; i++) {
-        (gEnvFxBuffer + i)->isAlive =
-            envfx_is_snowflake_alive(i, snowCylinderX, snowCylinderY, snowCylinderZ);
-        if (!(gEnvFxBuffer + i)->isAlive) {
-            (gEnvFxBuffer + i)->xPos = 400.0f * random_float() - 200.0f + snowCylinderX;
-            (gEnvFxBuffer + i)->zPos = 400.0f * random_float() - 200.0f + snowCylinderZ;
-            (gEnvFxBuffer + i)->yPos = 400.0f * random_float() - 200.0f + snowCylinderY;
-            (gEnvFxBuffer + i)->isAlive = TRUE;
+        if (!envfx_is_snowflake_alive(i, snowCylinderX, snowCylinderY, snowCylinderZ)) {
+            gParticles.posX[i] = 400.0f * random_float() - 200.0f + snowCylinderX;
+            gParticles.posZ[i] = 400.0f * random_float() - 200.0f + snowCylinderZ;
+            gParticles.posY[i] = 400.0f * random_float() - 200.0f + snowCylinderY;
         }
     }
 }
 
 /**
- * Rotates the input vertices according to the give pitch and yaw. This
- * is needed for billboarding of particles.
- */
-void rotate_triangle_vertices(Vec3s vertex1, Vec3s vertex2, Vec3s vertex3, s16 pitch, s16 yaw) {
-    f32 cosPitch = coss(pitch);
-    f32 sinPitch = sins(pitch);
-    f32 cosMYaw = coss(-yaw);
-    f32 sinMYaw = sins(-yaw);
-
-    Vec3f v1, v2, v3;
-
-    v1[0] = vertex1[0];
-    v1[1] = vertex1[1];
-    v1[2] = vertex1[2];
-
-    v2[0] = vertex2[0];
-    v2[1] = vertex2[1];
-    v2[2] = vertex2[2];
-
-    v3[0] = vertex3[0];
-    v3[1] = vertex3[1];
-    v3[2] = vertex3[2];
-
-    vertex1[0] = v1[0] * cosMYaw + v1[1] * (sinPitch * sinMYaw) + v1[2] * (-sinMYaw * cosPitch);
-    vertex1[1] = v1[1] * cosPitch + v1[2] * sinPitch;
-    vertex1[2] = v1[0] * sinMYaw + v1[1] * (-sinPitch * cosMYaw) + v1[2] * (cosPitch * cosMYaw);
-
-    vertex2[0] = v2[0] * cosMYaw + v2[1] * (sinPitch * sinMYaw) + v2[2] * (-sinMYaw * cosPitch);
-    vertex2[1] = v2[1] * cosPitch + v2[2] * sinPitch;
-    vertex2[2] = v2[0] * sinMYaw + v2[1] * (-sinPitch * cosMYaw) + v2[2] * (cosPitch * cosMYaw);
-
-    vertex3[0] = v3[0] * cosMYaw + v3[1] * (sinPitch * sinMYaw) + v3[2] * (-sinMYaw * cosPitch);
-    vertex3[1] = v3[1] * cosPitch + v3[2] * sinPitch;
-    vertex3[2] = v3[0] * sinMYaw + v3[1] * (-sinPitch * cosMYaw) + v3[2] * (cosPitch * cosMYaw);
-}
-
-/**
- * Append 15 vertices to 'gfx', which is enough for 5 snowflakes starting at
- * 'index' in the buffer. The 3 input vertices represent the rotated triangle
- * around (0,0,0) that will be translated to snowflake positions to draw the
- * snowflake image.
- */
-void append_snowflake_vertex_buffer(Gfx *gfx, s32 index, Vec3s vertex1, Vec3s vertex2, Vec3s vertex3) {
-    s32 i = 0;
-    Vtx *vertBuf = (Vtx *) alloc_display_list(15 * sizeof(Vtx));
-
-    if (vertBuf == NULL) {
-        return;
-    }
-
-    for (i = 0; i < 15; i += 3) {
-        vertBuf[i] = gSnowTempVtx[0];
-        (vertBuf + i)->v.ob[0] = (gEnvFxBuffer + (index + i / 3))->xPos + vertex1[0];
-        (vertBuf + i)->v.ob[1] = (gEnvFxBuffer + (index + i / 3))->yPos + vertex1[1];
-        (vertBuf + i)->v.ob[2] = (gEnvFxBuffer + (index + i / 3))->zPos + vertex1[2];
-
-        vertBuf[i + 1] = gSnowTempVtx[1];
-        (vertBuf + i + 1)->v.ob[0] = (gEnvFxBuffer + (index + i / 3))->xPos + vertex2[0];
-        (vertBuf + i + 1)->v.ob[1] = (gEnvFxBuffer + (index + i / 3))->yPos + vertex2[1];
-        (vertBuf + i + 1)->v.ob[2] = (gEnvFxBuffer + (index + i / 3))->zPos + vertex2[2];
-
-        vertBuf[i + 2] = gSnowTempVtx[2];
-        (vertBuf + i + 2)->v.ob[0] = (gEnvFxBuffer + (index + i / 3))->xPos + vertex3[0];
-        (vertBuf + i + 2)->v.ob[1] = (gEnvFxBuffer + (index + i / 3))->yPos + vertex3[1];
-        (vertBuf + i + 2)->v.ob[2] = (gEnvFxBuffer + (index + i / 3))->zPos + vertex3[2];
-    }
-
-    gSPVertex(gfx, VIRTUAL_TO_PHYSICAL(vertBuf), 15, 0);
-}
-
-/**
- * Updates positions of snow particles and returns a pointer to a display list
- * drawing all snowflakes.
+ * Updates positions of snow particles. They are drawn by particles_render.
  */
-Gfx *envfx_update_snow(s32 snowMode, Vec3s marioPos, Vec3s camFrom, Vec3s camTo) {
-    s32 i;
+void envfx_update_snow(s32 snowMode, Vec3s marioPos, Vec3s camFrom, Vec3s camTo) {
     s16 radius, pitch, yaw;
     Vec3s snowCylinderPos;
-    struct SnowFlakeVertex vertex1, vertex2, vertex3;
-    Gfx *gfxStart;
-    Gfx *gfx;
-
-    vertex1 = gSnowFlakeVertex1;
-    vertex2 = gSnowFlakeVertex2;
-    vertex3 = gSnowFlakeVertex3;
-
-    gfxStart = (Gfx *) alloc_display_list((gSnowParticleCount * 6 + 3) * sizeof(Gfx));
-    gfx = gfxStart;
-
-    if (gfxStart == NULL) {
-        return NULL;
-    }
 
     envfx_update_snowflake_count(snowMode, marioPos);
 
@@ -436,38 +314,16 @@ Gfx *envfx_update_snow(s32 snowMode, Vec3s marioPos, Vec3s camFrom, Vec3s camTo)
             break;
     }
 
-    rotate_triangle_vertices((s16 *) &vertex1, (s16 *) &vertex2, (s16 *) &vertex3, pitch, yaw);
-
-    if (snowMode == ENVFX_SNOW_NORMAL || snowMode == ENVFX_SNOW_BLIZZARD) {
-        gSPDisplayList(gfx++, &tiny_bubble_dl_0B006A50); // snowflake with gray edge
-    } else if (snowMode == ENVFX_SNOW_WATER) {
-        gSPDisplayList(gfx++, &tiny_bubble_dl_0B006CD8); // snowflake with blue edge
-    }
-
-    for (i = 0; i < gSnowParticleCount; i += 5) {
-        append_snowflake_vertex_buffer(gfx++, i, (s16 *) &vertex1, (s16 *) &vertex2, (s16 *) &vertex3);
-
-        gSP1Triangle(gfx++, 0, 1, 2, 0);
-        gSP1Triangle(gfx++, 3, 4, 5, 0);
-        gSP1Triangle(gfx++, 6, 7, 8, 0);
-        gSP1Triangle(gfx++, 9, 10, 11, 0);
-        gSP1Triangle(gfx++, 12, 13, 14, 0);
-    }
-
-    gSPDisplayList(gfx++, &tiny_bubble_dl_0B006AB0) gSPEndDisplayList(gfx++);
-
-    return gfxStart;
+    gParticles.numEnvFx = gSnowParticleCount;
 }
 
 /**
- * Updates the environment effects (snow, flowers, bubbles)
- * and returns a display list drawing them.
+ * Updates the environment effects (snow, flowers, bubbles). The particles
+ * are drawn with the rest of the particle pool.
  */
-Gfx *envfx_update_particles(s32 mode, Vec3s marioPos, Vec3s camTo, Vec3s camFrom) {
-    Gfx *gfx;
-
+void envfx_update_particles(s32 mode, Vec3s marioPos, Vec3s camTo, Vec3s camFrom) {
     if (get_dialog_id() != DIALOG_NONE) {
-        return NULL;
+        return;
     }
 
     if (gEnvFxMode != ENVFX_MODE_NONE && gEnvFxMode != mode) {
@@ -475,34 +331,23 @@ Gfx *envfx_update_particles(s32 mode, Vec3s marioPos, Vec3s camTo, Vec3s camFrom
     }
 
     if (mode >= ENVFX_BUBBLE_START) {
-        gfx = envfx_update_bubbles(mode, marioPos, camTo, camFrom);
-        return gfx;
+        envfx_update_bubbles(mode, marioPos, camTo, camFrom);
+        return;
     }
 
     if (gEnvFxMode == ENVFX_MODE_NONE && !envfx_init_snow(mode)) {
-        return NULL;
+        return;
     }
 
     switch (mode) {
         case ENVFX_MODE_NONE:
-            envfx_cleanup_snow(gEnvFxBuffer);
-            return NULL;
-
-        case ENVFX_SNOW_NORMAL:
-            gfx = envfx_update_snow(1, marioPos, camFrom, camTo);
+            envfx_cleanup();
             break;
 
+        case ENVFX_SNOW_NORMAL:
         case ENVFX_SNOW_WATER:
-            gfx = envfx_update_snow(2, marioPos, camFrom, camTo);
-            break;
-
         case ENVFX_SNOW_BLIZZARD:
-            gfx = envfx_update_snow(3, marioPos, camFrom, camTo);
+            envfx_update_snow(mode, marioPos, camFrom, camTo);
             break;
-
-        default:
-            return NULL;
     }
-
-    return gfx;
 }
@@ -31,6 +31,8 @@
 #include "debug_box.h"
 #include "vc_check.h"
 #include "profiling.h"
+#include "area.h"
+#include "rendering_graph_node.h"
 
 // First 3 controller slots
 struct Controller gControllers[3];
@@ -454,6 +456,141 @@ void select_gfx_pool(void) {
     gGfxPoolEnd = (u8 *) (gGfxPool->buffer + GFX_POOL_SIZE);
 }
 
+#ifdef UNLOCK_FPS_INTERPOLATION
+// Vblanks per game step, which keeps the game logic at 30 FPS (25 on PAL) like without UNLOCK_FPS.
+#define VBLANKS_PER_STEP 2
+
+static u32 sStepVblank = 0;           // When the latest game step was due
+static u32 sStepGfxSize = 0;          // Bytes of the gfx pool the latest step's frame used
+static u8 sInterpolatedFrame = FALSE; // Whether the frame being drawn is between game steps
+static struct SPTask sInterpSPTasks[2];
+static u8 sInterpSPTaskIndex = 0;
+
+/**
+ * Returns whether the next game step is due, and sets how far between the last two
+ * steps the next frame is drawn. Frames are shown up to half a step behind the game.
+ */
+static s32 update_interpolation(void) {
+    s32 stepDue = ((gNumVblanks - sStepVblank) >= VBLANKS_PER_STEP);
+
+    if (stepDue) {
+        sStepVblank += VBLANKS_PER_STEP;
+        // Every step draws a frame too, so after a slow one there is no catching up.
+        if ((gNumVblanks - sStepVblank) >= VBLANKS_PER_STEP) {
+            sStepVblank = gNumVblanks;
+        }
+        gInterpStep++;
+    }
+
+    gInterpAlpha = MIN((f32)(gNumVblanks - sStepVblank + 1) / VBLANKS_PER_STEP, 1.0f);
+    return stepDue;
+}
+
+/**
+ * Draws the latest step's scene again. The frame is built after the step's frame in the same gfx pool,
+ * since it calls the step's HUD and menus, and gets its own task so the one still running isn't touched.
+ * If there isn't room for another frame, this waits for the next vblank instead.
+ */
+static void draw_interpolated_frame(void) {
+    Gfx *frameStart = gDisplayListHead;
+
+    if ((u32)(gGfxPoolEnd - (u8 *) gDisplayListHead) < sStepGfxSize) {
+        osRecvMesg(&gGameVblankQueue, &gMainReceivedMesg, OS_MESG_BLOCK);
+        return;
+    }
+
+    sInterpSPTaskIndex ^= 1;
+    gGfxSPTask = &sInterpSPTasks[sInterpSPTaskIndex];
+    init_rcp(CLEAR_ZBUFFER);
+    render_game_interpolated();
+    end_master_display_list();
+    gGfxSPTask->task.t.data_ptr = (u64 *) frameStart;
+    gGfxSPTask->task.t.data_size = ((gDisplayListHead - frameStart) * sizeof(Gfx));
+
+    sInterpolatedFrame = TRUE;
+    display_and_vsync();
+    sInterpolatedFrame = FALSE;
+}
+#endif
+
+#ifdef PIPELINED_FRAMES
+/**
+ * With PIPELINED_FRAMES the game thread starts on the next frame as soon as it has sent this one,
+ * rather than waiting out the rest of the vblank interval, so the CPU builds frame N + 1 while the
+ * RCP draws frame N. Frame N is then shown by the following call to display_and_vsync.
+ *
+ * The display list for frame N is still being read after display_and_vsync returns, so while
+ * building frame N + 1:
+ * - Anything it points to (matrices, vertices, lights, scrolled textures) must be allocated from
+ *   gGfxPool, which alternates between frames and is only reused once the frame that used it is done.
+ * - Other memory it points to, such as object or Goddard state, must not be changed before the
+ *   wait on gGfxVblankQueue at the start of the next call. Code that does so, like the Goddard
+ *   vblank callback, runs after that wait.
+ * Two gfx pools are enough for this: the scheduler only runs one display list at a time, so
+ * frame N - 1 is always done before frame N is sent and frame N + 1 starts.
+ */
+
+// The least number of vblanks each frame stays on screen for.
+#ifdef UNLOCK_FPS
+#define FRAME_MIN_VBLANKS 1
+#else
+#define FRAME_MIN_VBLANKS 2
+#endif
+
+static u32 sLastSwapVblank = 0;
+
+/**
+ * Waits until at least count vblanks have passed since the last call to osViSwapBuffer.
+ */
+static void wait_vblanks_since_swap(u32 count) {
+    // handle_vblank counts the vblank before it sends the message, so none can be missed here,
+    // and a message left over from an earlier vblank only causes another check.
+    while ((gNumVblanks - sLastSwapVblank) < count) {
+        osRecvMesg(&gGameVblankQueue, &gMainReceivedMesg, OS_MESG_BLOCK);
+    }
+}
+
+/**
+ * This function:
+ * - Waits for the previous master display list to finish.
+ * - Sends the current master display list out to be rendered.
+ * - Tells the VI to display the previous frame, once the frame before it has been up for long enough.
+ * - Selects which framebuffer will be rendered and displayed to next time.
+ */
+void display_and_vsync(void) {
+    profiler_display_wait_started();
+    osRecvMesg(&gGfxVblankQueue, &gMainReceivedMesg, OS_MESG_BLOCK);
+    if (gGoddardVblankCallback != NULL) {
+        gGoddardVblankCallback();
+        gGoddardVblankCallback = NULL;
+    }
+    // This frame is drawn over the framebuffer that was on screen before the last swap,
+    // which is only free once the VI has switched away from it.
+    wait_vblanks_since_swap(1);
+    exec_display_list(gGfxSPTask);
+    profiler_gfx_submitted();
+    wait_vblanks_since_swap(FRAME_MIN_VBLANKS);
+    osViSwapBuffer((void *) PHYSICAL_TO_VIRTUAL(gPhysicalFramebuffers[sRenderedFramebuffer]));
+    sLastSwapVblank = gNumVblanks;
+    profiler_display_wait_ended();
+    // Skip swapping buffers on inaccurate emulators other than VC so that they display immediately as the Gfx task finishes
+    if (gIsConsole || gIsVC || gCacheEmulated) {
+        if (++sRenderedFramebuffer == 3) {
+            sRenderedFramebuffer = 0;
+        }
+        if (++sRenderingFramebuffer == 3) {
+            sRenderingFramebuffer = 0;
+        }
+    }
+#ifdef UNLOCK_FPS_INTERPOLATION
+    // Frames between game steps don't count as game frames.
+    if (sInterpolatedFrame) {
+        return;
+    }
+#endif
+    gGlobalTimer++;
+}
+#else
 /**
  * This function:
  * - Sends the current master display list out to be rendered.
@@ -462,19 +599,22 @@ void select_gfx_pool(void) {
  * - Selects which framebuffer will be rendered and displayed to next time.
  */
 void display_and_vsync(void) {
+    profiler_display_wait_started();
     osRecvMesg(&gGfxVblankQueue, &gMainReceivedMesg, OS_MESG_BLOCK);
     if (gGoddardVblankCallback != NULL) {
         gGoddardVblankCallback();
         gGoddardVblankCallback = NULL;
     }
-    exec_display_list(&gGfxPool->spTask);
-#ifndef UNLOCK_FPS
+    exec_display_list(gGfxSPTask);
+    profiler_gfx_submitted();
+#if !defined(UNLOCK_FPS) || defined(UNLOCK_FPS_INTERPOLATION)
     osRecvMesg(&gGameVblankQueue, &gMainReceivedMesg, OS_MESG_BLOCK);
 #endif
     osViSwapBuffer((void *) PHYSICAL_TO_VIRTUAL(gPhysicalFramebuffers[sRenderedFramebuffer]));
 #ifndef UNLOCK_FPS
     osRecvMesg(&gGameVblankQueue, &gMainReceivedMesg, OS_MESG_BLOCK);
 #endif
+    profiler_display_wait_ended();
     // Skip swapping buffers on inaccurate emulators other than VC so that they display immediately as the Gfx task finishes
     if (gIsConsole || gIsVC || gCacheEmulated) {
         if (++sRenderedFramebuffer == 3) {
@@ -484,8 +624,15 @@ void display_and_vsync(void) {
             sRenderingFramebuffer = 0;
         }
     }
+#ifdef UNLOCK_FPS_INTERPOLATION
+    // Frames between game steps don't count as game frames.
+    if (sInterpolatedFrame) {
+        return;
+    }
+#endif
     gGlobalTimer++;
 }
+#endif
 
 #if !defined(DISABLE_DEMO) && defined(KEEP_MARIO_HEAD)
 // this function records distinct inputs over a 255-frame interval to RAM locations and was likely
@@ -778,9 +925,17 @@ void thread5_game_loop(UNUSED void *arg) {
     render_init();
 
     while (TRUE) {
+#ifdef UNLOCK_FPS_INTERPOLATION
+        if (gResetTimer == 0 && !update_interpolation()) {
+            draw_interpolated_frame();
+            continue;
+        }
+#endif
         profiler_frame_setup();
         // If the reset timer is active, run the process to reset the game.
         if (gResetTimer != 0) {
+            // Keep writing queued save data until the console is reset.
+            save_file_process_writes();
             draw_reset_bars();
             continue;
         }
@@ -797,8 +952,14 @@ void thread5_game_loop(UNUSED void *arg) {
         audio_game_loop_tick();
         select_gfx_pool();
         read_controller_inputs(THREAD_5_GAME_LOOP);
+        // The SI is free again, so write the next slice of any queued save data.
+        save_file_process_writes();
         profiler_update(PROFILER_TIME_CONTROLLERS);
         addr = level_script_execute(addr);
+#ifdef UNLOCK_FPS_INTERPOLATION
+        sStepGfxSize = (((u8 *) gDisplayListHead - (u8 *) gGfxPool->buffer)
+                        + ((u8 *) (gGfxPool->buffer + GFX_POOL_SIZE) - gGfxPoolEnd));
+#endif
 #if !PUPPYPRINT_DEBUG && defined(VISUAL_DEBUG)
         debug_box_input();
 #endif
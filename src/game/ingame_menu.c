@@ -26,6 +26,7 @@
 #include "config.h"
 #include "puppycam2.h"
 #include "main.h"
+#include "buffers/buffers.h"
 
 #ifdef VERSION_EU
 #undef LANGUAGE_FUNCTION
@@ -153,8 +154,18 @@ void create_dl_identity_matrix(void) {
     gSPMatrix(gDisplayListHead++, VIRTUAL_TO_PHYSICAL(matrix), G_MTX_PROJECTION | G_MTX_LOAD | G_MTX_NOPUSH);
 }
 
+// While print_generic_string records a text mesh, its matrices are allocated downwards from the end of the mesh.
+static u8 *sTextMeshAllocHead = NULL;
+
 void create_dl_translation_matrix(s8 pushOp, f32 x, f32 y, f32 z) {
-    Mtx *matrix = (Mtx *) alloc_display_list(sizeof(Mtx));
+    Mtx *matrix;
+
+    if (sTextMeshAllocHead != NULL) {
+        sTextMeshAllocHead -= sizeof(Mtx);
+        matrix = (Mtx *) sTextMeshAllocHead;
+    } else {
+        matrix = (Mtx *) alloc_display_list(sizeof(Mtx));
+    }
 
     if (matrix == NULL) {
         return;
@@ -279,18 +290,12 @@ void render_generic_char(u8 c) {
 }
 #endif
 
-Texture32 *alloc_ia4_tex_from_i1(Texture *in, s16 width, s16 height) {
-    u32 size = (u32) width * (u32) height;
+#if MULTILANG
+static void unpack_ia4_tex_from_i1(Texture *in, Texture *out, s16 width, s16 height) {
     s32 inPos;
     s16 outPos = 0;
     u8 bitMask;
 
-    Texture *out = (Texture *) alloc_display_list(size);
-
-    if (out == NULL) {
-        return NULL;
-    }
-
     for (inPos = 0; inPos < (width * height) / 4; inPos++) {
         bitMask = 0x80;
 
@@ -302,15 +307,29 @@ Texture32 *alloc_ia4_tex_from_i1(Texture *in, s16 width, s16 height) {
             outPos++;
         }
     }
-
-    return (Texture32 *)out;
 }
 
+/**
+ * Every dialog glyph unpacked to IA4 the first time it's drawn, so text doesn't
+ * unpack and allocate a texture per character every frame. The source of each
+ * entry is kept so that a glyph is unpacked again if the font ever changes.
+ */
+static Texture sGlyphCache[256][8 * 8] ALIGNED8;
+static Texture *sGlyphCacheSources[256];
+#endif
+
 void render_generic_char(u8 c) {
     void **fontLUT = segmented_to_virtual(main_font_lut);
     void *packedTexture = segmented_to_virtual(fontLUT[c]);
 #if MULTILANG
-    void *unpackedTexture = alloc_ia4_tex_from_i1(packedTexture, 8, 8);
+    Texture *unpackedTexture = sGlyphCache[c];
+
+    // The RDP reads the cache directly, which is fine because the whole
+    // data cache is written back before each display list is sent.
+    if (sGlyphCacheSources[c] != packedTexture) {
+        unpack_ia4_tex_from_i1(packedTexture, unpackedTexture, 8, 8);
+        sGlyphCacheSources[c] = packedTexture;
+    }
 
     gDPPipeSync(gDisplayListHead++);
     gDPSetTextureImage(gDisplayListHead++, G_IM_FMT_IA, G_IM_SIZ_16b, 1, VIRTUAL_TO_PHYSICAL(unpackedTexture));
@@ -322,6 +341,33 @@ void render_generic_char(u8 c) {
     gSPDisplayList(gDisplayListHead++, dl_ia_text_tex_settings);
 }
 
+#define NUM_TEXT_ADVANCE_MATRICES 32
+
+// Translations by a whole number of pixels along x, shared by every character
+// advance instead of allocating a matrix per character per frame.
+static Mtx sTextAdvanceMatrices[NUM_TEXT_ADVANCE_MATRICES];
+static u8 sTextAdvanceMatricesInit = FALSE;
+
+/**
+ * Moves the text cursor right by width pixels.
+ */
+static void create_dl_text_advance_matrix(s32 width) {
+    s32 i;
+
+    if (width < 0 || width >= NUM_TEXT_ADVANCE_MATRICES) {
+        create_dl_translation_matrix(MENU_MTX_NOPUSH, (f32) width, 0.0f, 0.0f);
+        return;
+    }
+
+    if (!sTextAdvanceMatricesInit) {
+        for (i = 0; i < NUM_TEXT_ADVANCE_MATRICES; i++) {
+            guTranslate(&sTextAdvanceMatrices[i], (f32) i, 0.0f, 0.0f);
+        }
+        sTextAdvanceMatricesInit = TRUE;
+    }
+
+    gSPMatrix(gDisplayListHead++, VIRTUAL_TO_PHYSICAL(&sTextAdvanceMatrices[width]), G_MTX_MODELVIEW | G_MTX_MUL | G_MTX_NOPUSH);
+}
 
 struct MultiTextEntry {
     u8 length;
@@ -347,19 +393,43 @@ void render_multi_text_string(s8 multiTextID) {
 
     for (i = 0; i < textLengths[multiTextID].length; i++) {
         render_generic_char(textLengths[multiTextID].str[i]);
-        create_dl_translation_matrix(MENU_MTX_NOPUSH, (f32)(gDialogCharWidths[textLengths[multiTextID].str[i]]), 0.0f, 0.0f);
+        create_dl_text_advance_matrix(gDialogCharWidths[textLengths[multiTextID].str[i]]);
     }
 }
 
 #define MAX_STRING_WIDTH 16
-#define CHAR_WIDTH_SPACE (f32)(gDialogCharWidths[DIALOG_CHAR_SPACE])
-#define CHAR_WIDTH_DEFAULT (f32)(gDialogCharWidths[str[strPos]])
+#define CHAR_WIDTH_SPACE (gDialogCharWidths[DIALOG_CHAR_SPACE])
+#define CHAR_WIDTH_DEFAULT (gDialogCharWidths[str[strPos]])
+
+#define NUM_TEXT_MESHES 12
+#define TEXT_MESH_SIZE  0x800
+
+// The most a single character of a string can add to a text mesh, which is
+// a "the" or "you" (3 glyphs and advances), plus the final pop and end.
+#define TEXT_MESH_MAX_CHAR_SIZE (sizeof(Mtx) + 14 * sizeof(Gfx))
+
+/**
+ * The commands and matrices print_generic_string emitted for a string, kept so
+ * that menu text drawn every frame only costs a single gSPDisplayList.
+ */
+struct TextMesh {
+    const u8 *str;
+    u32 hash;
+    s16 x;
+    s16 y;
+    u32 lastUsedFrame;
+    u8 valid;
+    Gfx dl[TEXT_MESH_SIZE / sizeof(Gfx)];
+};
+
+static struct TextMesh sTextMeshes[NUM_TEXT_MESHES];
+static u8 sTextMeshOverflow = FALSE;
 
 /**
  * Prints a generic white string.
  * In JP/EU a IA1 texture is used but in US a IA4 texture is used.
  */
-void print_generic_string(s16 x, s16 y, const u8 *str) {
+static void render_generic_string(s16 x, s16 y, const u8 *str) {
     s8 mark = DIALOG_MARK_NONE; // unused in EU
     s32 strPos = 0;
     u8 lineNum = 1;
@@ -372,6 +442,12 @@ void print_generic_string(s16 x, s16 y, const u8 *str) {
     create_dl_translation_matrix(MENU_MTX_PUSH, x, y, 0.0f);
 
     while (str[strPos] != DIALOG_CHAR_TERMINATOR) {
+        if (sTextMeshAllocHead != NULL
+            && ((u8 *) gDisplayListHead + TEXT_MESH_MAX_CHAR_SIZE) > sTextMeshAllocHead) {
+            sTextMeshOverflow = TRUE;
+            break;
+        }
+
         switch (str[strPos]) {
             case DIALOG_CHAR_COLOR:
                 customColor = 1;
@@ -428,7 +504,7 @@ void print_generic_string(s16 x, s16 y, const u8 *str) {
                 gSPPopMatrix(gDisplayListHead++, G_MTX_MODELVIEW);
                 break;
             case DIALOG_CHAR_SLASH:
-                create_dl_translation_matrix(MENU_MTX_NOPUSH, (f32)(gDialogCharWidths[DIALOG_CHAR_SPACE] * 2), 0.0f, 0.0f);
+                create_dl_text_advance_matrix(gDialogCharWidths[DIALOG_CHAR_SPACE] * 2);
                 break;
             case DIALOG_CHAR_MULTI_THE:
                 render_multi_text_string(STRING_THE);
@@ -437,8 +513,7 @@ void print_generic_string(s16 x, s16 y, const u8 *str) {
                 render_multi_text_string(STRING_YOU);
                 break;
             case DIALOG_CHAR_SPACE:
-                // create_dl_translation_matrix(MENU_MTX_NOPUSH, (f32)(gDialogCharWidths[DIALOG_CHAR_SPACE]), 0.0f, 0.0f);
-                create_dl_translation_matrix(MENU_MTX_NOPUSH, CHAR_WIDTH_SPACE, 0.0f, 0.0f);
+                create_dl_text_advance_matrix(CHAR_WIDTH_SPACE);
                 break;
             default:
                 render_generic_char(str[strPos]);
@@ -449,7 +524,7 @@ void print_generic_string(s16 x, s16 y, const u8 *str) {
                     mark = DIALOG_MARK_NONE;
                 }
 
-                create_dl_translation_matrix(MENU_MTX_NOPUSH, CHAR_WIDTH_DEFAULT, 0.0f, 0.0f);
+                create_dl_text_advance_matrix(CHAR_WIDTH_DEFAULT);
                 break;
         }
 
@@ -459,6 +534,97 @@ void print_generic_string(s16 x, s16 y, const u8 *str) {
     gSPPopMatrix(gDisplayListHead++, G_MTX_MODELVIEW);
 }
 
+static u32 text_mesh_hash(const u8 *str) {
+    u32 hash = 2166136261U;
+
+    while (*str != DIALOG_CHAR_TERMINATOR) {
+        hash = (hash ^ *str++) * 16777619U;
+    }
+
+    return hash;
+}
+
+/**
+ * Records the string into a free text mesh, returning NULL if there isn't one or
+ * the string doesn't fit. A mesh can only be replaced once no display list that
+ * is still being built or drawn calls it.
+ */
+static struct TextMesh *record_text_mesh(s16 x, s16 y, const u8 *str, u32 hash) {
+    struct TextMesh *mesh = NULL;
+    Gfx *savedHead = gDisplayListHead;
+    s32 i;
+
+    for (i = 0; i < NUM_TEXT_MESHES; i++) {
+        struct TextMesh *candidate = &sTextMeshes[i];
+
+        if (candidate->valid && (gGlobalTimer - candidate->lastUsedFrame) < ARRAY_COUNT(gGfxPools)) {
+            continue;
+        }
+        if (mesh == NULL || !candidate->valid
+            || (mesh->valid && candidate->lastUsedFrame < mesh->lastUsedFrame)) {
+            mesh = candidate;
+        }
+    }
+
+    if (mesh == NULL) {
+        return NULL;
+    }
+
+    mesh->valid = FALSE;
+    gDisplayListHead = mesh->dl;
+    sTextMeshAllocHead = (u8 *) mesh->dl + sizeof(mesh->dl);
+    sTextMeshOverflow = FALSE;
+
+    render_generic_string(x, y, str);
+    gSPEndDisplayList(gDisplayListHead++);
+
+    gDisplayListHead = savedHead;
+    sTextMeshAllocHead = NULL;
+
+    if (sTextMeshOverflow) {
+        return NULL;
+    }
+
+    mesh->str = str;
+    mesh->hash = hash;
+    mesh->x = x;
+    mesh->y = y;
+    mesh->valid = TRUE;
+    return mesh;
+}
+
+/**
+ * Prints a generic white string, reusing the text mesh from a previous frame
+ * if the same string was printed at the same place.
+ */
+void print_generic_string(s16 x, s16 y, const u8 *str) {
+    struct TextMesh *mesh = NULL;
+    u32 hash = text_mesh_hash(str);
+    s32 i;
+
+    for (i = 0; i < NUM_TEXT_MESHES; i++) {
+        struct TextMesh *candidate = &sTextMeshes[i];
+
+        if (candidate->valid && candidate->str == str && candidate->hash == hash
+            && candidate->x == x && candidate->y == y) {
+            mesh = candidate;
+            break;
+        }
+    }
+
+    if (mesh == NULL) {
+        mesh = record_text_mesh(x, y, str, hash);
+    }
+
+    if (mesh == NULL) {
+        render_generic_string(x, y, str);
+        return;
+    }
+
+    mesh->lastUsedFrame = gGlobalTimer;
+    gSPDisplayList(gDisplayListHead++, mesh->dl);
+}
+
 
 /**
  * Prints a hud string depending of the hud table list defined.
@@ -831,21 +997,21 @@ void render_star_count_dialog_text(s8 *xMatrix, s16 *linePos) {
 
     if (tensDigit != 0) {
         if (*xMatrix != 1) {
-            create_dl_translation_matrix(MENU_MTX_NOPUSH, (f32)(gDialogCharWidths[DIALOG_CHAR_SPACE] * *xMatrix), 0, 0);
+            create_dl_text_advance_matrix(gDialogCharWidths[DIALOG_CHAR_SPACE] * *xMatrix);
         }
 
         render_generic_char(tensDigit);
-        create_dl_translation_matrix(MENU_MTX_NOPUSH, (f32) gDialogCharWidths[tensDigit], 0, 0);
+        create_dl_text_advance_matrix(gDialogCharWidths[tensDigit]);
         *xMatrix = 1;
         (*linePos)++;
     }
 
     if (*xMatrix != 1) {
-        create_dl_translation_matrix(MENU_MTX_NOPUSH, (f32)(gDialogCharWidths[DIALOG_CHAR_SPACE] * (*xMatrix - 1)), 0, 0);
+        create_dl_text_advance_matrix(gDialogCharWidths[DIALOG_CHAR_SPACE] * (*xMatrix - 1));
     }
 
     render_generic_char(onesDigit);
-    create_dl_translation_matrix(MENU_MTX_NOPUSH, (f32) gDialogCharWidths[onesDigit], 0, 0);
+    create_dl_text_advance_matrix(gDialogCharWidths[onesDigit]);
     (*linePos)++;
     *xMatrix = 1;
 }
@@ -859,11 +1025,11 @@ void render_multi_text_string_lines(s8 multiTextId, s8 lineNum, s16 *linePos, s8
 
     if (lineNum >= lowerBound && lineNum <= (lowerBound + linesPerBox)) {
         if (*linePos != 0 || xMatrix != 1) {
-            create_dl_translation_matrix(MENU_MTX_NOPUSH, (gDialogCharWidths[DIALOG_CHAR_SPACE] * (xMatrix - 1)), 0, 0);
+            create_dl_text_advance_matrix(gDialogCharWidths[DIALOG_CHAR_SPACE] * (xMatrix - 1));
         }
         for (i = 0; i < textLengths[multiTextId].length; i++) {
             render_generic_char(textLengths[multiTextId].str[i]);
-            create_dl_translation_matrix(MENU_MTX_NOPUSH, (gDialogCharWidths[textLengths[multiTextId].str[i]]), 0, 0);
+            create_dl_text_advance_matrix(gDialogCharWidths[textLengths[multiTextId].str[i]]);
         }
     }
     linePos += textLengths[multiTextId].length;
@@ -979,12 +1145,11 @@ void handle_dialog_text_and_pages(s8 colorMode, struct DialogEntry *dialog, s8 l
             default: // any other character
                 if ((lineNum >= lowerBound) && (lineNum <= (lowerBound + linesPerBox))) {
                     if (linePos || xMatrix != 1) {
-                        create_dl_translation_matrix(
-                            MENU_MTX_NOPUSH, (f32)(gDialogCharWidths[DIALOG_CHAR_SPACE] * (xMatrix - 1)), 0, 0);
+                        create_dl_text_advance_matrix(gDialogCharWidths[DIALOG_CHAR_SPACE] * (xMatrix - 1));
                     }
 
                     render_generic_char(strChar);
-                    create_dl_translation_matrix(MENU_MTX_NOPUSH, (f32)(gDialogCharWidths[strChar]), 0, 0);
+                    create_dl_text_advance_matrix(gDialogCharWidths[strChar]);
                     xMatrix = 1;
                     linePos++;
                 }
@@ -7,18 +7,18 @@
 #include "engine/math_util.h"
 #include "camera.h"
 #include "envfx_snow.h"
+#include "particle_system.h"
 #include "level_geo.h"
 
 /**
- * Geo function that generates a displaylist for environment effects such as
- * snow or jet stream bubbles.
+ * Geo function that updates environment effects such as snow or jet stream
+ * bubbles. They are drawn with the other particles by particles_render once
+ * the camera's children have been processed.
  */
-Gfx *geo_envfx_main(s32 callContext, struct GraphNode *node, Mat4 mtxf) {
+Gfx *geo_envfx_main(s32 callContext, struct GraphNode *node, UNUSED Mat4 mtxf) {
     Vec3s marioPos;
     Vec3s camFrom;
     Vec3s camTo;
-    void *particleList;
-    Gfx *gfx = NULL;
 
     if (callContext == GEO_CONTEXT_RENDER && gCurGraphNodeCamera != NULL) {
         struct GraphNodeGenerated *execNode = (struct GraphNodeGenerated *) node;
@@ -31,17 +31,9 @@ Gfx *geo_envfx_main(s32 callContext, struct GraphNode *node, Mat4 mtxf) {
             vec3f_to_vec3s(camTo, gCurGraphNodeCamera->focus);
             vec3f_to_vec3s(camFrom, gCurGraphNodeCamera->pos);
             vec3f_to_vec3s(marioPos, gPlayerCameraState->pos);
-            particleList = envfx_update_particles(snowMode, marioPos, camTo, camFrom);
-            if (particleList != NULL) {
-                Mtx *mtx = alloc_display_list(sizeof(*mtx));
-
-                gfx = alloc_display_list(2 * sizeof(*gfx));
-                mtxf_to_mtx(mtx, mtxf);
-                gSPMatrix(&gfx[0], VIRTUAL_TO_PHYSICAL(mtx), G_MTX_MODELVIEW | G_MTX_LOAD | G_MTX_NOPUSH);
-                gSPBranchList(&gfx[1], VIRTUAL_TO_PHYSICAL(particleList));
-                SET_GRAPH_NODE_LAYER(execNode->fnNode.node.flags, LAYER_OCCLUDE_SILHOUETTE_ALPHA);
-            }
+            envfx_update_particles(snowMode, marioPos, camTo, camFrom);
             SET_HIGH_U16_OF_32(*params, gAreaUpdateCounter);
+            gParticles.envFxUpdate = gAreaUpdateCounter;
         }
     } else if (callContext == GEO_CONTEXT_AREA_INIT) {
         // Give these arguments some dummy values. Not used in ENVFX_MODE_NONE
@@ -51,7 +43,7 @@ Gfx *geo_envfx_main(s32 callContext, struct GraphNode *node, Mat4 mtxf) {
         envfx_update_particles(ENVFX_MODE_NONE, marioPos, camTo, camFrom);
     }
 
-    return gfx;
+    return NULL;
 }
 
 /**
@@ -69,7 +61,15 @@ Gfx *geo_skybox_main(s32 callContext, struct GraphNode *node, UNUSED Mat4 *mtx)
         struct GraphNodeCamera *camNode = (struct GraphNodeCamera *) gCurGraphNodeRoot->views[0];
         struct GraphNodePerspective *camFrustum =
             (struct GraphNodePerspective *) camNode->fnNode.node.parent;
+#ifdef UNLOCK_FPS_INTERPOLATION
+        // Turns with the interpolated camera rather than once per game step.
+        static struct CameraInterp sSkyboxInterp = { .step = (u16) -1 };
+        Vec3f pos, focus;
+        geo_interp_camera(&sSkyboxInterp, gLakituState.pos, gLakituState.focus, pos, focus);
+        gfx = create_skybox_facing_camera(0, backgroundNode->background, camFrustum->fov, pos, focus);
+#else
         gfx = create_skybox_facing_camera(0, backgroundNode->background, camFrustum->fov, gLakituState.pos, gLakituState.focus);
+#endif
 #endif
     }
 
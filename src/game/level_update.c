@@ -962,6 +962,7 @@ void basic_update(void) {
     update_hud_values();
 #ifdef PUPPYLIGHTS
     delete_lights();
+    puppylights_update_clusters();
 #endif
 
     if (gCurrentArea != NULL) {
@@ -993,6 +994,7 @@ s32 play_mode_normal(void) {
     update_hud_values();
 #ifdef PUPPYLIGHTS
     delete_lights();
+    puppylights_update_clusters();
 #endif
 
     if (gCurrentArea != NULL) {
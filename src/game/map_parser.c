@@ -3,6 +3,7 @@
 #include <stdarg.h>
 #include <string.h>
 #include "segments.h"
+#include "memory.h"
 
 #define STACK_TRAVERSAL_LIMIT 100
 
@@ -14,8 +15,16 @@ struct MapEntry {
 };
 extern u8 gMapStrings[];
 extern struct MapEntry gMapEntries[];
-extern u32 gMapEntrySize;
+extern u8 gMapEntryEnd[];
 extern u8 _mapDataSegmentRomStart[];
+extern u8 _mapDataSegmentRomEnd[];
+
+#define MAP_DATA_RAM_START (RAM_END - 0x100000)
+#define NUM_MAP_ENTRIES (((u32) gMapEntryEnd - (u32) gMapEntries) / sizeof(struct MapEntry))
+
+// Where the map data is read from: its link address after map_data_init, or a copy from map_data_load_copy.
+static struct MapEntry *sMapEntries = gMapEntries;
+static u8 *sMapStrings = gMapStrings;
 
 
 // code provided by Wiseguy
@@ -41,18 +50,56 @@ void map_data_init(void) {
 	while (headless_pi_status() & (PI_STATUS_DMA_BUSY | PI_STATUS_ERROR));
 }
 
-char *parse_map(u32 pc) {
-	u32 i;
+/**
+ * Copy the map data into memory allocated from the main pool, so it can be used
+ * while the game is running instead of only after a crash.
+ */
+void map_data_load_copy(void) {
+	u8 *copy = dynamic_dma_read(_mapDataSegmentRomStart, _mapDataSegmentRomEnd, MEMORY_POOL_LEFT, 0, 0);
 
-	for (i = 0; i < gMapEntrySize; i++) {
-		if (gMapEntries[i].addr >= pc) break;
+	if (copy != NULL) {
+		sMapEntries = (struct MapEntry *) (copy + ((u32) gMapEntries - MAP_DATA_RAM_START));
+		sMapStrings = copy + ((u32) gMapStrings - MAP_DATA_RAM_START);
 	}
+}
+
+/**
+ * Binary search the address-sorted map for the symbol containing pc.
+ * Returns its index, or -1 if pc is outside the map.
+ */
+s32 map_find_entry(u32 pc) {
+	s32 lo = 0;
+	s32 hi = (s32) NUM_MAP_ENTRIES - 1;
 
-	if (i == gMapEntrySize - 1) {
+	if (hi < 0 || pc < sMapEntries[0].addr || pc >= sMapEntries[hi].addr) {
+		return -1;
+	}
+
+	// Find the last entry at or before pc.
+	while (lo < hi) {
+		s32 mid = (lo + hi + 1) / 2;
+		if (sMapEntries[mid].addr <= pc) {
+			lo = mid;
+		} else {
+			hi = mid - 1;
+		}
+	}
+
+	return lo;
+}
+
+char *map_entry_name(s32 index) {
+	return (char *) (sMapStrings + sMapEntries[index].nm_offset);
+}
+
+char *parse_map(u32 pc) {
+	s32 index = map_find_entry(pc);
+
+	if (index < 0) {
 		return NULL;
-	} else {
-		return (char*) ((u32)gMapStrings + gMapEntries[i - 1].nm_offset);
 	}
+
+	return map_entry_name(index);
 }
 
 extern u8 _mainSegmentStart[];
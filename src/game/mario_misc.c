@@ -89,14 +89,20 @@ struct GraphNodeObject gMirrorMario;  // copy of Mario's geo node for drawing mi
 Gfx *geo_draw_mario_head_goddard(s32 callContext, struct GraphNode *node, UNUSED Mat4 *mtx) {
     Gfx *gfx = NULL;
     struct GraphNodeGenerated *asGenerated = (struct GraphNodeGenerated *) node;
+    static struct GeoStepCache sHeadStep;
 
     if (callContext == GEO_CONTEXT_RENDER) {
+        // The head steps its own simulation, so in between frames draw the step's display list again.
+        if (GEO_STEP_CACHED(&sHeadStep)) {
+            return sHeadStep.gfx;
+        }
         if (gPlayer1Controller->controllerData != NULL && !gWarpTransition.isActive) {
             gd_copy_p1_contpad(gPlayer1Controller->controllerData);
         }
         gfx = (Gfx *) PHYSICAL_TO_VIRTUAL(gdm_gettestdl(asGenerated->parameter));
         gGoddardVblankCallback = gd_vblank;
         play_menu_sounds(gd_sfx_to_play());
+        GEO_STEP_CACHE_SAVE(&sHeadStep, gfx);
     }
     return gfx;
 }
@@ -9,6 +9,7 @@
 #include "game_init.h"
 #include "interaction.h"
 #include "mario_step.h"
+#include "object_list_processor.h"
 
 #include "config.h"
 
@@ -278,6 +279,9 @@ static s32 perform_ground_quarter_step(struct MarioState *m, Vec3f nextPos) {
     s16 wallDYaw;
     s32 oldWallDYaw;
 
+#ifdef COUNT_COLLISION_CALLS
+    gNumCalls.groundQuarterSteps++;
+#endif
     resolve_and_return_wall_collisions(nextPos, 30.0f, 24.0f, &lowerWall);
     resolve_and_return_wall_collisions(nextPos, 60.0f, 50.0f, &upperWall);
 
@@ -462,6 +466,9 @@ s32 perform_air_quarter_step(struct MarioState *m, Vec3f intendedPos, u32 stepAr
 
     vec3f_copy(nextPos, intendedPos);
 
+#ifdef COUNT_COLLISION_CALLS
+    gNumCalls.airQuarterSteps++;
+#endif
     resolve_and_return_wall_collisions(nextPos, 150.0f, 50.0f, &upperWall);
     resolve_and_return_wall_collisions(nextPos, 30.0f, 50.0f, &lowerWall);
 
@@ -675,16 +682,49 @@ void apply_vertical_wind(struct MarioState *m) {
     }
 }
 
+#ifdef SWEPT_COLLISION
+/**
+ * Sweep Mario's hitbox along this frame's motion to decide how many steps it needs.
+ * If nothing is in the way and he ends up above a floor, every quarter step would just
+ * move him, so one step does. Otherwise he takes quarter steps, or more if a quarter step
+ * would move him further than his wall radius, which could carry him through a wall.
+ */
+static s32 get_air_step_count(struct MarioState *m) {
+    struct SweptCollisionData sweep;
+    struct Surface *floor;
+
+    sweep.radius = 50.0f;
+    sweep.bottom = 0.0f;
+    sweep.top = 160.0f;
+
+    if (!(m->action & ACT_FLAG_RIDING_SHELL)
+        && !find_swept_collision(m->pos, m->vel, &sweep, (RAYCAST_FIND_FLOOR | RAYCAST_FIND_WALL | RAYCAST_FIND_CEIL))) {
+        // The sweep doesn't see out of bounds, where the quarter steps still move him up to the edge.
+        find_floor(m->pos[0] + m->vel[0], m->pos[1] + m->vel[1], m->pos[2] + m->vel[2], &floor);
+        if (floor != NULL) {
+            return 1;
+        }
+        return 4;
+    }
+
+    return CLAMP((s32)(sqrtf(sqr(m->vel[0]) + sqr(m->vel[2])) / 50.0f) + 1, 4, 16);
+}
+#endif
+
 s32 perform_air_step(struct MarioState *m, u32 stepArg) {
     Vec3f intendedPos;
-    const f32 numSteps = 4.0f;
+#ifdef SWEPT_COLLISION
+    const s32 numSteps = get_air_step_count(m);
+#else
+    const s32 numSteps = 4;
+#endif
     s32 i;
     s32 quarterStepResult;
     s32 stepResult = AIR_STEP_NONE;
 
     set_mario_wall(m, NULL);
 
-    for (i = 0; i < 4; i++) {
+    for (i = 0; i < numSteps; i++) {
         intendedPos[0] = m->pos[0] + m->vel[0] / numSteps;
         intendedPos[1] = m->pos[1] + m->vel[1] / numSteps;
         intendedPos[2] = m->pos[2] + m->vel[2] / numSteps;
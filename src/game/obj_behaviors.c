@@ -387,8 +387,36 @@ s16 object_step(void) {
 
     s16 collisionFlags = 0;
 
+    f32 wallX = objX + objVelX;
+    f32 wallZ = objZ + objVelZ;
+
+#ifdef SWEPT_COLLISION
+    // An object moving further than its radius could skip over a wall, so look for walls
+    // where it would first touch one instead of only where it ends up.
+    if (sqr(o->oForwardVel) > sqr(o->hitboxRadius)) {
+        struct SweptCollisionData sweep;
+        Vec3f motion = { objVelX, 0.0f, objVelZ };
+
+        sweep.radius = o->hitboxRadius;
+        sweep.bottom = 0.0f;
+        sweep.top = o->hitboxHeight;
+
+        if (find_swept_collision(&o->oPosVec, motion, &sweep, RAYCAST_FIND_WALL)) {
+            wallX = objX + (objVelX * sweep.t);
+            wallZ = objZ + (objVelZ * sweep.t);
+        }
+    }
+#endif
+
     // Find any wall collisions, receive the push, and set the flag.
-    if (obj_find_wall(objX + objVelX, objY, objZ + objVelZ, objVelX, objVelZ) == 0) {
+    s32 hitWall = (obj_find_wall(wallX, objY, wallZ, objVelX, objVelZ) == 0);
+#ifdef SWEPT_COLLISION
+    // Nothing may push back at the contact point while a wall still reaches the end point.
+    if (!hitWall && (wallX != (objX + objVelX) || wallZ != (objZ + objVelZ))) {
+        hitWall = (obj_find_wall(objX + objVelX, objY, objZ + objVelZ, objVelX, objVelZ) == 0);
+    }
+#endif
+    if (hitWall) {
         collisionFlags += OBJ_COL_FLAG_HIT_WALL;
     }
 
@@ -23,6 +23,7 @@
 #include "obj_behaviors.h"
 #include "object_helpers.h"
 #include "object_list_processor.h"
+#include "particle_system.h"
 #include "rendering_graph_node.h"
 #include "spawn_object.h"
 #include "spawn_sound.h"
@@ -925,6 +926,27 @@ void obj_become_tangible(struct Object *obj) {
     obj->oIntangibleTimer = 0;
 }
 
+/**
+ * Stop updating the current object until Mario comes within marioDist, numFrames have
+ * passed, or the field at watch changes. Pass 0 or NULL to ignore a condition.
+ * The object also wakes when it's interacted with or collides with another object.
+ * While asleep only oTimer is advanced, so its visibility and oDistanceToMario aren't updated.
+ */
+void cur_obj_sleep_until(f32 marioDist, s32 numFrames, s32 *watch) {
+    o->sleep.wakeDistSq = sqr(marioDist);
+    o->sleep.wakeFrame = (numFrames > 0) ? (gGlobalTimer + numFrames) : 0;
+    o->sleep.watch = watch;
+    o->sleep.watchValue = (watch != NULL) ? *watch : 0;
+    o->activeFlags |= ACTIVE_FLAG_SLEEPING;
+}
+
+/**
+ * Wake an object up, for objects that change another object's state directly.
+ */
+void obj_wake_up(struct Object *obj) {
+    obj->activeFlags &= ~ACTIVE_FLAG_SLEEPING;
+}
+
 void cur_obj_update_floor_height(void) {
     struct Surface *floor;
     o->oFloorHeight = find_floor(o->oPosX, o->oPosY, o->oPosZ, &floor);
@@ -1669,12 +1691,59 @@ s32 cur_obj_reflect_move_angle_off_wall(void) {
     return (s16)(o->oWallAngle - ((s16) o->oMoveAngleYaw - (s16) o->oWallAngle) + 0x8000);
 }
 
+/**
+ * Spawn the particles as part of the particle system if it can draw the model.
+ */
+static s32 cur_obj_emit_particles(struct SpawnParticlesInfo *info) {
+    struct ParticleEmitter emitter;
+    s32 material = particles_material_from_model(info->model);
+
+    if (material == PARTICLE_MAT_NONE) {
+        return FALSE;
+    }
+
+    emitter.material = material;
+    emitter.count = info->count;
+    emitter.lifetime = 21;
+    emitter.alpha = 255;
+    emitter.alphaStep = 0;
+    emitter.flags = 0;
+    // See bhv_white_puff_exploding_loop
+    switch (info->behParam) {
+        case 2:
+            emitter.alpha = 254;
+            emitter.alphaStep = -21;
+            break;
+        case 3:
+            emitter.alpha = 254;
+            emitter.alphaStep = -13;
+            emitter.flags = PARTICLE_FLAG_SLOW_FADE;
+            break;
+    }
+    emitter.offsetY = info->offsetY;
+    emitter.forwardVelBase = info->forwardVelBase;
+    emitter.forwardVelRange = info->forwardVelRange;
+    emitter.velYBase = info->velYBase;
+    emitter.velYRange = info->velYRange;
+    emitter.gravity = info->gravity;
+    emitter.dragStrength = info->dragStrength;
+    emitter.sizeBase = info->sizeBase;
+    emitter.sizeRange = info->sizeRange;
+
+    particles_emit(&emitter, &o->oPosVec);
+    return TRUE;
+}
+
 void cur_obj_spawn_particles(struct SpawnParticlesInfo *info) {
     struct Object *particle;
     s32 i;
     f32 scale;
     s32 numParticles = info->count;
 
+    if (cur_obj_emit_particles(info)) {
+        return;
+    }
+
     // If there are a lot of objects already, limit the number of particles
     if ((gPrevFrameObjectCount > (OBJECT_POOL_CAPACITY - 90)) && numParticles > 10) {
         numParticles = 10;
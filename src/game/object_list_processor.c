@@ -10,6 +10,7 @@
 #include "engine/surface_collision.h"
 #include "engine/surface_load.h"
 #include "engine/math_util.h"
+#include "game_init.h"
 #include "interaction.h"
 #include "level_update.h"
 #include "mario.h"
@@ -17,6 +18,7 @@
 #include "object_collision.h"
 #include "object_helpers.h"
 #include "object_list_processor.h"
+#include "particle_system.h"
 #include "platform_displacement.h"
 #include "spawn_object.h"
 #include "puppyprint.h"
@@ -283,6 +285,35 @@ void bhv_mario_update(void) {
     }
 }
 
+/**
+ * Check whether a sleeping object should wake up this frame, and wake it if so.
+ * Objects that stay asleep only have their timer advanced.
+ */
+static s32 obj_check_wake_up(struct Object *obj) {
+    struct ObjectSleep *sleep = &obj->sleep;
+    s32 wake = (obj->oInteractStatus != 0 || obj->numCollidedObjs != 0);
+
+    if (!wake && sleep->wakeFrame != 0) {
+        wake = (gGlobalTimer >= sleep->wakeFrame);
+    }
+    if (!wake && sleep->watch != NULL) {
+        wake = (*sleep->watch != sleep->watchValue);
+    }
+    if (!wake && sleep->wakeDistSq > 0.0f && gMarioObject != NULL) {
+        Vec3f d;
+        vec3f_diff(d, &gMarioObject->oPosVec, &obj->oPosVec);
+        wake = (vec3_sumsq(d) < sleep->wakeDistSq);
+    }
+
+    if (wake) {
+        obj_wake_up(obj);
+    } else if (obj->oTimer < 0x3FFFFFFF) {
+        obj->oTimer++;
+    }
+
+    return wake;
+}
+
 /**
  * Update every object that occurs after firstObj in the given object list,
  * including firstObj itself. Return the number of objects that were updated.
@@ -294,7 +325,9 @@ s32 update_objects_starting_at(struct ObjectNode *objList, struct ObjectNode *fi
         gCurrentObject = (struct Object *) firstObj;
 
         gCurrentObject->header.gfx.node.flags |= GRAPH_RENDER_HAS_ANIMATION;
-        cur_obj_update();
+        if (!(gCurrentObject->activeFlags & ACTIVE_FLAG_SLEEPING) || obj_check_wake_up(gCurrentObject)) {
+            cur_obj_update();
+        }
 
         firstObj = firstObj->next;
         count++;
@@ -341,7 +374,9 @@ s32 update_objects_during_time_stop(struct ObjectNode *objList, struct ObjectNod
         // Only update if unfrozen
         if (unfrozen) {
             gCurrentObject->header.gfx.node.flags |= GRAPH_RENDER_HAS_ANIMATION;
-            cur_obj_update();
+            if (!(gCurrentObject->activeFlags & ACTIVE_FLAG_SLEEPING) || obj_check_wake_up(gCurrentObject)) {
+                cur_obj_update();
+            }
         } else {
             gCurrentObject->header.gfx.node.flags &= ~GRAPH_RENDER_HAS_ANIMATION;
         }
@@ -459,6 +494,9 @@ void spawn_objects_from_info(UNUSED s32 unused, struct SpawnInfo *spawnInfo) {
     gMarioOnMerryGoRound = FALSE;
 
     clear_mario_platform();
+#ifdef PLATFORM_DISPLACEMENT_2
+    clear_platform_riders();
+#endif
 
     if (gCurrAreaIndex == 2) {
         gCCMEnteredSlide |= 1;
@@ -531,6 +569,7 @@ void clear_objects(void) {
 
     init_free_object_list();
     clear_object_lists(gObjectListArray);
+    particles_clear();
 
     for (i = 0; i < OBJECT_POOL_CAPACITY; i++) {
         gObjectPool[i].activeFlags = ACTIVE_FLAG_DEACTIVATED;
@@ -639,6 +678,9 @@ void update_objects(UNUSED s32 unused) {
     //! If the platform object unloaded and a different object took its place,
     //  displacement could be applied incorrectly
     apply_mario_platform_displacement();
+#ifdef PLATFORM_DISPLACEMENT_2
+    apply_platform_rider_displacement();
+#endif
 
     // Detect which objects are intersecting
     detect_object_collisions();
@@ -646,11 +688,17 @@ void update_objects(UNUSED s32 unused) {
     // Update all other objects that haven't been updated yet
     update_non_terrain_objects();
 
+    // Move the particles spawned by objects
+    particles_update();
+
     // Unload any objects that have been deactivated
     unload_deactivated_objects();
 
     // Check if Mario is on a platform object and save this object
     update_mario_platform();
+#ifdef PLATFORM_DISPLACEMENT_2
+    update_platform_riders();
+#endif
 
     try_print_debug_mario_object_info();
 
@@ -70,6 +70,10 @@ struct NumTimesCalled {
     /*0x00*/ s16 floor;
     /*0x02*/ s16 ceil;
     /*0x04*/ s16 wall;
+    /*0x06*/ s16 groundQuarterSteps;
+    /*0x08*/ s16 airQuarterSteps;
+    /*0x0A*/ s16 sweep;
+    /*0x0C*/ s16 ray;
 };
 
 extern struct NumTimesCalled gNumCalls;
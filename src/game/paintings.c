@@ -2,6 +2,7 @@
 
 #include "sm64.h"
 #include "area.h"
+#include "debug.h"
 #include "engine/graph_node.h"
 #include "engine/surface_collision.h"
 #include "engine/math_util.h"
@@ -16,6 +17,7 @@
 #include "level_update.h"
 #include "object_list_processor.h"
 #include "paintings.h"
+#include "rendering_graph_node.h"
 #include "save_file.h"
 #include "segment2.h"
 
@@ -144,17 +146,54 @@ f32 gPaintingMarioYPos;
 f32 gPaintingMarioZPos;
 
 /**
- * When a painting is rippling, this mesh is generated each frame using the Painting's parameters.
+ * When a painting is rippling, the movable vertices of this mesh are updated each frame using the
+ * Painting's parameters.
  *
  * This mesh only contains the vertex positions and normals.
  * Paintings use an additional array to map textures to the mesh.
  */
-struct PaintingMeshVertex *gPaintingMesh;
+struct PaintingMeshVertex gPaintingMesh[PAINTING_MESH_MAX_VTX];
 
 /**
  * The painting's surface normals, used to approximate each of the vertex normals (for gouraud shading).
+ * Unnormalized, since only their direction matters once they are averaged.
  */
-Vec3f *gPaintingTriNorms;
+Vec3i gPaintingTriNorms[PAINTING_MESH_MAX_TRIS];
+
+/**
+ * The parts of the ripple mesh that never change, built once from seg2_painting_triangle_mesh and
+ * seg2_painting_mesh_neighbor_tris.
+ */
+struct PaintingMeshTopology {
+    s16 numVtx;
+    s16 numTris;
+    s16 numMovableVtx;
+    s16 numDynamicTris;
+    s16 numDynamicVtx;
+    PaintingData *neighborTris;
+    s16 tris[PAINTING_MESH_MAX_TRIS][3];
+    s16 neighborEntry[PAINTING_MESH_MAX_VTX]; // Where each vertex's entry starts in neighborTris
+    s16 movableVtx[PAINTING_MESH_MAX_VTX];    // Vertices that move when rippling
+    s16 dynamicTris[PAINTING_MESH_MAX_TRIS];  // Triangles with at least one movable vertex
+    s16 dynamicVtx[PAINTING_MESH_MAX_VTX];    // Vertices next to at least one dynamic triangle
+};
+
+static struct PaintingMeshTopology sPaintingTopology;
+
+/**
+ * Distance from each movable vertex to a painting's ripple origin. These only change when a new ripple
+ * starts somewhere else, so they are kept around instead of being recomputed every frame.
+ */
+struct PaintingRippleOrigin {
+    struct Painting *painting;
+    f32 rippleX;
+    f32 rippleY;
+    f32 size;
+    f32 dist[PAINTING_MESH_MAX_VTX]; // Indexed like movableVtx
+};
+
+static struct PaintingRippleOrigin sRippleOrigins[PAINTING_RIPPLE_ORIGIN_CACHE_SIZE];
+static s32 sNextRippleOrigin = 0;
 
 /**
  * The painting that is currently rippling. Only one painting can be rippling at once.
@@ -608,133 +647,104 @@ void painting_update_ripple_state(struct Painting *painting) {
 }
 
 /**
- * @return the ripple function at posX, posY
- * note that posX and posY correspond to a point on the face of the painting, not actual axes
+ * Finds the distances from each movable vertex to the painting's ripple origin, computing them if
+ * the painting started rippling from somewhere new.
  */
-s16 calculate_ripple_at_point(struct Painting *painting, f32 posX, f32 posY) {
+f32 *painting_get_ripple_distances(struct Painting *painting) {
+    struct PaintingMeshTopology *topo = &sPaintingTopology;
+    struct PaintingRippleOrigin *origin;
+    f32 sizeRatio = painting->size / PAINTING_SIZE;
+    s16 i;
+
+    for (i = 0; i < PAINTING_RIPPLE_ORIGIN_CACHE_SIZE; i++) {
+        origin = &sRippleOrigins[i];
+        if (origin->painting == painting && origin->rippleX == painting->rippleX
+            && origin->rippleY == painting->rippleY && origin->size == painting->size) {
+            return origin->dist;
+        }
+    }
+
+    origin = &sRippleOrigins[sNextRippleOrigin];
+    sNextRippleOrigin = (sNextRippleOrigin + 1) % PAINTING_RIPPLE_ORIGIN_CACHE_SIZE;
+    origin->painting = painting;
+    origin->rippleX = painting->rippleX;
+    origin->rippleY = painting->rippleY;
+    origin->size = painting->size;
+    for (i = 0; i < topo->numMovableVtx; i++) {
+        struct PaintingMeshVertex *vtx = &gPaintingMesh[topo->movableVtx[i]];
+        f32 dx = vtx->pos[0] * sizeRatio - painting->rippleX;
+        f32 dy = vtx->pos[1] * sizeRatio - painting->rippleY;
+
+        origin->dist[i] = sqrtf(dx * dx + dy * dy);
+    }
+    return origin->dist;
+}
+
+/**
+ * Moves the mesh's movable vertices based on the painting's current ripple state.
+ *
+ * A point rests until the ripple reaches it, then follows a cosine wave scaled by the painting's
+ * ripple magnitude. The wave is read from the cosine lookup table rather than calling cosf.
+ */
+void painting_generate_mesh(struct Painting *painting) {
+    struct PaintingMeshTopology *topo = &sPaintingTopology;
+    f32 *dist = painting_get_ripple_distances(painting);
     /// Controls the peaks of the ripple.
     f32 rippleMag = painting->currRippleMag;
     /// Controls the ripple's frequency
     f32 rippleRate = painting->currRippleRate;
-    /// Controls how fast the ripple spreads
-    f32 dispersionFactor = painting->dispersionFactor;
     /// How far the ripple has spread
     f32 rippleTimer = painting->rippleTimer;
-    /// x and y ripple origin
-    f32 rippleX = painting->rippleX;
-    f32 rippleY = painting->rippleY;
-
-    f32 distanceToOrigin;
-    f32 rippleDistance;
-
-    posX *= painting->size / PAINTING_SIZE;
-    posY *= painting->size / PAINTING_SIZE;
-    distanceToOrigin = sqrtf((posX - rippleX) * (posX - rippleX) + (posY - rippleY) * (posY - rippleY));
-    // A larger dispersionFactor makes the ripple spread slower
-    rippleDistance = distanceToOrigin / dispersionFactor;
-    if (rippleTimer < rippleDistance) {
-        // if the ripple hasn't reached the point yet, make the point magnitude 0
-        return 0;
-    } else {
-        // use a cosine wave to make the ripple go up and down,
-        // scaled by the painting's ripple magnitude
-        f32 rippleZ = rippleMag * cosf(rippleRate * (2 * M_PI) * (rippleTimer - rippleDistance));
+    /// A larger dispersionFactor makes the ripple spread slower
+    f32 invDispersion = 1.0f / painting->dispersionFactor;
+    s16 i;
 
-        // round it to an int and return it
-        return round_float(rippleZ);
-    }
-}
+    for (i = 0; i < topo->numMovableVtx; i++) {
+        struct PaintingMeshVertex *vtx = &gPaintingMesh[topo->movableVtx[i]];
+        f32 rippleDistance = dist[i] * invDispersion;
 
-/**
- * If movable, return the ripple function at (posX, posY)
- * else return 0
- */
-s16 ripple_if_movable(struct Painting *painting, s16 movable, s16 posX, s16 posY) {
-    s16 rippleZ = 0;
+        if (rippleTimer < rippleDistance) {
+            // if the ripple hasn't reached the point yet, make the point magnitude 0
+            vtx->pos[2] = 0;
+        } else {
+            // Only the fraction of a cycle matters, which also keeps the angle in range on long ripples.
+            f32 cycles = rippleRate * (rippleTimer - rippleDistance);
 
-    if (movable) {
-        rippleZ = calculate_ripple_at_point(painting, posX, posY);
+            cycles -= (s32) cycles;
+            vtx->pos[2] = round_float(rippleMag * coss((s32)(cycles * 0x10000)));
+        }
     }
-    return rippleZ;
 }
 
 /**
- * Allocates and generates a mesh for the rippling painting effect by modifying the passed in `mesh`
- * based on the painting's current ripple state.
- *
- * The `mesh` table describes the location of mesh vertices, whether they move when rippling, and what
- * triangles they belong to.
- *
- * The static mesh passed in is organized into two lists. This function only uses the first list,
- * painting_calculate_triangle_normals below uses the second one.
- *
- * The first list describes the vertices in this format:
- *      numVertices
- *      v0 x, v0 y, movable
- *      ...
- *      vN x, vN y, movable
- *      Where x and y are from 0 to PAINTING_SIZE, movable is 0 or 1.
- *
- * The mesh used in game, seg2_painting_triangle_mesh, is in bin/segment2.c.
+ * Calculate the surface normal of a triangle in the ripple mesh.
  */
-void painting_generate_mesh(struct Painting *painting, s16 *mesh, s16 numTris) {
-    s16 i;
-
-    gPaintingMesh = mem_pool_alloc(gEffectsMemoryPool, numTris * sizeof(struct PaintingMeshVertex));
-
-    // accesses are off by 1 since the first entry is the number of vertices
-    for (i = 0; i < numTris; i++) {
-        gPaintingMesh[i].pos[0] = mesh[i * 3 + 1];
-        gPaintingMesh[i].pos[1] = mesh[i * 3 + 2];
-        // The "z coordinate" of each vertex in the mesh is either 1 or 0. Instead of being an
-        // actual coordinate, it just determines whether the vertex moves
-        gPaintingMesh[i].pos[2] = ripple_if_movable(painting, mesh[i * 3 + 3],
-                                                    gPaintingMesh[i].pos[0], gPaintingMesh[i].pos[1]);
-    }
+static void painting_calculate_triangle_normal(s16 tri) {
+    s16 *tv = sPaintingTopology.tris[tri];
+    s16 *p0 = gPaintingMesh[tv[0]].pos;
+    s16 *p1 = gPaintingMesh[tv[1]].pos;
+    s16 *p2 = gPaintingMesh[tv[2]].pos;
+    s32 ax = p1[0] - p0[0];
+    s32 ay = p1[1] - p0[1];
+    s32 az = p1[2] - p0[2];
+    s32 bx = p2[0] - p1[0];
+    s32 by = p2[1] - p1[1];
+    s32 bz = p2[2] - p1[2];
+
+    // Cross product to find the triangle's normal vector
+    gPaintingTriNorms[tri][0] = ay * bz - az * by;
+    gPaintingTriNorms[tri][1] = az * bx - ax * bz;
+    gPaintingTriNorms[tri][2] = ax * by - ay * bx;
 }
 
 /**
- * Calculate the surface normals of each triangle in the generated ripple mesh.
- *
- * The static mesh passed in is organized into two lists. This function uses the second list,
- * painting_generate_mesh above uses the first one.
- *
- * The second list in `mesh` describes the mesh's triangles in this format:
- *      numTris
- *      tri0 v0, tri0 v1, tri0 v2
- *      ...
- *      triN v0, triN v1, triN v2
- *      Where each v0, v1, v2 is an index into the first list in `mesh`.
- *
- * The mesh used in game, seg2_painting_triangle_mesh, is in bin/segment2.c.
+ * Calculate the surface normals of the triangles the ripple can move.
  */
-void painting_calculate_triangle_normals(PaintingData *mesh, PaintingData numVtx, PaintingData numTris) {
+void painting_calculate_triangle_normals(void) {
     s16 i;
 
-    gPaintingTriNorms = mem_pool_alloc(gEffectsMemoryPool, numTris * sizeof(Vec3f));
-
-    for (i = 0; i < numTris; i++) {
-        s16 tri = numVtx * 3 + i * 3 + 2; // Add 2 because of the 2 length entries preceding the list
-        s16 v0 = mesh[tri];
-        s16 v1 = mesh[tri + 1];
-        s16 v2 = mesh[tri + 2];
-
-        f32 x0 = gPaintingMesh[v0].pos[0];
-        f32 y0 = gPaintingMesh[v0].pos[1];
-        f32 z0 = gPaintingMesh[v0].pos[2];
-
-        f32 x1 = gPaintingMesh[v1].pos[0];
-        f32 y1 = gPaintingMesh[v1].pos[1];
-        f32 z1 = gPaintingMesh[v1].pos[2];
-
-        f32 x2 = gPaintingMesh[v2].pos[0];
-        f32 y2 = gPaintingMesh[v2].pos[1];
-        f32 z2 = gPaintingMesh[v2].pos[2];
-
-        // Cross product to find each triangle's normal vector
-        gPaintingTriNorms[i][0] = (y1 - y0) * (z2 - z1) - (z1 - z0) * (y2 - y1);
-        gPaintingTriNorms[i][1] = (z1 - z0) * (x2 - x1) - (x1 - x0) * (z2 - z1);
-        gPaintingTriNorms[i][2] = (x1 - x0) * (y2 - y1) - (y1 - y0) * (x2 - x1);
+    for (i = 0; i < sPaintingTopology.numDynamicTris; i++) {
+        painting_calculate_triangle_normal(sPaintingTopology.dynamicTris[i]);
     }
 }
 
@@ -756,60 +766,149 @@ s8 normalize_component(f32 comp) {
 }
 
 /**
- * Approximates the painting mesh's vertex normals by averaging the normals of all triangles sharing a
- * vertex. Used for Gouraud lighting.
+ * Approximates a vertex normal by averaging the normals of all triangles sharing the vertex.
+ * Used for Gouraud lighting.
+ */
+static void painting_average_vertex_normal(s16 vtx) {
+    PaintingData *neighborTris = &sPaintingTopology.neighborTris[sPaintingTopology.neighborEntry[vtx]];
+    s16 neighbors = neighborTris[0];
+    s32 nx = 0;
+    s32 ny = 0;
+    s32 nz = 0;
+    f32 nlen;
+    s16 j;
+
+    for (j = 0; j < neighbors; j++) {
+        s16 tri = neighborTris[j + 1];
+
+        nx += gPaintingTriNorms[tri][0];
+        ny += gPaintingTriNorms[tri][1];
+        nz += gPaintingTriNorms[tri][2];
+    }
+    nlen = sqrtf((f32) nx * nx + (f32) ny * ny + (f32) nz * nz);
+
+    if (nlen == 0.0f) {
+        vec3_zero(gPaintingMesh[vtx].norm);
+    } else {
+        nlen = 1.0f / nlen;
+        gPaintingMesh[vtx].norm[0] = normalize_component(nx * nlen);
+        gPaintingMesh[vtx].norm[1] = normalize_component(ny * nlen);
+        gPaintingMesh[vtx].norm[2] = normalize_component(nz * nlen);
+    }
+}
+
+/**
+ * Updates the vertex normals next to any triangle the ripple can move.
+ */
+void painting_average_vertex_normals(void) {
+    s16 i;
+
+    for (i = 0; i < sPaintingTopology.numDynamicVtx; i++) {
+        painting_average_vertex_normal(sPaintingTopology.dynamicVtx[i]);
+    }
+}
+
+/**
+ * Builds the static ripple mesh topology the first time a painting ripples.
  *
- * After each triangle's surface normal is calculated, the `neighborTris` table describes which triangles
- * each vertex should use when calculating the average normal vector.
+ * The static mesh is organized into two lists. The first one describes the vertices in this format:
+ *      numVertices
+ *      v0 x, v0 y, movable
+ *      ...
+ *      vN x, vN y, movable
+ *      Where x and y are from 0 to PAINTING_SIZE, movable is 0 or 1.
  *
- * The table is a list of entries in this format:
+ * The second list describes the mesh's triangles in this format:
+ *      numTris
+ *      tri0 v0, tri0 v1, tri0 v2
+ *      ...
+ *      triN v0, triN v1, triN v2
+ *      Where each v0, v1, v2 is an index into the first list.
+ *
+ * The `neighborTris` table describes which triangles each vertex should use when calculating the
+ * average normal vector. It is a list of entries in this format:
  *      numNeighbors, tri0, tri1, ..., triN
  *
  *      Where each 'tri' is an index into gPaintingTriNorms.
  *      Entry i in `neighborTris` corresponds to the vertex at gPaintingMesh[i]
  *
- * The table used in game, seg2_painting_mesh_neighbor_tris, is in bin/segment2.c.
+ * The mesh used in game, seg2_painting_triangle_mesh, and its neighbor table,
+ * seg2_painting_mesh_neighbor_tris, are in bin/segment2.c.
+ *
+ * The flat mesh's normals are calculated here too. Triangles without a movable vertex, and vertices
+ * not touching a movable triangle, then never need to be updated again.
+ *
+ * @return FALSE if the mesh doesn't fit in the preallocated arrays.
  */
-void painting_average_vertex_normals(PaintingData *neighborTris, PaintingData numVtx) {
-    s16 tri;
-    s16 i;
-    s16 j;
-    s16 neighbors;
+s32 painting_init_mesh_topology(void) {
+    struct PaintingMeshTopology *topo = &sPaintingTopology;
+    PaintingData *mesh = segmented_to_virtual(seg2_painting_triangle_mesh);
+    u8 movable[PAINTING_MESH_MAX_VTX];
+    u8 dynamicVtx[PAINTING_MESH_MAX_VTX];
+    s16 numVtx = mesh[0];
+    s16 numTris = mesh[numVtx * 3 + 1];
     s16 entry = 0;
+    s16 i, j;
+
+    if (topo->numVtx != 0) {
+        return TRUE;
+    }
+    assert(numVtx <= PAINTING_MESH_MAX_VTX && numTris <= PAINTING_MESH_MAX_TRIS, "Painting mesh is too large");
+    if (numVtx > PAINTING_MESH_MAX_VTX || numTris > PAINTING_MESH_MAX_TRIS) {
+        return FALSE;
+    }
+    topo->neighborTris = segmented_to_virtual(seg2_painting_mesh_neighbor_tris);
+    topo->numMovableVtx = 0;
+    topo->numDynamicTris = 0;
+    topo->numDynamicVtx = 0;
+    bzero(dynamicVtx, sizeof(dynamicVtx));
+
+    // accesses are off by 1 since the first entry is the number of vertices
+    for (i = 0; i < numVtx; i++) {
+        gPaintingMesh[i].pos[0] = mesh[i * 3 + 1];
+        gPaintingMesh[i].pos[1] = mesh[i * 3 + 2];
+        gPaintingMesh[i].pos[2] = 0;
+        // The "z coordinate" of each vertex in the mesh is either 1 or 0. Instead of being an
+        // actual coordinate, it just determines whether the vertex moves
+        movable[i] = mesh[i * 3 + 3];
+        if (movable[i]) {
+            topo->movableVtx[topo->numMovableVtx++] = i;
+        }
+    }
+
+    for (i = 0; i < numTris; i++) {
+        s16 tri = numVtx * 3 + i * 3 + 2; // Add 2 because of the 2 length entries preceding the list
+
+        for (j = 0; j < 3; j++) {
+            topo->tris[i][j] = mesh[tri + j];
+        }
+        painting_calculate_triangle_normal(i);
+        if (movable[topo->tris[i][0]] || movable[topo->tris[i][1]] || movable[topo->tris[i][2]]) {
+            topo->dynamicTris[topo->numDynamicTris++] = i;
+        }
+    }
 
     for (i = 0; i < numVtx; i++) {
-        f32 nx = 0.0f;
-        f32 ny = 0.0f;
-        f32 nz = 0.0f;
-        f32 nlen;
-
-        // The first number of each entry is the number of adjacent tris
-        neighbors = neighborTris[entry];
-        for (j = 0; j < neighbors; j++) {
-            tri = neighborTris[entry + j + 1];
-            nx += gPaintingTriNorms[tri][0];
-            ny += gPaintingTriNorms[tri][1];
-            nz += gPaintingTriNorms[tri][2];
+        topo->neighborEntry[i] = entry;
+        for (j = 0; j < topo->neighborTris[entry]; j++) {
+            s16 *tv = topo->tris[topo->neighborTris[entry + j + 1]];
+
+            if (movable[tv[0]] || movable[tv[1]] || movable[tv[2]]) {
+                dynamicVtx[i] = TRUE;
+            }
         }
         // Move to the next vertex's entry
-        entry += neighbors + 1;
-
-        // average the surface normals from each neighboring tri
-        nx /= neighbors;
-        ny /= neighbors;
-        nz /= neighbors;
-        nlen = sqrtf(nx * nx + ny * ny + nz * nz);
-
-        if (nlen == 0.0f) {
-            gPaintingMesh[i].norm[0] = 0;
-            gPaintingMesh[i].norm[1] = 0;
-            gPaintingMesh[i].norm[2] = 0;
-        } else {
-            gPaintingMesh[i].norm[0] = normalize_component(nx / nlen);
-            gPaintingMesh[i].norm[1] = normalize_component(ny / nlen);
-            gPaintingMesh[i].norm[2] = normalize_component(nz / nlen);
+        entry += topo->neighborTris[entry] + 1;
+
+        painting_average_vertex_normal(i);
+        if (dynamicVtx[i]) {
+            topo->dynamicVtx[topo->numDynamicVtx++] = i;
         }
     }
+
+    topo->numTris = numTris;
+    topo->numVtx = numVtx;
+    return TRUE;
 }
 
 /**
@@ -998,20 +1097,20 @@ Gfx *painting_ripple_env_mapped(struct Painting *painting) {
 }
 
 /**
- * Generates a mesh, calculates vertex normals for lighting, and renders a rippling painting.
- * The mesh and vertex normals are regenerated and freed every frame.
+ * Updates the mesh, recalculates vertex normals for lighting, and renders a rippling painting.
+ * Only the parts of the mesh that the ripple can move are updated every frame.
  */
 Gfx *display_painting_rippling(struct Painting *painting) {
-    s16 *mesh = segmented_to_virtual(seg2_painting_triangle_mesh);
-    s16 *neighborTris = segmented_to_virtual(seg2_painting_mesh_neighbor_tris);
-    s16 numVtx = mesh[0];
-    s16 numTris = mesh[numVtx * 3 + 1];
     Gfx *dlist = NULL;
 
-    // Generate the mesh and its lighting data
-    painting_generate_mesh(painting, mesh, numVtx);
-    painting_calculate_triangle_normals(mesh, numVtx, numTris);
-    painting_average_vertex_normals(neighborTris, numVtx);
+    if (!painting_init_mesh_topology()) {
+        return NULL;
+    }
+
+    // Update the mesh and its lighting data
+    painting_generate_mesh(painting);
+    painting_calculate_triangle_normals();
+    painting_average_vertex_normals();
 
     // Map the painting's texture depending on the painting's texture type.
     switch (painting->textureType) {
@@ -1022,10 +1121,6 @@ Gfx *display_painting_rippling(struct Painting *painting) {
             dlist = painting_ripple_env_mapped(painting);
             break;
     }
-
-    // The mesh data is freed every frame.
-    mem_pool_free(gEffectsMemoryPool, gPaintingMesh);
-    mem_pool_free(gEffectsMemoryPool, gPaintingTriNorms);
     return dlist;
 }
 
@@ -1225,6 +1320,10 @@ Gfx *geo_painting_draw(s32 callContext, struct GraphNode *node, UNUSED void *con
 
     if (callContext != GEO_CONTEXT_RENDER) {
         reset_painting(painting);
+    } else if (IS_INTERP_FRAME()) {
+        // The frames between game steps draw the painting as it is, without moving or updating it
+        set_painting_layer(gen, painting);
+        paintingDlist = display_painting(painting);
     } else if (callContext == GEO_CONTEXT_RENDER) {
 
         // Update the ddd painting before drawing
@@ -125,6 +125,13 @@ struct Painting {
     f32 size;
 };
 
+// Capacity of the ripple mesh. seg2_painting_triangle_mesh has 157 vertices and 264 triangles.
+#define PAINTING_MESH_MAX_VTX  160
+#define PAINTING_MESH_MAX_TRIS 272
+
+// How many ripple origins keep their precomputed vertex distances, for when several paintings ripple at once.
+#define PAINTING_RIPPLE_ORIGIN_CACHE_SIZE 4
+
 /**
  * Contains the position and normal of a vertex in the painting's generated mesh.
  */
@@ -133,8 +140,8 @@ struct PaintingMeshVertex {
     /*0x06*/ Vec3c norm;
 };
 
-extern struct PaintingMeshVertex *gPaintingMesh;
-extern Vec3f *gPaintingTriNorms;
+extern struct PaintingMeshVertex gPaintingMesh[PAINTING_MESH_MAX_VTX];
+extern Vec3i gPaintingTriNorms[PAINTING_MESH_MAX_TRIS];
 extern struct Painting *gRipplingPainting;
 extern s8 gDddPaintingStatus;
 
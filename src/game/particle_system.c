@@ -0,0 +1,475 @@
+#include <ultra64.h>
+
+#include "sm64.h"
+#include "actors/common1.h"
+#include "actors/group0.h"
+#include "engine/math_util.h"
+#include "envfx_snow.h"
+#include "memory.h"
+#include "model_ids.h"
+#include "object_list_processor.h"
+#include "particle_system.h"
+#include "rendering_graph_node.h"
+#include "textures.h"
+
+/**
+ * Particles that don't need to be objects: the environment effects (snow, lava bubbles, ...) and
+ * the puffs spawned by cur_obj_spawn_particles. They live in one pool with a field per array
+ * (struct ParticlePool), are moved in one pass after the objects are updated, and are drawn from
+ * geo_process_camera as one vertex buffer per frame, sorted by material so that every texture is
+ * only loaded once.
+ */
+
+// Animated materials have at most this many frames.
+#define PARTICLE_MAX_FRAMES 9
+#define PARTICLE_NUM_BUCKETS (PARTICLE_MAT_COUNT * PARTICLE_MAX_FRAMES)
+
+// Particles per gSPVertex load, 15 vertices for triangles and 16 for quads.
+#define PARTICLE_TRI_BATCH  5
+#define PARTICLE_QUAD_BATCH 4
+
+struct ParticleMaterialInfo {
+    const Gfx *beginDL;
+    // For animated materials, a segmented pointer to the array of frame textures, and the list
+    // loading the frame set with gDPSetTextureImage.
+    const Texture *const *frames;
+    const Gfx *frameDL;
+    const Gfx *endDL;
+    const Vtx *template;
+    u8 numVerts; // 3 or 4
+    u8 layer;
+};
+
+ALIGNED16 struct ParticlePool gParticles;
+
+// The envfx templates are drawn at their actual size, the others are scaled like the object models
+// they replace.
+static const Vtx sSnowTemplate[3] = {
+    { { { -5,  5, 0 }, 0, {   0,   0 }, { 0x7F, 0x7F, 0x7F, 0xFF } } },
+    { { { -5, -5, 0 }, 0, {   0, 960 }, { 0x7F, 0x7F, 0x7F, 0xFF } } },
+    { { {  5,  5, 0 }, 0, { 960,   0 }, { 0x7F, 0x7F, 0x7F, 0xFF } } },
+};
+
+static const Vtx sFlowerTemplate[3] = {
+    { { {  50,  0, 0 }, 0, { 1544,  964 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+    { { {   0, 75, 0 }, 0, {  522, -568 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+    { { { -50,  0, 0 }, 0, { -498,  964 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+};
+
+static const Vtx sLavaBubbleTemplate[3] = {
+    { { {  100,   0, 0 }, 0, { 1544,  964 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+    { { {    0, 150, 0 }, 0, {  522, -568 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+    { { { -100,   0, 0 }, 0, { -498,  964 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+};
+
+static const Vtx sBubbleTemplate[3] = {
+    { { {  40,  0, 0 }, 0, { 1544,  964 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+    { { {   0, 60, 0 }, 0, {  522, -568 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+    { { { -40,  0, 0 }, 0, { -498,  964 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+};
+
+static const Vtx sWhiteParticleTemplate[4] = {
+    { { { -15, -15, 0 }, 0, {   0, 480 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+    { { {  15, -15, 0 }, 0, { 480, 480 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+    { { {  15,  15, 0 }, 0, { 480,   0 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+    { { { -15,  15, 0 }, 0, {   0,   0 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+};
+
+static const Vtx sWhiteParticleSmallTemplate[4] = {
+    { { { -4, 0, 0 }, 0, {   0, 960 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+    { { {  4, 0, 0 }, 0, { 960, 960 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+    { { {  4, 8, 0 }, 0, { 960,   0 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+    { { { -4, 8, 0 }, 0, {   0,   0 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+};
+
+static const Vtx sSandTemplate[4] = {
+    { { { -8, -8, 0 }, 0, {   0, 480 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+    { { {  8, -8, 0 }, 0, { 480, 480 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+    { { {  8,  8, 0 }, 0, { 480,   0 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+    { { { -8,  8, 0 }, 0, {   0,   0 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+};
+
+static const Vtx sMistTemplate[4] = {
+    { { { -25, -25, 0 }, 0, {   0, 992 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+    { { {  25, -25, 0 }, 0, { 992, 992 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+    { { {  25,  25, 0 }, 0, { 992,   0 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+    { { { -25,  25, 0 }, 0, {   0,   0 }, { 0xFF, 0xFF, 0xFF, 0xFF } } },
+};
+
+static const Gfx dl_particle_end[] = {
+    gsDPPipeSync(),
+    gsSPTexture(0x0001, 0x0001, 0, G_TX_RENDERTILE, G_OFF),
+    gsDPSetCombineMode(G_CC_SHADE, G_CC_SHADE),
+    gsSPSetGeometryMode(G_LIGHTING),
+    gsSPEndDisplayList(),
+};
+
+static const struct ParticleMaterialInfo sParticleMaterials[PARTICLE_MAT_COUNT] = {
+    [PARTICLE_MAT_SNOW] = {
+        tiny_bubble_dl_0B006A50, NULL, NULL, tiny_bubble_dl_0B006AB0, sSnowTemplate, 3, LAYER_OCCLUDE_SILHOUETTE_ALPHA,
+    },
+    [PARTICLE_MAT_SNOW_WATER] = {
+        tiny_bubble_dl_0B006CD8, NULL, NULL, tiny_bubble_dl_0B006AB0, sSnowTemplate, 3, LAYER_OCCLUDE_SILHOUETTE_ALPHA,
+    },
+    [PARTICLE_MAT_FLOWER] = {
+        tiny_bubble_dl_0B006D38, flower_bubbles_textures_ptr_0B002008, tiny_bubble_dl_0B006D68, tiny_bubble_dl_0B006AB0,
+        sFlowerTemplate, 3, LAYER_OCCLUDE_SILHOUETTE_ALPHA,
+    },
+    [PARTICLE_MAT_LAVA_BUBBLE] = {
+        tiny_bubble_dl_0B006D38, lava_bubble_ptr_0B006020, tiny_bubble_dl_0B006D68, tiny_bubble_dl_0B006AB0,
+        sLavaBubbleTemplate, 3, LAYER_OCCLUDE_SILHOUETTE_ALPHA,
+    },
+    [PARTICLE_MAT_BUBBLE] = {
+        tiny_bubble_dl_0B006D38, bubble_ptr_0B006848, tiny_bubble_dl_0B006D68, tiny_bubble_dl_0B006AB0,
+        sBubbleTemplate, 3, LAYER_OCCLUDE_SILHOUETTE_ALPHA,
+    },
+    [PARTICLE_MAT_WHITE_PARTICLE] = {
+        white_particle_dl_begin, NULL, NULL, dl_particle_end, sWhiteParticleTemplate, 4, LAYER_OCCLUDE_SILHOUETTE_ALPHA,
+    },
+    [PARTICLE_MAT_WHITE_PARTICLE_SMALL] = {
+        white_particle_small_dl_begin, NULL, NULL, dl_particle_end, sWhiteParticleSmallTemplate, 4, LAYER_OCCLUDE_SILHOUETTE_ALPHA,
+    },
+    [PARTICLE_MAT_SAND] = {
+        sand_particle_dl_begin, NULL, NULL, dl_particle_end, sSandTemplate, 4, LAYER_OCCLUDE_SILHOUETTE_ALPHA,
+    },
+    [PARTICLE_MAT_MIST] = {
+        mist_particle_dl_begin, NULL, NULL, dl_particle_end, sMistTemplate, 4, LAYER_TRANSPARENT,
+    },
+};
+
+/**
+ * Return the material that draws the same image as the given model, or PARTICLE_MAT_NONE if the
+ * model has to be spawned as an object.
+ */
+s32 particles_material_from_model(ModelID16 model) {
+    switch (model) {
+        case MODEL_MIST:                 return PARTICLE_MAT_MIST;
+        case MODEL_SAND_DUST:            return PARTICLE_MAT_SAND;
+        case MODEL_WHITE_PARTICLE:
+        case MODEL_WHITE_PARTICLE_DL:    return PARTICLE_MAT_WHITE_PARTICLE;
+        case MODEL_WHITE_PARTICLE_SMALL: return PARTICLE_MAT_WHITE_PARTICLE_SMALL;
+        default:                         return PARTICLE_MAT_NONE;
+    }
+}
+
+/**
+ * Spawn emitter->count particles around pos. Returns how many were spawned, which can be less
+ * when the pool or the per frame budget runs out.
+ */
+s32 particles_emit(const struct ParticleEmitter *emitter, Vec3f pos) {
+    struct ParticlePool *p = &gParticles;
+    s32 count = emitter->count;
+    s32 i;
+
+    count = MIN(count, PARTICLE_POOL_CAPACITY - PARTICLE_ENVFX_CAPACITY - p->numEmitted);
+    count = MIN(count, PARTICLE_EMIT_BUDGET - p->emittedThisFrame);
+
+    for (i = 0; i < count; i++) {
+        s32 index = PARTICLE_ENVFX_CAPACITY + p->numEmitted++;
+        // Same order of random calls as the particle objects.
+        f32 size = random_float() * (emitter->sizeRange * 0.1f) + emitter->sizeBase * 0.1f;
+        s16 yaw = random_u16();
+        f32 forwardVel = random_float() * emitter->forwardVelRange + emitter->forwardVelBase;
+
+        p->posX[index] = pos[0];
+        p->posY[index] = pos[1] + emitter->offsetY;
+        p->posZ[index] = pos[2];
+        p->velX[index] = forwardVel * sins(yaw);
+        p->velY[index] = random_float() * emitter->velYRange + emitter->velYBase;
+        p->velZ[index] = forwardVel * coss(yaw);
+        p->size[index] = size;
+        p->baseSize[index] = size;
+        p->material[index] = emitter->material;
+        p->frame[index] = 0;
+        p->alpha[index] = emitter->alpha;
+        p->alphaStep[index] = emitter->alphaStep;
+        p->flags[index] = (PARTICLE_FLAG_ALIVE | emitter->flags);
+        p->gravity[index] = emitter->gravity;
+        p->drag[index] = emitter->dragStrength;
+        p->timer[index] = emitter->lifetime;
+    }
+
+    p->emittedThisFrame += count;
+    return count;
+}
+
+void particles_clear(void) {
+    gParticles.numEnvFx = 0;
+    gParticles.numEmitted = 0;
+    gParticles.emittedThisFrame = 0;
+}
+
+static void particle_move(s32 dst, s32 src) {
+    struct ParticlePool *p = &gParticles;
+
+    p->posX[dst] = p->posX[src];
+    p->posY[dst] = p->posY[src];
+    p->posZ[dst] = p->posZ[src];
+    p->velX[dst] = p->velX[src];
+    p->velY[dst] = p->velY[src];
+    p->velZ[dst] = p->velZ[src];
+    p->size[dst] = p->size[src];
+    p->baseSize[dst] = p->baseSize[src];
+    p->material[dst] = p->material[src];
+    p->frame[dst] = p->frame[src];
+    p->alpha[dst] = p->alpha[src];
+    p->alphaStep[dst] = p->alphaStep[src];
+    p->flags[dst] = p->flags[src];
+    p->gravity[dst] = p->gravity[src];
+    p->drag[dst] = p->drag[src];
+    p->timer[dst] = p->timer[src];
+}
+
+/**
+ * Same as apply_drag_to_value in object_helpers.c.
+ */
+static f32 particle_apply_drag(f32 value, f32 dragStrength) {
+    f32 decel = sqr(value) * dragStrength;
+
+    if (value > 0.0f) {
+        value -= decel;
+        if (value < 0.001f) {
+            value = 0.0f;
+        }
+    } else if (value < 0.0f) {
+        value += decel;
+        if (value > -0.001f) {
+            value = 0.0f;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * Move the emitted particles the way bhv_white_puff_exploding_loop moved the objects, and remove
+ * the ones that ran out of time or faded out. Dead particles are replaced by the last one so that
+ * the emitted range stays packed. Called once per frame after the objects are updated.
+ */
+void particles_update(void) {
+    struct ParticlePool *p = &gParticles;
+    s32 end = PARTICLE_ENVFX_CAPACITY + p->numEmitted;
+    s32 i = PARTICLE_ENVFX_CAPACITY;
+
+    p->emittedThisFrame = 0;
+
+    // Frozen like the objects they replace.
+    if (gTimeStopState & TIME_STOP_ACTIVE) {
+        return;
+    }
+
+    while (i < end) {
+        s32 alpha = p->alpha[i];
+        s32 dead = (p->timer[i]-- == 0);
+
+        p->velY[i] += p->gravity[i];
+        p->posX[i] += p->velX[i];
+        p->posY[i] += p->velY[i];
+        p->posZ[i] += p->velZ[i];
+        p->velX[i] = particle_apply_drag(p->velX[i], p->drag[i] * 0.0001f);
+        p->velZ[i] = particle_apply_drag(p->velZ[i], p->drag[i] * 0.0001f);
+
+        if (p->velY[i] > 100.0f) {
+            p->velY[i] = 100.0f;
+        }
+
+        if (p->alphaStep[i] != 0) {
+            alpha += p->alphaStep[i];
+            if (alpha < 2) {
+                dead = TRUE;
+            } else {
+                p->alpha[i] = alpha;
+                if (p->flags[i] & PARTICLE_FLAG_SLOW_FADE) {
+                    p->size[i] = p->baseSize[i] * ((254 - alpha) / 254.0f);
+                } else {
+                    p->size[i] = p->baseSize[i] * (alpha / 254.0f);
+                }
+            }
+        }
+
+        if (dead) {
+            end--;
+            particle_move(i, end);
+        } else {
+            i++;
+        }
+    }
+
+    p->numEmitted = end - PARTICLE_ENVFX_CAPACITY;
+}
+
+/**
+ * Append the triangles for 'count' particles whose vertices start at 'vtx' to the display list.
+ */
+static Gfx *particles_append_triangles(Gfx *gfx, Vtx *vtx, s32 count, s32 numVerts) {
+    s32 batch = (numVerts == 3) ? PARTICLE_TRI_BATCH : PARTICLE_QUAD_BATCH;
+    s32 i, j;
+
+    for (i = 0; i < count; i += batch) {
+        s32 n = MIN(batch, count - i);
+
+        gSPVertex(gfx++, VIRTUAL_TO_PHYSICAL(vtx + i * numVerts), n * numVerts, 0);
+        for (j = 0; j < n * numVerts; j += numVerts) {
+            if (numVerts == 3) {
+                gSP1Triangle(gfx++, j, j + 1, j + 2, 0x0);
+            } else {
+                gSP2Triangles(gfx++, j, j + 1, j + 2, 0x0, j, j + 2, j + 3, 0x0);
+            }
+        }
+    }
+
+    return gfx;
+}
+
+/**
+ * Build and append the display lists drawing every particle, facing the camera. Has to be called
+ * while the camera's matrix is on top of the stack since particle positions are in world space.
+ */
+void particles_render(Vec3f camPos, Vec3f camFocus) {
+    struct ParticlePool *p = &gParticles;
+    // Kept off the stack, which the graph traversal already uses a lot of
+    static u16 bucketStart[PARTICLE_NUM_BUCKETS + 1];
+    static u16 order[PARTICLE_DRAW_BUDGET];
+    static u16 slots[PARTICLE_DRAW_BUDGET];
+    static u8 bucketOf[PARTICLE_DRAW_BUDGET];
+    static Vec3f corners[PARTICLE_MAT_COUNT][4];
+    Vec3s from, to;
+    s16 radius, pitch, yaw;
+    f32 cosPitch, sinPitch, cosMYaw, sinMYaw;
+    s32 numDrawn = 0;
+    s32 numVerts = 0;
+    s32 numUsedBuckets = 0;
+    s32 layerPass, i, j, b;
+    Vtx *vtxStart, *vtx;
+
+    // The environment effect sets its count again whenever it updates, once per area update. The count
+    // is kept for the in between frames drawn with UNLOCK_FPS, which don't update it.
+    if (p->envFxUpdate != gAreaUpdateCounter) {
+        p->numEnvFx = 0;
+    }
+    for (i = 0; i < p->numEnvFx && numDrawn < PARTICLE_DRAW_BUDGET; i++) {
+        slots[numDrawn++] = i;
+    }
+    for (i = 0; i < p->numEmitted && numDrawn < PARTICLE_DRAW_BUDGET; i++) {
+        slots[numDrawn++] = PARTICLE_ENVFX_CAPACITY + i;
+    }
+
+    if (numDrawn == 0) {
+        return;
+    }
+
+    // Counting sort by material and frame
+    bzero(bucketStart, sizeof(bucketStart));
+    for (i = 0; i < numDrawn; i++) {
+        s32 index = slots[i];
+
+        bucketOf[i] = p->material[index] * PARTICLE_MAX_FRAMES + p->frame[index];
+        bucketStart[bucketOf[i] + 1]++;
+        numVerts += sParticleMaterials[p->material[index]].numVerts;
+    }
+    for (b = 0; b < PARTICLE_NUM_BUCKETS; b++) {
+        if (bucketStart[b + 1] != 0) {
+            numUsedBuckets++;
+        }
+        bucketStart[b + 1] += bucketStart[b];
+    }
+    for (i = 0; i < numDrawn; i++) {
+        order[bucketStart[bucketOf[i]]++] = slots[i];
+    }
+    // The fill moved every start to the next bucket's start
+    for (b = PARTICLE_NUM_BUCKETS; b > 0; b--) {
+        bucketStart[b] = bucketStart[b - 1];
+    }
+    bucketStart[0] = 0;
+
+    // Rotate each template once. Note: to and from are inverted, so the vector goes towards the camera.
+    vec3f_to_vec3s(from, camFocus);
+    vec3f_to_vec3s(to, camPos);
+    orbit_from_positions(from, to, &radius, &pitch, &yaw);
+    cosPitch = coss(pitch);
+    sinPitch = sins(pitch);
+    cosMYaw = coss(-yaw);
+    sinMYaw = sins(-yaw);
+    for (i = 0; i < PARTICLE_MAT_COUNT; i++) {
+        const struct ParticleMaterialInfo *mat = &sParticleMaterials[i];
+
+        for (j = 0; j < mat->numVerts; j++) {
+            f32 x = mat->template[j].v.ob[0];
+            f32 y = mat->template[j].v.ob[1];
+
+            corners[i][j][0] = x * cosMYaw + y * (sinPitch * sinMYaw);
+            corners[i][j][1] = y * cosPitch;
+            corners[i][j][2] = x * sinMYaw - y * (sinPitch * cosMYaw);
+        }
+    }
+
+    vtxStart = alloc_display_list(numVerts * sizeof(Vtx));
+    if (vtxStart == NULL) {
+        return;
+    }
+
+    vtx = vtxStart;
+    for (layerPass = 0; layerPass < 2; layerPass++) {
+        s32 layer = (layerPass == 0) ? LAYER_OCCLUDE_SILHOUETTE_ALPHA : LAYER_TRANSPARENT;
+        Gfx *gfxStart = NULL;
+        Gfx *gfx = NULL;
+        s32 prevMaterial = -1;
+
+        for (b = 0; b < PARTICLE_NUM_BUCKETS; b++) {
+            s32 material = b / PARTICLE_MAX_FRAMES;
+            s32 frame = b % PARTICLE_MAX_FRAMES;
+            const struct ParticleMaterialInfo *mat = &sParticleMaterials[material];
+            s32 count = bucketStart[b + 1] - bucketStart[b];
+            Vtx *bucketVtx = vtx;
+
+            if (count == 0 || mat->layer != layer) {
+                continue;
+            }
+
+            if (gfxStart == NULL) {
+                gfxStart = alloc_display_list((2 * numDrawn + 5 * numUsedBuckets + 2) * sizeof(Gfx));
+                if (gfxStart == NULL) {
+                    return;
+                }
+                gfx = gfxStart;
+            }
+
+            if (material != prevMaterial) {
+                if (prevMaterial >= 0) {
+                    gSPDisplayList(gfx++, sParticleMaterials[prevMaterial].endDL);
+                }
+                gSPDisplayList(gfx++, mat->beginDL);
+                prevMaterial = material;
+            }
+            if (mat->frames != NULL) {
+                const Texture *const *frames = segmented_to_virtual(mat->frames);
+
+                gDPPipeSync(gfx++);
+                gDPSetTextureImage(gfx++, G_IM_FMT_RGBA, G_IM_SIZ_16b, 1, frames[frame]);
+                gSPDisplayList(gfx++, mat->frameDL);
+            }
+
+            for (i = bucketStart[b]; i < bucketStart[b + 1]; i++) {
+                s32 index = order[i];
+                f32 size = p->size[index];
+
+                for (j = 0; j < mat->numVerts; j++) {
+                    *vtx = mat->template[j];
+                    vtx->v.ob[0] = p->posX[index] + corners[material][j][0] * size;
+                    vtx->v.ob[1] = p->posY[index] + corners[material][j][1] * size;
+                    vtx->v.ob[2] = p->posZ[index] + corners[material][j][2] * size;
+                    vtx->v.cn[3] = p->alpha[index];
+                    vtx++;
+                }
+            }
+
+            gfx = particles_append_triangles(gfx, bucketVtx, count, mat->numVerts);
+        }
+
+        if (gfxStart != NULL) {
+            gSPDisplayList(gfx++, sParticleMaterials[prevMaterial].endDL);
+            gSPEndDisplayList(gfx++);
+            geo_append_display_list((void *) VIRTUAL_TO_PHYSICAL(gfxStart), layer);
+        }
+    }
+}
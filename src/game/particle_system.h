@@ -0,0 +1,101 @@
+#ifndef PARTICLE_SYSTEM_H
+#define PARTICLE_SYSTEM_H
+
+#include <PR/ultratypes.h>
+
+#include "types.h"
+
+// The first PARTICLE_ENVFX_CAPACITY slots belong to the environment effect (envfx_snow.c / envfx_bubbles.c),
+// the rest are handed out to emitters.
+#define PARTICLE_ENVFX_CAPACITY 140
+#define PARTICLE_POOL_CAPACITY  (PARTICLE_ENVFX_CAPACITY + 160)
+// Most particles that can be emitted per frame, and drawn per frame. Particles past the draw budget
+// are still simulated.
+#define PARTICLE_EMIT_BUDGET    40
+#define PARTICLE_DRAW_BUDGET    240
+
+enum ParticleMaterial {
+    PARTICLE_MAT_SNOW,           // Snowflake with a gray edge
+    PARTICLE_MAT_SNOW_WATER,     // Snowflake with a blue edge
+    PARTICLE_MAT_FLOWER,         // Animated
+    PARTICLE_MAT_LAVA_BUBBLE,    // Animated
+    PARTICLE_MAT_BUBBLE,
+    PARTICLE_MAT_WHITE_PARTICLE, // MODEL_WHITE_PARTICLE, MODEL_WHITE_PARTICLE_DL
+    PARTICLE_MAT_WHITE_PARTICLE_SMALL,
+    PARTICLE_MAT_SAND,
+    PARTICLE_MAT_MIST,           // Translucent, fades with the particle's alpha
+    PARTICLE_MAT_COUNT,
+    PARTICLE_MAT_NONE = PARTICLE_MAT_COUNT
+};
+
+enum ParticleFlags {
+    PARTICLE_FLAG_ALIVE     = (1 << 0),
+    PARTICLE_FLAG_SLOW_FADE = (1 << 1), // Grows while fading instead of shrinking
+};
+
+/**
+ * All particles, stored as one array per field so that each pass only touches the fields it needs.
+ * Environment effect particles move themselves and only use the shared fields plus the envfx ones.
+ */
+struct ParticlePool {
+    // Shared
+    f32 posX[PARTICLE_POOL_CAPACITY];
+    f32 posY[PARTICLE_POOL_CAPACITY];
+    f32 posZ[PARTICLE_POOL_CAPACITY];
+    f32 size[PARTICLE_POOL_CAPACITY];
+    u8 material[PARTICLE_POOL_CAPACITY];
+    u8 frame[PARTICLE_POOL_CAPACITY];
+    u8 alpha[PARTICLE_POOL_CAPACITY];
+    u8 flags[PARTICLE_POOL_CAPACITY];
+
+    // Emitted particles
+    f32 velX[PARTICLE_POOL_CAPACITY];
+    f32 velY[PARTICLE_POOL_CAPACITY];
+    f32 velZ[PARTICLE_POOL_CAPACITY];
+    f32 baseSize[PARTICLE_POOL_CAPACITY];
+    s8 gravity[PARTICLE_POOL_CAPACITY];
+    s8 drag[PARTICLE_POOL_CAPACITY];
+    s8 alphaStep[PARTICLE_POOL_CAPACITY];
+    u8 timer[PARTICLE_POOL_CAPACITY];
+
+    // Environment effect particles
+    s32 envfxAngle[PARTICLE_ENVFX_CAPACITY]; // For whirlpools, angle around the center
+    s32 envfxDist[PARTICLE_ENVFX_CAPACITY];  // For whirlpools, distance from the center
+    s32 envfxBaseY[PARTICLE_ENVFX_CAPACITY]; // For whirlpools, height before rotating around the whirlpool
+
+    s16 numEnvFx;   // How many envfx slots are drawn
+    u16 envFxUpdate; // gAreaUpdateCounter when numEnvFx was last set
+    s16 numEmitted; // Emitted particles are packed after PARTICLE_ENVFX_CAPACITY
+    s16 emittedThisFrame;
+};
+
+/**
+ * Describes a burst of particles, e.g. the puffs from cur_obj_spawn_particles.
+ */
+struct ParticleEmitter {
+    u8 material;
+    u8 count;
+    u8 lifetime;
+    s8 alphaStep; // Added to the alpha every frame, 0 keeps it constant
+    u8 alpha;
+    u8 flags;
+    s8 offsetY;
+    s8 forwardVelBase;
+    s8 forwardVelRange;
+    s8 velYBase;
+    s8 velYRange;
+    s8 gravity;
+    s8 dragStrength;
+    f32 sizeBase;
+    f32 sizeRange;
+};
+
+extern struct ParticlePool gParticles;
+
+s32 particles_material_from_model(ModelID16 model);
+s32 particles_emit(const struct ParticleEmitter *emitter, Vec3f pos);
+void particles_clear(void);
+void particles_update(void);
+void particles_render(Vec3f camPos, Vec3f camFocus);
+
+#endif // PARTICLE_SYSTEM_H
@@ -0,0 +1,295 @@
+/**
+ * Statistical profiler for the game thread.
+ *
+ * A timer wakes the main thread at a fixed rate, and since the main thread has a higher priority
+ * than the game thread, the game thread's saved context says exactly where it was interrupted.
+ * Those samples are symbolized with the packed map data (see map_parser.c) into a decaying
+ * histogram of the hottest functions, which is shown on a puppyprint page.
+ *
+ * The most recent samples can also be dumped over UNF or ISViewer and turned into folded stacks
+ * for flame graphs with tools/pcprof.py.
+ */
+
+#include <ultra64.h>
+
+#include "config.h"
+#include "game_init.h"
+#include "main.h"
+#include "pc_profiler.h"
+#include "printf.h"
+#include "puppyprint.h"
+#include "spsc_ring.h"
+
+#ifdef PC_PROFILER
+
+#define PC_PROFILER_SAMPLE_RATE   500 // Samples per second
+#define PC_PROFILER_NUM_SAMPLES  1024 // Must be a power of two
+#define PC_PROFILER_FUNC_BITS       8
+#define PC_PROFILER_NUM_FUNCS    (1 << PC_PROFILER_FUNC_BITS)
+#define PC_PROFILER_NUM_SHOWN      14
+
+extern far void map_data_load_copy(void);
+extern far s32 map_find_entry(u32 pc);
+extern far char *map_entry_name(s32 index);
+
+struct PCSample {
+    u32 pc; // 0 if the game thread wasn't running
+    u32 ra; // Only the caller for leaf functions or before the prologue saved it, so approximate
+};
+
+struct PCHistogramEntry {
+    s32 func; // Map entry index, or -1 for an empty slot
+    u32 count;
+};
+
+static OSTimer sSampleTimer;
+
+// Produced by the main thread, consumed by the game thread.
+static struct PCSample sSamples[PC_PROFILER_NUM_SAMPLES];
+static struct SPSCRing sSampleRing = SPSC_RING_INIT(PC_PROFILER_NUM_SAMPLES);
+
+// Owned by the game thread.
+static struct PCHistogramEntry sHistogram[PC_PROFILER_NUM_FUNCS];
+static struct PCHistogramEntry sHistogramScratch[PC_PROFILER_NUM_FUNCS];
+static u32 sHistogramTotal = 0;
+static u32 sHistogramIdle = 0;
+static u32 sSamplesUntilDecay = PC_PROFILER_SAMPLE_RATE;
+static u32 sLastUpdateFrame = 0;
+static u32 sOverflowsShown = 0; // Overflows before the page was last opened
+
+static void pc_histogram_clear(struct PCHistogramEntry *histogram) {
+    s32 i;
+
+    for (i = 0; i < PC_PROFILER_NUM_FUNCS; i++) {
+        histogram[i].func = -1;
+        histogram[i].count = 0;
+    }
+}
+
+/**
+ * Loads the map data and starts the sample timer. The timer sends msg to queue, which the owner of
+ * the queue should answer with pc_profiler_sample.
+ */
+void pc_profiler_init(OSMesgQueue *queue, OSMesg msg) {
+    OSTime interval = OS_USEC_TO_CYCLES(1000000 / PC_PROFILER_SAMPLE_RATE);
+
+    map_data_load_copy();
+    pc_histogram_clear(sHistogram);
+    osSetTimer(&sSampleTimer, interval, interval, queue, msg);
+}
+
+/**
+ * Records where the game thread is. Must run on a thread with a higher priority than every thread
+ * it checks, so none of them can be running while it looks at their state.
+ */
+void pc_profiler_sample(void) {
+    struct PCSample *sample;
+    u32 index;
+
+    // If the game thread has fallen a whole ring behind, the sample is dropped and counted.
+    if (spsc_ring_reserve(&sSampleRing, 1, &index) == 0) {
+        return;
+    }
+    sample = &sSamples[SPSC_RING_INDEX(&sSampleRing, index)];
+
+    // The game thread was interrupted while running only if it is still runnable
+    // and no higher priority thread was ready to run instead.
+    if (gGameLoopThread.state == OS_STATE_RUNNABLE
+        && gSoundThread.state != OS_STATE_RUNNABLE
+#if ENABLE_RUMBLE
+        && gRumblePakThread.state != OS_STATE_RUNNABLE
+#endif
+    ) {
+        sample->pc = gGameLoopThread.context.pc;
+        sample->ra = (u32) gGameLoopThread.context.ra;
+    } else {
+        sample->pc = 0;
+        sample->ra = 0;
+    }
+
+    spsc_ring_submit(&sSampleRing, 1);
+}
+
+static void pc_histogram_add(struct PCHistogramEntry *histogram, s32 func, u32 count) {
+    u32 slot = (((u32) func * 2654435761U) >> (32 - PC_PROFILER_FUNC_BITS));
+    s32 i;
+
+    // Linear probing. If the table is full, the sample is dropped.
+    for (i = 0; i < PC_PROFILER_NUM_FUNCS; i++) {
+        struct PCHistogramEntry *entry = &histogram[slot];
+
+        if (entry->func == func) {
+            entry->count += count;
+            return;
+        }
+        if (entry->func < 0) {
+            entry->func = func;
+            entry->count = count;
+            return;
+        }
+        slot = (slot + 1) & (PC_PROFILER_NUM_FUNCS - 1);
+    }
+}
+
+/**
+ * Halves every count, so the histogram shows roughly the last couple of seconds.
+ * The table is rebuilt so that functions that drop to zero free their slot.
+ */
+static void pc_histogram_decay(void) {
+    s32 i;
+
+    pc_histogram_clear(sHistogramScratch);
+    sHistogramTotal = 0;
+
+    for (i = 0; i < PC_PROFILER_NUM_FUNCS; i++) {
+        u32 count = (sHistogram[i].count / 2);
+
+        if (sHistogram[i].func >= 0 && count != 0) {
+            pc_histogram_add(sHistogramScratch, sHistogram[i].func, count);
+            sHistogramTotal += count;
+        }
+    }
+
+    bcopy(sHistogramScratch, sHistogram, sizeof(sHistogram));
+    sHistogramIdle /= 2;
+    sHistogramTotal += sHistogramIdle;
+}
+
+/**
+ * Symbolizes every sample taken since the last call. While the page isn't shown nothing
+ * consumes the samples, so the ring fills up; that backlog is stale and skipped.
+ */
+static void pc_profiler_update_histogram(void) {
+    u32 start;
+    u32 count = spsc_ring_peek(&sSampleRing, &start);
+    u32 i;
+
+    if (gGlobalTimer != (sLastUpdateFrame + 1)) {
+        spsc_ring_consume(&sSampleRing, count);
+        sOverflowsShown = sSampleRing.overflows;
+        count = 0;
+    }
+    sLastUpdateFrame = gGlobalTimer;
+
+    for (i = 0; i < count; i++) {
+        u32 pc = sSamples[SPSC_RING_INDEX(&sSampleRing, start + i)].pc;
+
+        if (pc == 0) {
+            sHistogramIdle++;
+            sHistogramTotal++;
+        } else {
+            s32 func = map_find_entry(pc);
+
+            if (func >= 0) {
+                pc_histogram_add(sHistogram, func, 1);
+                sHistogramTotal++;
+            }
+        }
+
+        if (--sSamplesUntilDecay == 0) {
+            pc_histogram_decay();
+            sSamplesUntilDecay = PC_PROFILER_SAMPLE_RATE;
+        }
+    }
+
+    spsc_ring_consume(&sSampleRing, count);
+}
+
+#if defined(UNF) || defined(ISVPRINT)
+/**
+ * Prints the most recent samples in the format tools/pcprof.py reads. They have already
+ * been consumed, so the main thread keeps sampling over the oldest few during the dump.
+ */
+static void pc_profiler_dump(void) {
+    u32 end = sSampleRing.head;
+    u32 i = ((end > PC_PROFILER_NUM_SAMPLES) ? (end - PC_PROFILER_NUM_SAMPLES) : 0);
+
+    osSyncPrintf("PCPROF BEGIN %d\n", PC_PROFILER_SAMPLE_RATE);
+    for (; i != end; i++) {
+        struct PCSample *sample = &sSamples[SPSC_RING_INDEX(&sSampleRing, i)];
+
+        osSyncPrintf("%08X %08X\n", sample->pc, sample->ra);
+    }
+    osSyncPrintf("PCPROF END\n");
+}
+#endif
+
+/**
+ * Picks the hottest functions with a selection sort, since only a handful are shown.
+ */
+static s32 pc_histogram_top(s32 *top, s32 maxCount) {
+    s32 numTop = 0;
+    s32 i, j;
+
+    while (numTop < maxCount) {
+        s32 best = -1;
+
+        for (i = 0; i < PC_PROFILER_NUM_FUNCS; i++) {
+            if (sHistogram[i].func < 0 || (best >= 0 && sHistogram[i].count <= sHistogram[best].count)) {
+                continue;
+            }
+            for (j = 0; j < numTop; j++) {
+                if (top[j] == i) {
+                    break;
+                }
+            }
+            if (j == numTop) {
+                best = i;
+            }
+        }
+
+        if (best < 0) {
+            break;
+        }
+        top[numTop++] = best;
+    }
+
+    return numTop;
+}
+
+void print_pc_profiler(void) {
+    char textBytes[64];
+    s32 top[PC_PROFILER_NUM_SHOWN];
+    s32 numTop;
+    s32 i;
+    s32 y = 16;
+
+    pc_profiler_update_histogram();
+
+#if defined(UNF) || defined(ISVPRINT)
+    if (gPlayer1Controller->buttonPressed & R_JPAD) {
+        pc_profiler_dump();
+    }
+#endif
+
+    prepare_blank_box();
+    render_blank_box(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, 0, 0, 0, 192);
+    finish_blank_box();
+
+    print_set_envcolour(255, 255, 255, 255);
+    sprintf(textBytes, "Game thread samples: %dHz", PC_PROFILER_SAMPLE_RATE);
+    print_small_text(16, y, textBytes, PRINT_TEXT_ALIGN_LEFT, PRINT_ALL, FONT_OUTLINE);
+    y += 12;
+
+    if (sHistogramTotal == 0) {
+        return;
+    }
+
+    sprintf(textBytes, "Not running: %d_, dropped: %d", ((sHistogramIdle * 100) / sHistogramTotal),
+            (sSampleRing.overflows - sOverflowsShown));
+    print_small_text(16, y, textBytes, PRINT_TEXT_ALIGN_LEFT, PRINT_ALL, FONT_OUTLINE);
+    y += 16;
+
+    numTop = pc_histogram_top(top, PC_PROFILER_NUM_SHOWN);
+    for (i = 0; i < numTop; i++) {
+        struct PCHistogramEntry *entry = &sHistogram[top[i]];
+        s32 percentage = ((entry->count * 1000) / sHistogramTotal);
+
+        sprintf(textBytes, "%d.%d_", (percentage / 10), (percentage % 10));
+        print_small_text(56, y, textBytes, PRINT_TEXT_ALIGN_RIGHT, PRINT_ALL, FONT_OUTLINE);
+        print_small_text(64, y, map_entry_name(entry->func), PRINT_TEXT_ALIGN_LEFT, PRINT_ALL, FONT_OUTLINE);
+        y += 12;
+    }
+}
+
+#endif
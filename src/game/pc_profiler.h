@@ -0,0 +1,14 @@
+#ifndef PC_PROFILER_H
+#define PC_PROFILER_H
+
+#include <PR/os_message.h>
+
+#include "config.h"
+
+#ifdef PC_PROFILER
+void pc_profiler_init(OSMesgQueue *queue, OSMesg msg);
+void pc_profiler_sample(void);
+void print_pc_profiler(void);
+#endif
+
+#endif // PC_PROFILER_H
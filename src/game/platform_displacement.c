@@ -80,18 +80,82 @@ static Vec3f sMarioAmountDisplaced;
 extern s32 gGlobalTimer;
 
 /**
- * Upscale or downscale a vector by another vector.
+ * The last transform of a platform that something rode, and how it moved since the
+ * frame before. Kept for a few platforms at once rather than in every object.
  */
-static void scale_vec3f(Vec3f dst, Vec3f src, Vec3f scale, u32 doInverted) {
-    if (doInverted) {
-        dst[0] = src[0] / scale[0];
-        dst[1] = src[1] / scale[1];
-        dst[2] = src[2] / scale[2];
-    } else {
-        dst[0] = src[0] * scale[0];
-        dst[1] = src[1] * scale[1];
-        dst[2] = src[2] * scale[2];
+struct PlatformTransform {
+    struct Object *platform;
+    Mat4 prevTransform; // Platform's transform and scale when the delta was last updated
+    Vec3f prevScale;
+    Mat4 delta;         // Moves a point riding the platform from where it was last frame to where it is now
+    s32 timer;          // Frame the delta was last updated on
+    u8 hasDelta;        // FALSE if the platform wasn't ridden last frame
+};
+
+static struct PlatformTransform sPlatformTransforms[MAX_DISPLACING_PLATFORMS];
+
+/**
+ * Set the delta transform from the platform's previous transform to its current one.
+ * Both are scaled, so a rider stays at the same place on the platform as it scales.
+ */
+static void calc_platform_delta(struct PlatformTransform *entry, Mat4 transform, Vec3f scale) {
+    Mat4 *prev = &entry->prevTransform;
+    Vec3f scaleRatio;
+    s32 i, j;
+
+    vec3f_quot(scaleRatio, scale, entry->prevScale);
+
+    // The inverse of the previous transform is its transpose, since it's a rotation.
+    for (i = 0; i < 3; i++) {
+        for (j = 0; j < 3; j++) {
+            entry->delta[i][j] = ((*prev)[0][i] * scaleRatio[0] * transform[0][j])
+                               + ((*prev)[1][i] * scaleRatio[1] * transform[1][j])
+                               + ((*prev)[2][i] * scaleRatio[2] * transform[2][j]);
+        }
     }
+
+    linear_mtxf_mul_vec3(entry->delta, entry->delta[3], (*prev)[3]);
+    vec3_diff(entry->delta[3], transform[3], entry->delta[3]);
+}
+
+/**
+ * Get the platform's delta transform for this frame, updating it the first time
+ * something rides the platform this frame.
+ */
+static struct PlatformTransform *get_platform_transform(struct Object *platform) {
+    struct PlatformTransform *entry = NULL;
+    s32 i;
+
+    for (i = 0; i < MAX_DISPLACING_PLATFORMS; i++) {
+        if (sPlatformTransforms[i].platform == platform) {
+            entry = &sPlatformTransforms[i];
+            break;
+        }
+        // Reuse any entry that wasn't ridden last frame.
+        if (entry == NULL && sPlatformTransforms[i].timer < gGlobalTimer - 1) {
+            entry = &sPlatformTransforms[i];
+        }
+    }
+
+    if (entry == NULL) {
+        return NULL;
+    }
+
+    if (entry->platform == platform && entry->timer == gGlobalTimer) {
+        return entry;
+    }
+
+    entry->hasDelta = (entry->platform == platform && entry->timer == gGlobalTimer - 1);
+    if (entry->hasDelta) {
+        calc_platform_delta(entry, *platform->header.gfx.throwMatrix, platform->header.gfx.scale);
+    }
+
+    entry->platform = platform;
+    entry->timer = gGlobalTimer;
+    mtxf_copy(entry->prevTransform, *platform->header.gfx.throwMatrix);
+    vec3f_copy(entry->prevScale, platform->header.gfx.scale);
+
+    return entry;
 }
 
 /**
@@ -99,36 +163,36 @@ static void scale_vec3f(Vec3f dst, Vec3f src, Vec3f scale, u32 doInverted) {
  * platform.
  */
 void apply_platform_displacement(struct PlatformDisplacementInfo *displaceInfo, Vec3f pos, s16 *yaw, struct Object *platform) {
-    Vec3f platformPos;
+    struct PlatformTransform *platformTransform;
     Vec3f posDifference;
-    Vec3f yawVec;
-    Vec3f scaledPos;
+    Vec3f yawVec, newYawVec;
     // Determine how much Mario turned on his own since last frame
     s16 yawDifference = *yaw - displaceInfo->prevYaw;
 
     // Avoid a crash if the platform unloaded its collision while stood on
     if (platform->header.gfx.throwMatrix == NULL) return;
 
-    vec3f_copy(platformPos, (*platform->header.gfx.throwMatrix)[3]);
+    platformTransform = get_platform_transform(platform);
+    if (platformTransform == NULL) return;
 
     // Determine how far Mario moved on his own since last frame
-    vec3f_copy(posDifference, pos);
-    vec3f_sub(posDifference, displaceInfo->prevPos);
+    vec3f_diff(posDifference, pos, displaceInfo->prevPos);
+
+    s32 onPlatform = ((platform == displaceInfo->prevPlatform)
+                      && (gGlobalTimer == displaceInfo->prevTimer + 1)
+                      && platformTransform->hasDelta);
 
-    if ((platform == displaceInfo->prevPlatform) && (gGlobalTimer == displaceInfo->prevTimer + 1)) {
-        // Transform from relative positions to world positions
-        scale_vec3f(scaledPos, displaceInfo->prevTransformedPos, platform->header.gfx.scale, FALSE);
-        linear_mtxf_mul_vec3f(*platform->header.gfx.throwMatrix, pos, scaledPos);
+    if (onPlatform) {
+        // Move last frame's position along with the platform
+        linear_mtxf_mul_vec3_and_translate(platformTransform->delta, pos, displaceInfo->prevPos);
 
         // Add on how much Mario moved in the previous frame
         vec3f_add(pos, posDifference);
 
         // Calculate new yaw
-        linear_mtxf_mul_vec3f(*platform->header.gfx.throwMatrix, yawVec, displaceInfo->prevTransformedYawVec);
-        *yaw = atan2s(yawVec[2], yawVec[0]) + yawDifference;
-    } else {
-        // First frame of standing on the platform, don't calculate a new position
-        vec3f_sub(pos, platformPos);
+        vec3f_set(yawVec, sins(displaceInfo->prevYaw), 0, coss(displaceInfo->prevYaw));
+        linear_mtxf_mul_vec3(platformTransform->delta, newYawVec, yawVec);
+        *yaw = atan2s(newYawVec[2], newYawVec[0]) + yawDifference;
     }
 
     // Apply velocity-based displacement for certain objects (like the TTC Treadmills)
@@ -138,11 +202,6 @@ void apply_platform_displacement(struct PlatformDisplacementInfo *displaceInfo,
         pos[2] += platform->oVelZ;
     }
 
-    // Transform from world positions to relative positions for use next frame
-    linear_mtxf_transpose_mul_vec3f(*platform->header.gfx.throwMatrix, scaledPos, pos);
-    scale_vec3f(displaceInfo->prevTransformedPos, scaledPos, platform->header.gfx.scale, TRUE);
-    vec3f_add(pos, platformPos);
-
     // If the object is Mario, set inertia
     if (pos == gMarioState->pos) {
         vec3f_copy(sMarioAmountDisplaced, pos);
@@ -150,25 +209,123 @@ void apply_platform_displacement(struct PlatformDisplacementInfo *displaceInfo,
         vec3f_sub(sMarioAmountDisplaced, posDifference);
 
         // Make sure inertia isn't set on the first frame otherwise the previous value isn't cleared
-        if ((platform != displaceInfo->prevPlatform) || (gGlobalTimer != displaceInfo->prevTimer + 1)) {
+        if (!onPlatform) {
             vec3_zero(sMarioAmountDisplaced);
         }
     }
 
     // Update info for next frame
-    // Update position
     vec3f_copy(displaceInfo->prevPos, pos);
-
-    // Set yaw info
-    vec3f_set(yawVec, sins(*yaw), 0, coss(*yaw));
-    linear_mtxf_transpose_mul_vec3f(*platform->header.gfx.throwMatrix, displaceInfo->prevTransformedYawVec, yawVec);
     displaceInfo->prevYaw = *yaw;
-
-    // Update platform and timer
     displaceInfo->prevPlatform = platform;
     displaceInfo->prevTimer = gGlobalTimer;
 }
 
+/**
+ * Objects other than Mario that are carried by the platforms they stand on.
+ */
+struct PlatformRider {
+    struct Object *obj;
+    struct PlatformDisplacementInfo displaceInfo;
+};
+
+static struct PlatformRider sPlatformRiders[MAX_PLATFORM_RIDERS];
+
+/**
+ * Have an object be carried by platforms it stands on, using the floor from its
+ * last cur_obj_update_floor. Return FALSE if there's no room for it.
+ */
+s32 register_platform_rider(struct Object *obj) {
+    struct PlatformRider *freeRider = NULL;
+    s32 i;
+
+    for (i = 0; i < MAX_PLATFORM_RIDERS; i++) {
+        if (sPlatformRiders[i].obj == obj) {
+            return TRUE;
+        }
+        if (freeRider == NULL && sPlatformRiders[i].obj == NULL) {
+            freeRider = &sPlatformRiders[i];
+        }
+    }
+
+    if (freeRider == NULL) {
+        return FALSE;
+    }
+
+    bzero(freeRider, sizeof(*freeRider));
+    freeRider->obj = obj;
+    obj->platform = NULL;
+    return TRUE;
+}
+
+void unregister_platform_rider(struct Object *obj) {
+    s32 i;
+
+    for (i = 0; i < MAX_PLATFORM_RIDERS; i++) {
+        if (sPlatformRiders[i].obj == obj) {
+            sPlatformRiders[i].obj = NULL;
+        }
+    }
+}
+
+/**
+ * Forget all riders. Called when loading an area, since its objects are unloaded.
+ */
+void clear_platform_riders(void) {
+    bzero(sPlatformRiders, sizeof(sPlatformRiders));
+}
+
+/**
+ * Set the platform each rider is standing on, the same way as for Mario.
+ * Riders that were unloaded are dropped.
+ */
+void update_platform_riders(void) {
+    struct Object *obj;
+    s32 i;
+
+    for (i = 0; i < MAX_PLATFORM_RIDERS; i++) {
+        obj = sPlatformRiders[i].obj;
+        if (obj == NULL) {
+            continue;
+        }
+
+        if (!(obj->activeFlags & ACTIVE_FLAG_ACTIVE)) {
+            sPlatformRiders[i].obj = NULL;
+            continue;
+        }
+
+        if (obj->oFloor != NULL && obj->oFloor->object != NULL && absf(obj->oPosY - obj->oFloorHeight) < 4.0f) {
+            obj->platform = obj->oFloor->object;
+        } else {
+            obj->platform = NULL;
+        }
+    }
+}
+
+/**
+ * Apply platform displacement to every rider that is on a platform.
+ */
+void apply_platform_rider_displacement(void) {
+    struct PlatformRider *rider;
+    s16 startYaw, yaw;
+    s32 i;
+
+    if (gTimeStopState & TIME_STOP_ACTIVE) {
+        return;
+    }
+
+    for (i = 0; i < MAX_PLATFORM_RIDERS; i++) {
+        rider = &sPlatformRiders[i];
+        if (rider->obj != NULL && rider->obj->platform != NULL) {
+            startYaw = yaw = rider->obj->oFaceAngleYaw;
+            apply_platform_displacement(&rider->displaceInfo, &rider->obj->oPosVec, &yaw, rider->obj->platform);
+            // Turn with the platform
+            rider->obj->oFaceAngleYaw = yaw;
+            rider->obj->oMoveAngleYaw += (s16)(yaw - startYaw);
+        }
+    }
+}
+
 // Doesn't change in the code, set this to FALSE if you don't want inertia
 u8 gDoInertia = TRUE;
 
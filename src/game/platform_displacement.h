@@ -7,10 +7,13 @@
 
 #include "config.h"
 #ifdef PLATFORM_DISPLACEMENT_2
+	// Platforms whose movement since last frame can be tracked at once.
+	#define MAX_DISPLACING_PLATFORMS 8
+	// Objects other than Mario that can be registered to ride platforms.
+	#define MAX_PLATFORM_RIDERS 16
+
 	struct PlatformDisplacementInfo {
 		Vec3f prevPos;
-		Vec3f prevTransformedPos;
-		Vec3f prevTransformedYawVec;
 		s16 prevYaw;
 		struct Object *prevPlatform;
 		s32 prevTimer;
@@ -21,6 +24,11 @@ void get_mario_pos(f32 *x, f32 *y, f32 *z);
 void set_mario_pos(f32 x, f32 y, f32 z);
 #ifdef PLATFORM_DISPLACEMENT_2
 void apply_platform_displacement(struct PlatformDisplacementInfo *displaceInfo, Vec3f pos, s16 *yaw, struct Object *platform);
+s32 register_platform_rider(struct Object *obj);
+void unregister_platform_rider(struct Object *obj);
+void clear_platform_riders(void);
+void update_platform_riders(void);
+void apply_platform_rider_displacement(void);
 #else
 void apply_platform_displacement(u32 isMario, struct Object *platform);
 #endif
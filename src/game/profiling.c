@@ -26,6 +26,11 @@ u32 prev_time;
 u32 audio_start;
 u32 audio_buffer_index;
 u32 preempted_time;
+u32 gfx_submit_time;
+volatile u32 gfx_done_time;
+volatile u8 gfx_in_flight = FALSE;
+u32 display_wait_start;
+u32 display_wait_end;
 
 static void buffer_update(ProfileTimeData* data, u32 new, int buffer_index) {
     u32 old = data->counts[buffer_index];
@@ -100,6 +105,36 @@ void profiler_audio_completed() {
     audio_buffer_index = cur_index;
 }
 
+// Called by the game thread once it has sent a display list.
+void profiler_gfx_submitted() {
+    gfx_submit_time = osGetCount();
+    gfx_in_flight = TRUE;
+}
+
+// Called by the scheduler once the RDP has finished a display list.
+void profiler_gfx_done() {
+    gfx_done_time = osGetCount();
+    gfx_in_flight = FALSE;
+}
+
+// Called by the game thread before it waits on the last display list and the vblank. The CPU and RCP
+// worked at once from when the game thread stopped waiting after sending that display list, or from when
+// it was sent if that was later, up to when it finished or now.
+void profiler_display_wait_started() {
+    u32 now = osGetCount();
+    u32 overlap_start = ((s32)(display_wait_end - gfx_submit_time) > 0 ? display_wait_end : gfx_submit_time);
+    u32 overlap_end = (gfx_in_flight ? now : gfx_done_time);
+    s32 overlap = (s32)(overlap_end - overlap_start);
+
+    buffer_update(&all_profiling_data[PROFILER_TIME_OVERLAP], MAX(overlap, 0), profile_buffer_index);
+    display_wait_start = now;
+}
+
+void profiler_display_wait_ended() {
+    display_wait_end = osGetCount();
+    buffer_update(&all_profiling_data[PROFILER_TIME_DISPLAY_WAIT], display_wait_end - display_wait_start, profile_buffer_index);
+}
+
 static void update_fps_timer() {
     u32 diff = start - prev_start;
 
@@ -186,7 +221,7 @@ u32 profiler_get_rdp_microseconds() {
 
 void profiler_print_times() {
     u32 microseconds[PROFILER_TIME_COUNT];
-    char text_buffer[196];
+    char text_buffer[256];
 
     update_fps_timer();
     update_total_timer();
@@ -227,6 +262,8 @@ void profiler_print_times() {
             " Behavior\t\t%d\n"
             " Graph\t\t%d\n"
             " Audio\t\t\t%d\n"
+            " Overlap\t\t%d (%d%%)\n"
+            " Wait\t\t\t%d\n"
             "\n"
             "RDP\t\t%d (%d%%)\n"
             " Tmem\t\t\t%d\n"
@@ -244,6 +281,9 @@ void profiler_print_times() {
             microseconds[PROFILER_TIME_BEHAVIOR_BEFORE_MARIO] + microseconds[PROFILER_TIME_BEHAVIOR_AFTER_MARIO],
             microseconds[PROFILER_TIME_GFX],
             microseconds[PROFILER_TIME_AUDIO] * 2, // audio is 60Hz, so double the average
+            microseconds[PROFILER_TIME_OVERLAP],
+            (microseconds[PROFILER_TIME_OVERLAP] * 100) / MAX(microseconds[PROFILER_TIME_FPS], 1),
+            microseconds[PROFILER_TIME_DISPLAY_WAIT],
             max_rdp, max_rdp / 333,
             microseconds[PROFILER_TIME_TMEM],
             microseconds[PROFILER_TIME_CMD],
@@ -19,6 +19,8 @@ enum ProfilerTime {
     PROFILER_TIME_GFX,
     PROFILER_TIME_AUDIO,
     PROFILER_TIME_TOTAL,
+    PROFILER_TIME_OVERLAP,
+    PROFILER_TIME_DISPLAY_WAIT,
     PROFILER_TIME_RSP_GFX,
     PROFILER_TIME_RSP_AUDIO,
     PROFILER_TIME_TMEM,
@@ -42,6 +44,10 @@ void profiler_rsp_completed(enum ProfilerRSPTime which);
 void profiler_rsp_resumed();
 void profiler_audio_started();
 void profiler_audio_completed();
+void profiler_gfx_submitted();
+void profiler_gfx_done();
+void profiler_display_wait_started();
+void profiler_display_wait_ended();
 // See profiling.c to see why profiler_rsp_yielded isn't its own function
 static ALWAYS_INLINE void profiler_rsp_yielded() {
     profiler_rsp_resumed();
@@ -55,6 +61,10 @@ static ALWAYS_INLINE void profiler_rsp_yielded() {
 #define profiler_rsp_resumed()
 #define profiler_audio_started()
 #define profiler_audio_completed()
+#define profiler_gfx_submitted()
+#define profiler_gfx_done()
+#define profiler_display_wait_started()
+#define profiler_display_wait_ended()
 #define profiler_rsp_yielded()
 #endif
 
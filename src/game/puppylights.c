@@ -18,6 +18,10 @@ use rooms in your level, or if you wish for this light to be seen from any room,
 
 If you have visual debug enabled, light nodes will show up as magenta in the world. They will be
 shaped and rotated correctly, for accurate representation of their properties.
+
+Once per frame, the lights that can be seen from the current area and room are binned into a coarse
+grid on X and Z using their bounding spheres. Objects only look at the lights binned into their cell,
+and an object that hasn't moved since the last time its cell changed reuses its previous result.
 **/
 
 #include <ultra64.h>
@@ -36,6 +40,7 @@ shaped and rotated correctly, for accurate representation of their properties.
 #include "level_update.h"
 #include "engine/surface_collision.h"
 #include "surface_terrains.h"
+#include "game_init.h"
 
 #ifdef PUPPYLIGHTS
 
@@ -48,6 +53,108 @@ u16 gDynLightStart = 0; // Where the dynamic lights will start.
 struct PuppyLight *gPuppyLights[MAX_LIGHTS]; // This contains all the loaded data.
 struct MemoryPool *gLightsPool; // The memory pool where the above is stored.
 
+#define PUPPYLIGHTS_CELL_SIZE ((LEVEL_BOUNDARY_MAX * 2) / PUPPYLIGHTS_GRID_SIZE)
+#define PUPPYLIGHTS_NUM_CELLS (PUPPYLIGHTS_GRID_SIZE * PUPPYLIGHTS_GRID_SIZE)
+
+struct PuppyLightCell {
+    u32 lights;     // Bitmask of the lights whose bounding sphere overlaps this cell.
+    u16 generation; // Bumped whenever any of those lights change, which invalidates cached results.
+};
+
+struct PuppyLightCache {
+    struct Object *obj;
+    Lights1 *src;
+    Vec3f pos;
+    s32 flags;
+    u16 cell;
+    u16 generation;
+    Lights1 result;
+};
+
+STATIC_ASSERT(MAX_LIGHTS <= 32, "The puppylights cells and bitmasks only have room for 32 lights!");
+
+static struct PuppyLightCell sLightCells[PUPPYLIGHTS_NUM_CELLS];
+static u32 sLightCellScratch[PUPPYLIGHTS_NUM_CELLS];
+static struct PuppyLightCache sLightCache[PUPPYLIGHTS_CACHE_SIZE];
+static struct PuppyLight sLightSnapshot[MAX_LIGHTS]; // The lights as they were binned last time, to find what changed.
+static Lights1 sLightBaseSnapshot;
+static f32 sLightRadiusSq[MAX_LIGHTS]; // Squared bounding sphere radius of each binned light.
+static u32 sLightsBinned = 0;          // Bitmask of the lights that passed the area and room checks.
+static u32 sLightsDirectional = 0;     // Directional lights depend on the camera, so objects near them are never cached.
+static u32 sLightClusterTimer = -1;    // gGlobalTimer of the last time the lights were binned.
+
+static s32 puppylights_cell_coord(f32 pos) {
+    s32 coord = (s32)(pos + LEVEL_BOUNDARY_MAX) / PUPPYLIGHTS_CELL_SIZE;
+
+    return CLAMP(coord, 0, PUPPYLIGHTS_GRID_SIZE - 1);
+}
+
+static void puppylights_invalidate_cells(void) {
+    s32 i;
+
+    for (i = 0; i < PUPPYLIGHTS_NUM_CELLS; i++) {
+        sLightCells[i].generation++;
+    }
+}
+
+// Bins every light that can currently be seen into the grid. Normally runs after objects have updated their
+// lights, but puppylights_run will also call it if it's the first lighting work done in a frame.
+void puppylights_update_clusters(void) {
+    Lights1 *base = (levelAmbient ? &gLevelLight : &sDefaultLights);
+    u32 binned = 0;
+    u32 changed = 0;
+    s32 i, x, z;
+
+    sLightClusterTimer = gGlobalTimer;
+    sLightsDirectional = 0;
+    bzero(sLightCellScratch, sizeof(sLightCellScratch));
+
+    for (i = 0; i < gNumLights; i++) {
+        struct PuppyLight *light = gPuppyLights[i];
+        s32 minX, maxX, minZ, maxZ;
+        f32 radius;
+
+        if (light->rgba[3] == 0 || light->active != TRUE || light->area != gCurrAreaIndex || (light->room != -1 && light->room != gMarioCurrentRoom)) {
+            continue;
+        }
+        binned |= (1U << i);
+        if (!(sLightsBinned & (1U << i)) || memcmp(light, &sLightSnapshot[i], sizeof(struct PuppyLight))) {
+            changed |= (1U << i);
+            memcpy(&sLightSnapshot[i], light, sizeof(struct PuppyLight));
+        }
+        if (light->flags & PUPPYLIGHT_DIRECTIONAL) {
+            sLightsDirectional |= (1U << i);
+        }
+
+        // The sphere around the volume's corners contains it no matter which way it's rotated.
+        sLightRadiusSq[i] = sqr((f32)light->pos[1][0]) + sqr((f32)light->pos[1][1]) + sqr((f32)light->pos[1][2]);
+        radius = sqrtf(sLightRadiusSq[i]);
+        minX = puppylights_cell_coord(light->pos[0][0] - radius);
+        maxX = puppylights_cell_coord(light->pos[0][0] + radius);
+        minZ = puppylights_cell_coord(light->pos[0][2] - radius);
+        maxZ = puppylights_cell_coord(light->pos[0][2] + radius);
+        for (z = minZ; z <= maxZ; z++) {
+            for (x = minX; x <= maxX; x++) {
+                sLightCellScratch[z * PUPPYLIGHTS_GRID_SIZE + x] |= (1U << i);
+            }
+        }
+    }
+    // Lights that stopped being visible change the cells they used to be in.
+    changed |= (sLightsBinned & ~binned);
+    sLightsBinned = binned;
+
+    if (memcmp(base, &sLightBaseSnapshot, sizeof(Lights1))) {
+        memcpy(&sLightBaseSnapshot, base, sizeof(Lights1));
+        puppylights_invalidate_cells();
+    }
+    for (i = 0; i < PUPPYLIGHTS_NUM_CELLS; i++) {
+        if (sLightCells[i].lights != sLightCellScratch[i] || (sLightCellScratch[i] & changed)) {
+            sLightCells[i].lights = sLightCellScratch[i];
+            sLightCells[i].generation++;
+        }
+    }
+}
+
 // Runs after an area load, allocates the dynamic light slots.
 void puppylights_allocate(void) {
     s32 numAllocate = MIN(MAX_LIGHTS - gNumLights, MAX_LIGHTS_DYNAMIC);
@@ -211,10 +318,30 @@ void puppylights_run(Lights1 *src, struct Object *obj, s32 flags, u32 baseColour
     s32 numlights = 0;
     s32 offsetPlaced = 0;
     s32 lightFlags = flags;
+    struct PuppyLightCell *cell;
+    struct PuppyLightCache *cache = NULL;
+    u32 lights;
 
     if (gCurrLevelNum < LEVEL_BBH) {
         return;
     }
+    if (sLightClusterTimer != gGlobalTimer) {
+        puppylights_update_clusters();
+    }
+    cell = &sLightCells[puppylights_cell_coord(obj->oPosZ) * PUPPYLIGHTS_GRID_SIZE + puppylights_cell_coord(obj->oPosX)];
+    lights = cell->lights;
+
+    // The result only depends on the object's position and the lights in its cell, so if neither changed, reuse it.
+    if (baseColour < 0x100 && !(lights & sLightsDirectional)) {
+        cache = &sLightCache[(((uintptr_t)obj >> 4) ^ ((uintptr_t)src >> 3)) % PUPPYLIGHTS_CACHE_SIZE];
+        if (cache->obj == obj && cache->src == src && cache->flags == flags
+            && cache->cell == (cell - sLightCells) && cache->generation == cell->generation
+            && cache->pos[0] == obj->oPosX && cache->pos[1] == obj->oPosY && cache->pos[2] == obj->oPosZ) {
+            memcpy(segmented_to_virtual(src), &cache->result, sizeof(Lights1));
+            return;
+        }
+    }
+
     // Checks if there's a hardset colour. Colours are only the first 3 bytes, so you can really put whatever you want in the last.
     // If there isn't a colour, then it decides whether to apply the ambient lighting, or the default lighting as the baseline.
     // Otherwise, it hardsets a colour to begin with. I don't recommend you use this, simply because it's intended to be used
@@ -233,20 +360,41 @@ void puppylights_run(Lights1 *src, struct Object *obj, s32 flags, u32 baseColour
             sLightBase->a.l.colc[i] = colour/2;
             sLightBase->l->l.dir[i] = 0x28;
         }
+        // This overwrites the base light every other object starts from, so anything cached from the old one is stale.
+        if (memcmp(sLightBase, &sLightBaseSnapshot, sizeof(Lights1))) {
+            memcpy(&sLightBaseSnapshot, sLightBase, sizeof(Lights1));
+            puppylights_invalidate_cells();
+        }
     }
     memcpy(segmented_to_virtual(src), &sLightBase[0], sizeof(Lights1));
 
-    for (i = 0; i < gNumLights; i++) {
-        if (gPuppyLights[i]->rgba[3] > 0 && gPuppyLights[i]->active == TRUE && gPuppyLights[i]->area == gCurrAreaIndex && (gPuppyLights[i]->room == -1 || gPuppyLights[i]->room == gMarioCurrentRoom)) {
-            if (gPuppyLights[i]->flags & PUPPYLIGHT_DIRECTIONAL && !offsetPlaced) {
-                lightFlags |= LIGHTFLAG_DIRECTIONAL_OFFSET;
-                offsetPlaced = 1;
-            } else {
-                lightFlags &= ~LIGHTFLAG_DIRECTIONAL_OFFSET;
-            }
-            puppylights_iterate(gPuppyLights[i], src, obj, lightFlags);
-            numlights++;
+    for (i = 0; lights != 0; i++, lights >>= 1) {
+        if (!(lights & 1)) {
+            continue;
         }
+        if (gPuppyLights[i]->flags & PUPPYLIGHT_DIRECTIONAL && !offsetPlaced) {
+            lightFlags |= LIGHTFLAG_DIRECTIONAL_OFFSET;
+            offsetPlaced = 1;
+        } else {
+            lightFlags &= ~LIGHTFLAG_DIRECTIONAL_OFFSET;
+        }
+        // Skip the full shape test if the object is outside the light's bounding sphere.
+        if (sqr(gPuppyLights[i]->pos[0][0] - obj->oPosX) + sqr(gPuppyLights[i]->pos[0][1] - obj->oPosY)
+            + sqr(gPuppyLights[i]->pos[0][2] - obj->oPosZ) >= sLightRadiusSq[i]) {
+            continue;
+        }
+        puppylights_iterate(gPuppyLights[i], src, obj, lightFlags);
+        numlights++;
+    }
+
+    if (cache != NULL) {
+        cache->obj = obj;
+        cache->src = src;
+        cache->flags = flags;
+        cache->cell = (cell - sLightCells);
+        cache->generation = cell->generation;
+        vec3f_copy(cache->pos, &obj->oPosVec);
+        memcpy(&cache->result, segmented_to_virtual(src), sizeof(Lights1));
     }
 }
 
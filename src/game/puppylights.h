@@ -9,6 +9,10 @@
 #define MAX_LIGHTS 32
 // The maximum number of dynamic lights available at one time.
 #define MAX_LIGHTS_DYNAMIC 8
+// Lights are binned once per frame into a grid of this many cells per side, covering the level boundaries on X and Z.
+#define PUPPYLIGHTS_GRID_SIZE 16
+// How many object lighting results are remembered, so objects that haven't moved can skip the light maths.
+#define PUPPYLIGHTS_CACHE_SIZE 64
 
 // Two shapes. Choose your destiny.
 #define PUPPYLIGHT_SHAPE_CUBE     (1 << 0) // 0x01
@@ -52,6 +56,7 @@ extern void obj_disable_light(struct Object *obj);
 extern void set_light_properties(struct PuppyLight *light, s32 x, s32 y, s32 z, s32 offsetX, s32 offsetY, s32 offsetZ, s32 yaw, s32 epicentre, s32 colour, s32 flags, s32 room, s32 active);
 extern void puppylights_allocate(void);
 extern void delete_lights(void);
+extern void puppylights_update_clusters(void);
 
 #endif
 #endif
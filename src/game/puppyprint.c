@@ -40,10 +40,15 @@ a modern game engine's developer's console.
 #include "object_list_processor.h"
 #include "engine/surface_load.h"
 #include "audio/data.h"
+#include "audio/external.h"
 #include "audio/heap.h"
+#include "audio/load.h"
+#include "audio/playback.h"
 #include "hud.h"
 #include "debug_box.h"
 #include "color_presets.h"
+#include "pc_profiler.h"
+#include "boot/alloc_trace.h"
 
 #ifdef PUPPYPRINT
 
@@ -285,6 +290,41 @@ void print_ram_overview(void) {
     print_ram_bar();
 }
 
+#ifdef ALLOC_TRACE
+#define ALLOC_TRACE_NUM_SHOWN 16
+
+// Every traced pool, the ones that failed or came closest to full first.
+void print_alloc_trace(void) {
+    char textBytes[64];
+    s32 top[ALLOC_TRACE_NUM_SHOWN];
+    s32 numTop = alloc_trace_top_pools(top, ALLOC_TRACE_NUM_SHOWN);
+    s32 i;
+    s32 y = 16;
+
+    prepare_blank_box();
+    render_blank_box(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, 0, 0, 0, 192);
+    finish_blank_box();
+
+    print_set_envcolour(255, 255, 255, 255);
+    print_small_text(16, y, "Pool   Address   Used/Size   Peak   Failed", PRINT_TEXT_ALIGN_LEFT, PRINT_ALL, FONT_OUTLINE);
+    y += 16;
+
+    for (i = 0; i < numTop; i++) {
+        struct AllocTracePool *pool = &gAllocTracePools[top[i]];
+
+        if (pool->failures != 0) {
+            print_set_envcolour(255, 64, 64, 255);
+        } else {
+            print_set_envcolour(255, 255, 255, 255);
+        }
+        sprintf(textBytes, "%s   %08X   %X/%X   %X   %d", gAllocTraceKindNames[pool->kind], (u32) pool->pool,
+                pool->used, pool->total, pool->peak, pool->failures);
+        print_small_text(16, y, textBytes, PRINT_TEXT_ALIGN_LEFT, PRINT_ALL, FONT_OUTLINE);
+        y += 12;
+    }
+}
+#endif
+
 const char *audioPoolNames[NUM_AUDIO_POOLS] = {
     "gAudioInitPool",
     "gNotesAndBuffersPool",
@@ -358,6 +398,43 @@ void print_audio_ram_overview(void) {
                         colourChart[30][1],
                         colourChart[30][2], 255);
     print_small_text(x, tmpY, textBytes, PRINT_TEXT_ALIGN_LEFT, PRINT_ALL, FONT_OUTLINE);
+
+#ifndef VERSION_SH
+    y += 12;
+    totalMemory[0] = (gSampleDmaStats.hits + gSampleDmaStats.misses);
+    percentage = ((totalMemory[0] == 0) ? 0 : (((s64) gSampleDmaStats.hits * 1000) / totalMemory[0]));
+    sprintf(textBytes, "SAMPLE DMA: %d hits (%d.%d_), %d misses, %d evictions, %d overflows",
+            gSampleDmaStats.hits,
+            percentage / 10,
+            percentage % 10,
+            gSampleDmaStats.misses,
+            gSampleDmaStats.evictions,
+            gSampleDmaStats.overflows);
+    print_small_text(x, y, textBytes, PRINT_TEXT_ALIGN_LEFT, PRINT_ALL, FONT_OUTLINE);
+
+    y += 12;
+    sprintf(textBytes, "SAMPLE READ-AHEAD: %d prefetched, %d used",
+            gSampleDmaStats.prefetches,
+            gSampleDmaStats.prefetchHits);
+    print_small_text(x, y, textBytes, PRINT_TEXT_ALIGN_LEFT, PRINT_ALL, FONT_OUTLINE);
+#endif
+
+    y += 12;
+    sprintf(textBytes, "SOUND REQUESTS: peak %d / %d, %d dropped",
+            gSoundRequestRing.peak,
+            (gSoundRequestRing.mask + 1),
+            gSoundRequestRing.overflows);
+    print_small_text(x, y, textBytes, PRINT_TEXT_ALIGN_LEFT, PRINT_ALL, FONT_OUTLINE);
+
+#if defined(AUDIO_NOTE_COST_BUDGET) && (defined(VERSION_JP) || defined(VERSION_US))
+    y += 12;
+    sprintf(textBytes, "NOTE COST: %d / %d (peak %d), %d notes stolen",
+            gNoteBudgetStats.cost,
+            AUDIO_NOTE_COST_BUDGET,
+            gNoteBudgetStats.peakCost,
+            gNoteBudgetStats.steals);
+    print_small_text(x, y, textBytes, PRINT_TEXT_ALIGN_LEFT, PRINT_ALL, FONT_OUTLINE);
+#endif
 }
 
 void benchmark_custom(void) {
@@ -602,6 +679,12 @@ struct PuppyPrintPage ppPages[] = {
     {&print_ram_overview,          "Segments" },
     {&puppyprint_render_collision, "Collision"},
     {&print_console_log,           "Log"      },
+#ifdef PC_PROFILER
+    {&print_pc_profiler,           "Functions"},
+#endif
+#ifdef ALLOC_TRACE
+    {&print_alloc_trace,           "Pools"    },
+#endif
 };
 
 #define MENU_BOX_WIDTH 128
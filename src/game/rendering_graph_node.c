@@ -17,6 +17,8 @@
 #include "behavior_data.h"
 #include "string.h"
 #include "color_presets.h"
+#include "particle_system.h"
+#include "boot/alloc_trace.h"
 
 #include "config.h"
 #include "config/config_world.h"
@@ -61,8 +63,8 @@ struct GeoAnimState {
     /*0x01*/ u8 enabled;
     /*0x02*/ s16 frame;
     /*0x04*/ f32 translationMultiplier;
-    /*0x08*/ u16 *attribute;
-    /*0x0C*/ s16 *data;
+    /*0x08*/ s16 *pose;
+    /*0x0C*/ s16 *poseEnd;
 };
 
 // For some reason, this is a GeoAnimState struct, but the current state consists
@@ -73,8 +75,9 @@ u8 gCurrAnimType;
 u8 gCurrAnimEnabled;
 s16 gCurrAnimFrame;
 f32 gCurrAnimTranslationMultiplier;
-u16 *gCurrAnimAttribute;
-s16 *gCurrAnimData;
+// The current object's animation values for this frame, and the next one to be read.
+s16 *gCurrAnimPose;
+s16 *gCurrAnimPoseEnd;
 
 struct AllocOnlyPool *gDisplayListHeap;
 
@@ -164,6 +167,15 @@ ALIGNED16 struct GraphNodeObject *gCurGraphNodeObject = NULL;
 ALIGNED16 struct GraphNodeHeldObject *gCurGraphNodeHeldObject = NULL;
 u16 gAreaUpdateCounter = 0;
 
+#ifdef UNLOCK_FPS_INTERPOLATION
+u16 gInterpStep = 0;     // Game steps so far, set by the game loop
+f32 gInterpAlpha = 1.0f; // How far the frame being drawn is from the previous game step to the latest one
+u8 gInterpFrame = FALSE; // Whether the frame being drawn is one between game steps
+
+// Nodes that move further than this in one game step are drawn where they are, instead of sliding there.
+#define INTERP_MAX_DISTANCE 500.0f
+#endif
+
 #ifdef F3DEX_GBI_2
 LookAt lookAt;
 #endif
@@ -450,6 +462,9 @@ void geo_process_master_list(struct GraphNodeMasterList *node) {
 
     if (gCurGraphNodeMasterList == NULL && node->node.children != NULL) {
         gCurGraphNodeMasterList = node;
+#ifdef BATCH_CIRCLE_SHADOWS
+        reset_shadow_batches();
+#endif
         for (ucode = 0; ucode < GRAPH_NODE_NUM_UCODES; ucode++) {
             for (layer = LAYER_FIRST; layer < LAYER_COUNT; layer++) {
                 node->listHeads[ucode][layer] = NULL;
@@ -552,6 +567,120 @@ void geo_process_switch(struct GraphNodeSwitchCase *node) {
     }
 }
 
+#ifdef UNLOCK_FPS_INTERPOLATION
+/**
+ * Returns whether a node's latest saved state is from the step right before this one,
+ * so it can become the previous state to interpolate from.
+ */
+static s32 interp_is_continuous(u16 step) {
+    return (step == (u16)(gInterpStep - 1));
+}
+
+static s32 interp_is_teleport(Vec3f from, Vec3f to) {
+    Vec3f diff;
+
+    vec3f_diff(diff, to, from);
+    return (vec3_sumsq(diff) > sqr(INTERP_MAX_DISTANCE));
+}
+
+static void interp_vec3f(Vec3f dest, Vec3f from, Vec3f to) {
+    dest[0] = from[0] + ((to[0] - from[0]) * gInterpAlpha);
+    dest[1] = from[1] + ((to[1] - from[1]) * gInterpAlpha);
+    dest[2] = from[2] + ((to[2] - from[2]) * gInterpAlpha);
+}
+
+static void interp_vec3s(Vec3s dest, Vec3s from, Vec3s to) {
+    // The difference wraps, so angles take the short way around.
+    dest[0] = from[0] + ((s16)(to[0] - from[0]) * gInterpAlpha);
+    dest[1] = from[1] + ((s16)(to[1] - from[1]) * gInterpAlpha);
+    dest[2] = from[2] + ((s16)(to[2] - from[2]) * gInterpAlpha);
+}
+
+/**
+ * Gets where a camera is drawn this frame. The first call in each game step saves pos and focus
+ * as the latest state. Also used by the skybox, which is drawn before the camera node.
+ */
+void geo_interp_camera(struct CameraInterp *interp, Vec3f pos, Vec3f focus, Vec3f destPos, Vec3f destFocus) {
+    if (interp->step != gInterpStep) {
+        if (interp_is_continuous(interp->step)
+            && !interp_is_teleport(interp->pos[1], pos)
+            && !interp_is_teleport(interp->focus[1], focus)) {
+            vec3f_copy(interp->pos[0], interp->pos[1]);
+            vec3f_copy(interp->focus[0], interp->focus[1]);
+        } else {
+            vec3f_copy(interp->pos[0], pos);
+            vec3f_copy(interp->focus[0], focus);
+        }
+        vec3f_copy(interp->pos[1], pos);
+        vec3f_copy(interp->focus[1], focus);
+        interp->step = gInterpStep;
+    }
+
+    interp_vec3f(destPos, interp->pos[0], interp->pos[1]);
+    interp_vec3f(destFocus, interp->focus[0], interp->focus[1]);
+}
+
+/**
+ * Gets where an object is drawn this frame, saving its transform the first time it is drawn in each game step.
+ */
+static void geo_interp_object(struct GraphNodeObject *node, Vec3f pos, Vec3s angle, Vec3f scale) {
+    struct GraphNodeObjectInterp *interp = &node->interp;
+
+    if (interp->step != gInterpStep) {
+        if (interp_is_continuous(interp->step) && !interp_is_teleport(interp->pos[1], node->pos)) {
+            vec3f_copy(interp->pos[0], interp->pos[1]);
+            vec3s_copy(interp->angle[0], interp->angle[1]);
+            vec3f_copy(interp->scale[0], interp->scale[1]);
+        } else {
+            vec3f_copy(interp->pos[0], node->pos);
+            vec3s_copy(interp->angle[0], node->angle);
+            vec3f_copy(interp->scale[0], node->scale);
+        }
+        vec3f_copy(interp->pos[1], node->pos);
+        vec3s_copy(interp->angle[1], node->angle);
+        vec3f_copy(interp->scale[1], node->scale);
+        interp->step = gInterpStep;
+    }
+
+    interp_vec3f(pos, interp->pos[0], interp->pos[1]);
+    interp_vec3s(angle, interp->angle[0], interp->angle[1]);
+    interp_vec3f(scale, interp->scale[0], interp->scale[1]);
+}
+
+/**
+ * Blends the decoded pose with the animation frame from the previous game step,
+ * as long as the animation hasn't changed since.
+ */
+static void geo_interp_animation(struct AnimInfo *node, struct Animation *anim, s32 numValues) {
+    if (node->interpStep != gInterpStep) {
+        if (interp_is_continuous(node->interpStep)) {
+            node->interpAnim[0] = node->interpAnim[1];
+            node->interpFrame[0] = node->interpFrame[1];
+        } else {
+            node->interpAnim[0] = anim;
+            node->interpFrame[0] = node->animFrame;
+        }
+        node->interpAnim[1] = anim;
+        node->interpFrame[1] = node->animFrame;
+        node->interpStep = gInterpStep;
+    }
+
+    if (gInterpAlpha >= 1.0f || node->interpAnim[0] != anim || node->interpFrame[0] == node->animFrame) {
+        return;
+    }
+
+    s16 *prevPose = alloc_display_list(numValues * sizeof(s16));
+    if (prevPose == NULL) {
+        return;
+    }
+    decode_animation_frame(anim, node->interpFrame[0], prevPose);
+
+    for (s32 i = 0; i < numValues; i++) {
+        gCurrAnimPose[i] = prevPose[i] + ((s16)(gCurrAnimPose[i] - prevPose[i]) * gInterpAlpha);
+    }
+}
+#endif
+
 /**
  * Process a camera node.
  */
@@ -566,7 +695,14 @@ void geo_process_camera(struct GraphNodeCamera *node) {
 
     gSPMatrix(gDisplayListHead++, VIRTUAL_TO_PHYSICAL(rollMtx), G_MTX_PROJECTION | G_MTX_MUL | G_MTX_NOPUSH);
 
-    mtxf_lookat(cameraTransform, node->pos, node->focus, node->roll);
+#ifdef UNLOCK_FPS_INTERPOLATION
+    Vec3f pos, focus;
+    geo_interp_camera(&node->interp, node->pos, node->focus, pos, focus);
+#else
+    f32 *pos = node->pos;
+    f32 *focus = node->focus;
+#endif
+    mtxf_lookat(cameraTransform, pos, focus, node->roll);
     mtxf_mul(gMatStack[gMatStackIndex + 1], cameraTransform, gMatStack[gMatStackIndex]);
     inc_mat_stack();
 
@@ -574,6 +710,8 @@ void geo_process_camera(struct GraphNodeCamera *node) {
         gCurGraphNodeCamera = node;
         node->matrixPtr = &gMatStack[gMatStackIndex];
         geo_process_node_and_siblings(node->fnNode.node.children);
+        // Particles are in world space, so draw them with the camera's matrix
+        particles_render(pos, focus);
         gCurGraphNodeCamera = NULL;
     }
     gMatStackIndex--;
@@ -727,6 +865,41 @@ void geo_process_background(struct GraphNodeBackground *node) {
     }
 }
 
+/**
+ * Read the next animated part's translation and rotation from the current animation frame.
+ * The first part also takes the root translation, limited to the axes the animation has.
+ */
+static void geo_read_animated_part(Vec3f translation, Vec3s rotation) {
+    s16 *pose = gCurrAnimPose;
+    s32 type = gCurrAnimType;
+
+    if (type == ANIM_TYPE_NONE) {
+        return;
+    }
+
+    if (type != ANIM_TYPE_ROTATION) {
+        f32 multiplier = gCurrAnimTranslationMultiplier;
+
+        if (type == ANIM_TYPE_TRANSLATION || type == ANIM_TYPE_LATERAL_TRANSLATION) {
+            translation[0] += pose[0] * multiplier;
+            translation[2] += pose[2] * multiplier;
+        }
+        if (type == ANIM_TYPE_TRANSLATION || type == ANIM_TYPE_VERTICAL_TRANSLATION) {
+            translation[1] += pose[1] * multiplier;
+        }
+        pose += 3;
+        gCurrAnimType = ANIM_TYPE_ROTATION;
+    }
+
+    // Parts past the end of the animation keep their rest pose.
+    if (pose < gCurrAnimPoseEnd) {
+        rotation[0] += pose[0];
+        rotation[1] += pose[1];
+        rotation[2] += pose[2];
+    }
+    gCurrAnimPose = pose + 3;
+}
+
 /**
  * Render an animated part. The current animation state is not part of the node
  * but set in global variables. If an animated part is skipped, everything afterwards desyncs.
@@ -735,44 +908,7 @@ void geo_process_animated_part(struct GraphNodeAnimatedPart *node) {
     Vec3s rotation = { 0, 0, 0 };
     Vec3f translation = { node->translation[0], node->translation[1], node->translation[2] };
 
-    if (gCurrAnimType == ANIM_TYPE_TRANSLATION) {
-        translation[0] += gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)]
-                          * gCurrAnimTranslationMultiplier;
-        translation[1] += gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)]
-                          * gCurrAnimTranslationMultiplier;
-        translation[2] += gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)]
-                          * gCurrAnimTranslationMultiplier;
-        gCurrAnimType = ANIM_TYPE_ROTATION;
-    } else {
-        if (gCurrAnimType == ANIM_TYPE_LATERAL_TRANSLATION) {
-            translation[0] +=
-                gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)]
-                * gCurrAnimTranslationMultiplier;
-            gCurrAnimAttribute += 2;
-            translation[2] +=
-                gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)]
-                * gCurrAnimTranslationMultiplier;
-            gCurrAnimType = ANIM_TYPE_ROTATION;
-        } else {
-            if (gCurrAnimType == ANIM_TYPE_VERTICAL_TRANSLATION) {
-                gCurrAnimAttribute += 2;
-                translation[1] +=
-                    gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)]
-                    * gCurrAnimTranslationMultiplier;
-                gCurrAnimAttribute += 2;
-                gCurrAnimType = ANIM_TYPE_ROTATION;
-            } else if (gCurrAnimType == ANIM_TYPE_NO_TRANSLATION) {
-                gCurrAnimAttribute += 6;
-                gCurrAnimType = ANIM_TYPE_ROTATION;
-            }
-        }
-    }
-
-    if (gCurrAnimType == ANIM_TYPE_ROTATION) {
-        rotation[0] = gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)];
-        rotation[1] = gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)];
-        rotation[2] = gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)];
-    }
+    geo_read_animated_part(translation, rotation);
 
     mtxf_rotate_xyz_and_translate_and_mul(rotation, translation, gMatStack[gMatStackIndex + 1], gMatStack[gMatStackIndex]);
 
@@ -787,44 +923,7 @@ void geo_process_bone(struct GraphNodeBone *node) {
     Vec3s rotation    = { node->rotation[0],    node->rotation[1],    node->rotation[2]    };
     Vec3f translation = { node->translation[0], node->translation[1], node->translation[2] };
 
-    if (gCurrAnimType == ANIM_TYPE_TRANSLATION) {
-        translation[0] += gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)]
-                          * gCurrAnimTranslationMultiplier;
-        translation[1] += gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)]
-                          * gCurrAnimTranslationMultiplier;
-        translation[2] += gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)]
-                          * gCurrAnimTranslationMultiplier;
-        gCurrAnimType = ANIM_TYPE_ROTATION;
-    } else {
-        if (gCurrAnimType == ANIM_TYPE_LATERAL_TRANSLATION) {
-            translation[0] +=
-                gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)]
-                * gCurrAnimTranslationMultiplier;
-            gCurrAnimAttribute += 2;
-            translation[2] +=
-                gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)]
-                * gCurrAnimTranslationMultiplier;
-            gCurrAnimType = ANIM_TYPE_ROTATION;
-        } else {
-            if (gCurrAnimType == ANIM_TYPE_VERTICAL_TRANSLATION) {
-                gCurrAnimAttribute += 2;
-                translation[1] +=
-                    gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)]
-                    * gCurrAnimTranslationMultiplier;
-                gCurrAnimAttribute += 2;
-                gCurrAnimType = ANIM_TYPE_ROTATION;
-            } else if (gCurrAnimType == ANIM_TYPE_NO_TRANSLATION) {
-                gCurrAnimAttribute += 6;
-                gCurrAnimType = ANIM_TYPE_ROTATION;
-            }
-        }
-    }
-
-    if (gCurrAnimType == ANIM_TYPE_ROTATION) {
-        rotation[0] += gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)];
-        rotation[1] += gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)];
-        rotation[2] += gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)];
-    }
+    geo_read_animated_part(translation, rotation);
 
     mtxf_rotate_xyz_and_translate_and_mul(rotation, translation, gMatStack[gMatStackIndex + 1], gMatStack[gMatStackIndex]);
 
@@ -855,8 +954,19 @@ void geo_set_animation_globals(struct AnimInfo *node, s32 hasAnimation) {
 
     gCurrAnimFrame = node->animFrame;
     gCurrAnimEnabled = (anim->flags & ANIM_FLAG_DISABLED) == 0;
-    gCurrAnimAttribute = segmented_to_virtual((void *) anim->index);
-    gCurrAnimData = segmented_to_virtual((void *) anim->values);
+
+    // Decode the whole frame up front, so each part only has to read its three values.
+    s32 numValues = (anim->numParts + 1) * 3;
+    gCurrAnimPose = alloc_display_list(numValues * sizeof(s16));
+    if (gCurrAnimPose == NULL) {
+        gCurrAnimType = ANIM_TYPE_NONE;
+        return;
+    }
+    decode_animation_frame(anim, gCurrAnimFrame, gCurrAnimPose);
+    gCurrAnimPoseEnd = gCurrAnimPose + numValues;
+#ifdef UNLOCK_FPS_INTERPOLATION
+    geo_interp_animation(node, anim, numValues);
+#endif
 
     if (anim->animYTransDivisor == 0) {
         gCurrAnimTranslationMultiplier = 1.0f;
@@ -865,6 +975,37 @@ void geo_set_animation_globals(struct AnimInfo *node, s32 hasAnimation) {
     }
 }
 
+#ifdef BATCH_CIRCLE_SHADOWS
+/**
+ * Add the current shadow to the batch for its layer, starting the batch if this is the
+ * first shadow on that layer in the frame. Return FALSE if it couldn't be batched.
+ */
+static s32 geo_add_shadow_to_batch(Vec3f shadowPos) {
+    s32 isDecal = gCurrShadow.isDecal;
+
+    if (get_shadow_batch(isDecal) == NULL) {
+        Gfx *batchList = start_shadow_batch(isDecal, gCurGraphNodeCamera->pos);
+        if (batchList == NULL) {
+            return FALSE;
+        }
+
+        Mat4 batchMtx;
+        get_shadow_batch_matrix(batchMtx, isDecal);
+        mtxf_mul(gMatStack[gMatStackIndex + 1], batchMtx, *gCurGraphNodeCamera->matrixPtr);
+
+        inc_mat_stack();
+        geo_append_display_list(
+            (void *) VIRTUAL_TO_PHYSICAL(batchList),
+            isDecal ? LAYER_TRANSPARENT_DECAL : LAYER_TRANSPARENT
+        );
+
+        gMatStackIndex--;
+    }
+
+    return add_shadow_to_batch(shadowPos, gCurGraphNodeObject->angle[1]);
+}
+#endif
+
 /**
  * Process a shadow node. Renders a shadow under an object offset by the
  * translation of the first animated component and rotated according to
@@ -881,7 +1022,12 @@ void geo_process_shadow(struct GraphNodeShadow *node) {
                                        *gCurGraphNodeCamera->matrixPtr);
             shadowScale = node->shadowScale * gCurGraphNodeHeldObject->objNode->header.gfx.scale[0];
         } else {
+#ifdef UNLOCK_FPS_INTERPOLATION
+            // Where the object is drawn, which is between its last two game steps
+            get_pos_from_transform_mtx(shadowPos, *gCurGraphNodeObject->throwMatrix, *gCurGraphNodeCamera->matrixPtr);
+#else
             vec3f_copy(shadowPos, gCurGraphNodeObject->pos);
+#endif
             shadowScale = node->shadowScale * gCurGraphNodeObject->scale[0];
         }
 
@@ -899,11 +1045,9 @@ void geo_process_shadow(struct GraphNodeShadow *node) {
 
             f32 animScale = gCurrAnimTranslationMultiplier * objScale;
             Vec3f animOffset;
-            animOffset[0] = gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)] * animScale;
+            animOffset[0] = gCurrAnimPose[0] * animScale;
             animOffset[1] = 0.0f;
-            gCurrAnimAttribute += 2;
-            animOffset[2] = gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)] * animScale;
-            gCurrAnimAttribute -= 6;
+            animOffset[2] = gCurrAnimPose[2] * animScale;
 
             // simple matrix rotation so the shadow offset rotates along with the object
             f32 sinAng = sins(gCurGraphNodeObject->angle[1]);
@@ -913,8 +1057,16 @@ void geo_process_shadow(struct GraphNodeShadow *node) {
             shadowPos[2] += -animOffset[0] * sinAng + animOffset[2] * cosAng;
         }
 
-        Gfx *shadowList = create_shadow_below_xyz(shadowPos, shadowScale * 0.5f,
-                                                  node->shadowSolidity, node->shadowType, shifted);
+        Gfx *shadowList = NULL;
+
+        if (find_shadow_below_xyz(shadowPos, shadowScale * 0.5f, node->shadowSolidity, node->shadowType, shifted)) {
+#ifdef BATCH_CIRCLE_SHADOWS
+            if (node->shadowType != SHADOW_CIRCLE || !geo_add_shadow_to_batch(shadowPos))
+#endif
+            {
+                shadowList = create_shadow_display_list(node->shadowType);
+            }
+        }
 
         if (shadowList != NULL) {
             mtxf_shadow(gMatStack[gMatStackIndex + 1], *gCurGraphNodeCamera->matrixPtr,
@@ -1053,16 +1205,26 @@ void visualise_object_hitbox(struct Object *node) {
  */
 void geo_process_object(struct Object *node) {
     if (node->header.gfx.areaIndex == gCurGraphNodeRoot->areaIndex) {
+#ifdef UNLOCK_FPS_INTERPOLATION
+        Vec3f pos, scale;
+        Vec3s angle;
+        geo_interp_object(&node->header.gfx, pos, angle, scale);
+#else
+        f32 *pos = node->header.gfx.pos;
+        f32 *scale = node->header.gfx.scale;
+        s16 *angle = node->header.gfx.angle;
+#endif
+
         if (node->header.gfx.throwMatrix != NULL) {
             mtxf_mul(gMatStack[gMatStackIndex + 1], *node->header.gfx.throwMatrix,
                      gMatStack[gMatStackIndex]);
-            mtxf_scale_vec3f(gMatStack[gMatStackIndex + 1], gMatStack[gMatStackIndex + 1], node->header.gfx.scale);
+            mtxf_scale_vec3f(gMatStack[gMatStackIndex + 1], gMatStack[gMatStackIndex + 1], scale);
         } else if (node->header.gfx.node.flags & GRAPH_RENDER_BILLBOARD) {
             mtxf_billboard(gMatStack[gMatStackIndex + 1], gMatStack[gMatStackIndex],
-                           node->header.gfx.pos, node->header.gfx.scale, gCurGraphNodeCamera->roll);
+                           pos, scale, gCurGraphNodeCamera->roll);
         } else {
-            mtxf_rotate_zxy_and_translate_and_mul(node->header.gfx.angle, node->header.gfx.pos, gMatStack[gMatStackIndex + 1], gMatStack[gMatStackIndex]);
-            mtxf_scale_vec3f(gMatStack[gMatStackIndex + 1], gMatStack[gMatStackIndex + 1], node->header.gfx.scale);
+            mtxf_rotate_zxy_and_translate_and_mul(angle, pos, gMatStack[gMatStackIndex + 1], gMatStack[gMatStackIndex]);
+            mtxf_scale_vec3f(gMatStack[gMatStackIndex + 1], gMatStack[gMatStackIndex + 1], scale);
         }
 
         node->header.gfx.throwMatrix = &gMatStack[++gMatStackIndex];
@@ -1147,8 +1309,8 @@ void geo_process_held_object(struct GraphNodeHeldObject *node) {
         gGeoTempState.enabled = gCurrAnimEnabled;
         gGeoTempState.frame = gCurrAnimFrame;
         gGeoTempState.translationMultiplier = gCurrAnimTranslationMultiplier;
-        gGeoTempState.attribute = gCurrAnimAttribute;
-        gGeoTempState.data = gCurrAnimData;
+        gGeoTempState.pose = gCurrAnimPose;
+        gGeoTempState.poseEnd = gCurrAnimPoseEnd;
         gCurrAnimType = ANIM_TYPE_NONE;
         gCurGraphNodeHeldObject = (void *) node;
         if (node->objNode->header.gfx.animInfo.curAnim != NULL) {
@@ -1161,8 +1323,8 @@ void geo_process_held_object(struct GraphNodeHeldObject *node) {
         gCurrAnimEnabled = gGeoTempState.enabled;
         gCurrAnimFrame = gGeoTempState.frame;
         gCurrAnimTranslationMultiplier = gGeoTempState.translationMultiplier;
-        gCurrAnimAttribute = gGeoTempState.attribute;
-        gCurrAnimData = gGeoTempState.data;
+        gCurrAnimPose = gGeoTempState.pose;
+        gCurrAnimPoseEnd = gGeoTempState.poseEnd;
         gMatStackIndex--;
     }
 
@@ -1243,6 +1405,7 @@ void geo_process_root(struct GraphNodeRoot *node, Vp *b, Vp *c, s32 clearColor)
         Mtx *initialMatrix;
         Vp *viewport = alloc_display_list(sizeof(*viewport));
 
+        ALLOC_TRACE_TRANSIENT(ALLOC_TRACE_DISPLAY_LIST);
         gDisplayListHeap = alloc_only_pool_init(main_pool_available() - sizeof(struct AllocOnlyPool), MEMORY_POOL_LEFT);
         initialMatrix = alloc_display_list(sizeof(*initialMatrix));
         gMatStackIndex = 0;
@@ -14,6 +14,34 @@ extern struct GraphNodeHeldObject  *gCurGraphNodeHeldObject;
 #define gCurGraphNodeObjectNode ((struct Object *)gCurGraphNodeObject)
 extern u16 gAreaUpdateCounter;
 
+#ifdef UNLOCK_FPS_INTERPOLATION
+extern u16 gInterpStep;
+extern f32 gInterpAlpha;
+extern u8 gInterpFrame;
+
+// A step nothing can have been saved in, for nodes that shouldn't be interpolated from their old state.
+#define INTERP_STEP_STALE ((u16)(gInterpStep - 2))
+#endif
+
+/**
+ * The display list a geo function made for a game step. Geo functions whose logic advances every
+ * call draw it again on the frames between steps, rather than running their logic once per frame.
+ */
+struct GeoStepCache {
+    Gfx *gfx;
+    u16 step;
+};
+
+#ifdef UNLOCK_FPS_INTERPOLATION
+#define GEO_STEP_CACHED(cache) (gInterpFrame && ((cache)->step == gInterpStep))
+#define GEO_STEP_CACHE_SAVE(cache, dl) { (cache)->gfx = (dl); (cache)->step = gInterpStep; }
+#define IS_INTERP_FRAME() gInterpFrame
+#else
+#define GEO_STEP_CACHED(cache) FALSE
+#define GEO_STEP_CACHE_SAVE(cache, dl)
+#define IS_INTERP_FRAME() FALSE
+#endif
+
 enum AnimType {
     // after processing an object, the type is reset to this
     ANIM_TYPE_NONE,
@@ -84,7 +112,11 @@ enum AnimType {
 
 #define RENDER_PHASE_FIRST 0
 
+void geo_append_display_list(void *displayList, s32 layer);
 void geo_process_node_and_siblings(struct GraphNode *firstNode);
 void geo_process_root(struct GraphNodeRoot *node, Vp *b, Vp *c, s32 clearColor);
+#ifdef UNLOCK_FPS_INTERPOLATION
+void geo_interp_camera(struct CameraInterp *interp, Vec3f pos, Vec3f focus, Vec3f destPos, Vec3f destFocus);
+#endif
 
 #endif // RENDERING_GRAPH_NODE_H
@@ -81,24 +81,24 @@ static s32 read_eeprom_data(void *buffer, s32 size) {
 }
 
 /**
- * Write data to EEPROM.
- * The EEPROM address is computed using the offset of the source address from gSaveBuffer.
+ * Write one block to EEPROM at the given byte offset into the save data.
  * Try at most 4 times, and return 0 on success. On failure, return the status returned from
- * osEepromLongWrite. Unlike read_eeprom_data, return 1 if EEPROM isn't loaded.
+ * osEepromWrite. Unlike read_eeprom_data, return 1 if EEPROM isn't loaded.
+ * Unlike osEepromLongWrite, this doesn't wait for the EEPROM to finish writing the block,
+ * see save_file_process_writes.
  */
-static s32 write_eeprom_data(void *buffer, s32 size) {
+static s32 write_eeprom_data(u32 offset, void *buffer, UNUSED s32 size) {
     s32 status = 1;
 
     if (gEepromProbe != 0) {
         s32 triesLeft = 4;
-        u32 offset = (u32)((u8 *) buffer - (u8 *) &gSaveBuffer) >> 3;
 
         do {
 #if ENABLE_RUMBLE
             block_until_rumble_pak_free();
 #endif
             triesLeft--;
-            status = osEepromLongWrite(&gSIEventMesgQueue, offset, buffer, size);
+            status = osEepromWrite(&gSIEventMesgQueue, offset >> 3, buffer);
 #if ENABLE_RUMBLE
             release_rumble_pak_control();
 #endif
@@ -138,17 +138,15 @@ static s32 read_eeprom_data(void *buffer, s32 size) {
 }
 
 /**
- * Write data to SRAM.
- * The SRAM address is computed using the offset of the source address from gSaveBuffer.
+ * Write data to SRAM at the given byte offset into the save data.
  * Try at most 4 times, and return 0 on success. On failure, return the status returned from
  * nuPiWriteSram. Unlike read_eeprom_data, return 1 if SRAM isn't loaded.
  */
-static s32 write_eeprom_data(void *buffer, s32 size) {
+static s32 write_eeprom_data(u32 offset, void *buffer, s32 size) {
     s32 status = 1;
 
     if (gSramProbe != 0) {
         s32 triesLeft = 4;
-        u32 offset = (u32)((u8 *) buffer - (u8 *) &gSaveBuffer);
 
         do {
 #if ENABLE_RUMBLE
@@ -166,6 +164,115 @@ static s32 write_eeprom_data(void *buffer, s32 size) {
 }
 #endif
 
+#define SAVE_BLOCK_SIZE 8
+#define NUM_SAVE_BLOCKS ((sizeof(struct SaveBuffer) + SAVE_BLOCK_SIZE - 1) / SAVE_BLOCK_SIZE)
+
+// How long EEPROM takes to write a block, which osEepromLongWrite would wait out after every block.
+#define EEPROM_WRITE_CYCLE_TIME OS_USEC_TO_CYCLES(12000)
+
+// What the save device holds, and what it will hold once every queued write is done.
+static u8 sSaveDeviceData[NUM_SAVE_BLOCKS * SAVE_BLOCK_SIZE] ALIGNED8;
+static u8 sSavePendingData[NUM_SAVE_BLOCKS * SAVE_BLOCK_SIZE] ALIGNED8;
+
+static u8 sDirtySaveBlocks[(NUM_SAVE_BLOCKS + 7) / 8];
+static s32 sNumDirtySaveBlocks = 0;
+static OSTime sLastSaveWriteTime = 0;
+static void (*sSaveWriteCallback)(void) = NULL;
+
+static s32 is_save_block_dirty(u32 block) {
+    return (sDirtySaveBlocks[block / 8] & (1 << (block % 8))) != 0;
+}
+
+static void set_save_block_dirty(u32 block, s32 dirty) {
+    if (is_save_block_dirty(block) == dirty) {
+        return;
+    }
+
+    sDirtySaveBlocks[block / 8] ^= (1 << (block % 8));
+    sNumDirtySaveBlocks += (dirty ? 1 : -1);
+}
+
+/**
+ * Queue part of gSaveBuffer to be written to the save device. Only the blocks that differ
+ * from what the device holds are written, a slice at a time by save_file_process_writes,
+ * so saving doesn't stall the game thread.
+ */
+static void queue_save_write(void *buffer, s32 size) {
+    u32 start = (u32)((u8 *) buffer - (u8 *) &gSaveBuffer);
+    u32 endBlock = (start + size + SAVE_BLOCK_SIZE - 1) / SAVE_BLOCK_SIZE;
+    u32 block;
+
+    bcopy(buffer, &sSavePendingData[start], size);
+
+    for (block = start / SAVE_BLOCK_SIZE; block < endBlock; block++) {
+        u32 *pending = (u32 *) &sSavePendingData[block * SAVE_BLOCK_SIZE];
+        u32 *device = (u32 *) &sSaveDeviceData[block * SAVE_BLOCK_SIZE];
+
+        set_save_block_dirty(block, (pending[0] != device[0] || pending[1] != device[1]));
+    }
+}
+
+/**
+ * Write the next slice of queued save data. EEPROM is written one block per call, and only
+ * once the previous block has had time to finish. SRAM writes the next run of dirty blocks.
+ * Called every frame by the game loop while the SI is free.
+ */
+void save_file_process_writes(void) {
+    void (*callback)(void);
+    u32 firstBlock = 0;
+    u32 numBlocks = 1;
+    u32 block;
+    s32 status;
+
+    if (sNumDirtySaveBlocks == 0) {
+        return;
+    }
+
+#ifdef EEP
+    if ((osGetTime() - sLastSaveWriteTime) < EEPROM_WRITE_CYCLE_TIME) {
+        return;
+    }
+#endif
+
+    while (!is_save_block_dirty(firstBlock)) {
+        firstBlock++;
+    }
+#ifdef SRAM
+    while ((firstBlock + numBlocks) < NUM_SAVE_BLOCKS && is_save_block_dirty(firstBlock + numBlocks)) {
+        numBlocks++;
+    }
+#endif
+
+    status = write_eeprom_data(firstBlock * SAVE_BLOCK_SIZE, &sSavePendingData[firstBlock * SAVE_BLOCK_SIZE],
+                               numBlocks * SAVE_BLOCK_SIZE);
+    sLastSaveWriteTime = osGetTime();
+
+    // A failed write is dropped after write_eeprom_data's retries, as it was when saving was synchronous.
+    for (block = firstBlock; block < (firstBlock + numBlocks); block++) {
+        if (status == 0) {
+            bcopy(&sSavePendingData[block * SAVE_BLOCK_SIZE], &sSaveDeviceData[block * SAVE_BLOCK_SIZE], SAVE_BLOCK_SIZE);
+        }
+        set_save_block_dirty(block, FALSE);
+    }
+
+    if (sNumDirtySaveBlocks == 0 && sSaveWriteCallback != NULL) {
+        callback = sSaveWriteCallback;
+        sSaveWriteCallback = NULL;
+        callback();
+    }
+}
+
+/**
+ * Call callback once every save write queued so far has reached the save device,
+ * or right away if there's nothing left to write.
+ */
+void save_file_set_write_callback(void (*callback)(void)) {
+    if (sNumDirtySaveBlocks == 0) {
+        callback();
+    } else {
+        sSaveWriteCallback = callback;
+    }
+}
 
 /**
  * Sum the bytes in data to data + size - 2. The last two bytes are ignored
@@ -211,7 +318,7 @@ static void save_main_menu_data(void) {
         add_save_block_signature(&gSaveBuffer.menuData, sizeof(gSaveBuffer.menuData), MENU_DATA_MAGIC);
 
         // Write to EEPROM
-        write_eeprom_data(&gSaveBuffer.menuData, sizeof(gSaveBuffer.menuData));
+        queue_save_write(&gSaveBuffer.menuData, sizeof(gSaveBuffer.menuData));
 
         gMainMenuDataModified = FALSE;
     }
@@ -287,8 +394,8 @@ static void restore_save_file_data(s32 fileIndex, s32 srcSlot) {
           sizeof(gSaveBuffer.files[fileIndex][destSlot]));
 
     // Write destination data to EEPROM
-    write_eeprom_data(&gSaveBuffer.files[fileIndex][destSlot],
-                      sizeof(gSaveBuffer.files[fileIndex][destSlot]));
+    queue_save_write(&gSaveBuffer.files[fileIndex][destSlot],
+                     sizeof(gSaveBuffer.files[fileIndex][destSlot]));
 }
 
 void save_file_do_save(s32 fileIndex) {
@@ -302,7 +409,7 @@ void save_file_do_save(s32 fileIndex) {
               sizeof(gSaveBuffer.files[fileIndex][1]));
 
         // Write to EEPROM
-        write_eeprom_data(&gSaveBuffer.files[fileIndex], sizeof(gSaveBuffer.files[fileIndex]));
+        queue_save_write(&gSaveBuffer.files[fileIndex], sizeof(gSaveBuffer.files[fileIndex]));
 
         gSaveFileModified = FALSE;
     }
@@ -336,6 +443,8 @@ void save_file_load_all(void) {
 
     bzero(&gSaveBuffer, sizeof(gSaveBuffer));
     read_eeprom_data(&gSaveBuffer, sizeof(gSaveBuffer));
+    bcopy(&gSaveBuffer, sSaveDeviceData, sizeof(gSaveBuffer));
+    bcopy(&gSaveBuffer, sSavePendingData, sizeof(gSaveBuffer));
 
     // Verify the main menu data and wipe it if invalid.
     validSlots = verify_save_block_signature(&gSaveBuffer.menuData, sizeof(gSaveBuffer.menuData), MENU_DATA_MAGIC);
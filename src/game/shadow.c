@@ -179,18 +179,27 @@ static void add_shadow_to_display_list(Gfx *displayListHead, s8 shadowType) {
     gSPEndDisplayList(displayListHead);
 }
 
-//! TODO:
-//      - Breakout create_shadow_below_xyz into multiple functions
 /**
- * Create a shadow at the absolute position given, with the given parameters.
- * Return a pointer to the display list representing the shadow.
+ * Set up gCurrShadow for a shadow below the absolute position given, with the given parameters,
+ * and move pos down to the shadow's height. Return whether there is a shadow to draw.
  */
-Gfx *create_shadow_below_xyz(Vec3f pos, s16 shadowScale, u8 shadowSolidity, s8 shadowType, s8 shifted) {
+s32 find_shadow_below_xyz(Vec3f pos, s16 shadowScale, u8 shadowSolidity, s8 shadowType, s8 shifted) {
     struct Object *obj = gCurGraphNodeObjectNode;
     // Check if the object exists.
     if (obj == NULL) {
-        return NULL;
+        return FALSE;
+    }
+
+#ifdef SHADOW_DRAW_DISTANCE
+    // Skip far away shadows before looking for their floor.
+    f32 camDist = 0.0f;
+    if (obj != gMarioObject) {
+        camDist = vec3_mag(gCurGraphNodeObject->cameraToObject);
+        if (camDist >= SHADOW_DRAW_DISTANCE) {
+            return FALSE;
+        }
     }
+#endif
 
     // The floor underneath the object.
     struct Surface *floor = NULL;
@@ -219,7 +228,7 @@ Gfx *create_shadow_below_xyz(Vec3f pos, s16 shadowScale, u8 shadowSolidity, s8 s
 
         // No shadow if the position is OOB.
         if (floor == NULL) {
-            return NULL;
+            return FALSE;
         }
 
         // Skip shifting the shadow height later, since the find_floor call above uses the already shifted position.
@@ -288,7 +297,7 @@ Gfx *create_shadow_below_xyz(Vec3f pos, s16 shadowScale, u8 shadowSolidity, s8 s
 
         // No shadow if the y-normal is negative (an unexpected result).
         if (ny <= 0.0f) {
-            return NULL;
+            return FALSE;
         }
 
         // If the animation changes the shadow position, move its height to the new position.
@@ -299,7 +308,7 @@ Gfx *create_shadow_below_xyz(Vec3f pos, s16 shadowScale, u8 shadowSolidity, s8 s
 
     // No shadow if the floor is lower than expected possible,
     if (floorHeight < FLOOR_LOWER_LIMIT_MISC) {
-        return NULL;
+        return FALSE;
     }
 
     // Get the vertical distance to the shadow, now that the final shadow height is set.
@@ -307,12 +316,12 @@ Gfx *create_shadow_below_xyz(Vec3f pos, s16 shadowScale, u8 shadowSolidity, s8 s
 
     // No shadow if the object is below it.
     if (distToShadow < -80.0f) {
-        return NULL;
+        return FALSE;
     }
 
     // No shadow if the non-Mario object is too high.
     if (!isPlayer && distToShadow > 1024.0f) {
-        return NULL;
+        return FALSE;
     }
 
     vec3f_set(s->floorNormal, nx, ny, nz);
@@ -322,23 +331,23 @@ Gfx *create_shadow_below_xyz(Vec3f pos, s16 shadowScale, u8 shadowSolidity, s8 s
         s32 solidityAction = correct_shadow_solidity_for_animations(shadowSolidity);
         switch (solidityAction) {
             case SHADOW_SOLIDITY_NO_SHADOW:
-                return NULL;
+                return FALSE;
             case SHADOW_SOILDITY_ALREADY_SET:
                 if (init_shadow(distToShadow, shadowScale, shadowType, /* overwriteSolidity */ 0)) {
-                    return NULL;
+                    return FALSE;
                 }
                 break;
             case SHADOW_SOLIDITY_NOT_YET_SET:
                 if (init_shadow(distToShadow, shadowScale, shadowType, shadowSolidity)) {
-                    return NULL;
+                    return FALSE;
                 }
                 break;
             default:
-                return NULL;
+                return FALSE;
         }
     } else {
         if (init_shadow(distToShadow, shadowScale, shadowType, shadowSolidity)) {
-            return NULL;
+            return FALSE;
         }
 
         // Get the scaling modifiers for rectangular shadows (Whomp and Spindel).
@@ -353,6 +362,26 @@ Gfx *create_shadow_below_xyz(Vec3f pos, s16 shadowScale, u8 shadowSolidity, s8 s
         }
     }
 
+#ifdef SHADOW_DRAW_DISTANCE
+    // Fade out over the last quarter of the draw distance.
+    if (camDist > (SHADOW_DRAW_DISTANCE * 0.75f)) {
+        s->solidity = (s->solidity * (SHADOW_DRAW_DISTANCE - camDist)) / (SHADOW_DRAW_DISTANCE * 0.25f);
+        if (s->solidity == 0) {
+            return FALSE;
+        }
+    }
+#endif
+
+    // Move the shadow position to the floor height.
+    pos[1] = floorHeight;
+
+    return TRUE;
+}
+
+/**
+ * Create the display list for the shadow set up by find_shadow_below_xyz.
+ */
+Gfx *create_shadow_display_list(s8 shadowType) {
     Gfx *displayList = alloc_display_list(4 * sizeof(Gfx));
 
     if (displayList == NULL) {
@@ -362,8 +391,161 @@ Gfx *create_shadow_below_xyz(Vec3f pos, s16 shadowScale, u8 shadowSolidity, s8 s
     // Generate the shadow display list with type and solidity.
     add_shadow_to_display_list(displayList, shadowType);
 
-    // Move the shadow position to the floor height.
-    pos[1] = floorHeight;
-
     return displayList;
 }
+
+/**
+ * Create a shadow at the absolute position given, with the given parameters.
+ * Return a pointer to the display list representing the shadow.
+ */
+Gfx *create_shadow_below_xyz(Vec3f pos, s16 shadowScale, u8 shadowSolidity, s8 shadowType, s8 shifted) {
+    if (!find_shadow_below_xyz(pos, shadowScale, shadowSolidity, shadowType, shifted)) {
+        return NULL;
+    }
+
+    return create_shadow_display_list(shadowType);
+}
+
+#ifdef BATCH_CIRCLE_SHADOWS
+/**
+ * Circle shadows are written straight into a per-layer vertex buffer in world space
+ * (relative to the batch's origin), so a whole layer's shadows share one matrix,
+ * one texture load and one set of render settings.
+ */
+
+// Vertex positions are stored in 1/SHADOW_BATCH_PRECISION units to keep small shadows smooth.
+#define SHADOW_BATCH_PRECISION 4
+// Furthest a shadow can be from the batch's origin before its vertices overflow.
+#define SHADOW_BATCH_RANGE     ((0x7FFF / SHADOW_BATCH_PRECISION) - 0x100)
+// Shadows loaded into the vertex cache at once (4 vertices each).
+#define SHADOW_BATCH_GROUP     8
+// Shadows per batch. Any more are drawn on their own.
+#define MAX_BATCHED_SHADOWS    (SHADOW_BATCH_GROUP * 4)
+
+#ifdef HD_SHADOWS
+    #define SHADOW_TEX_COORD 2048
+#else
+    #define SHADOW_TEX_COORD 512
+#endif
+
+struct ShadowBatch {
+    Vtx *verts;
+    Gfx *displayList;
+    Gfx *head;       // Next free command, which holds the branch to the end of the batch
+    Gfx *vertexLoad; // Vertex load for the current group of shadows
+    Vec3f origin;
+    s16 count;
+};
+
+static struct ShadowBatch sShadowBatches[2];
+static Mat4 sShadowBatchIdentity;
+
+/**
+ * Forget the previous frame's batches. Called when a new master list is started.
+ */
+void reset_shadow_batches(void) {
+    sShadowBatches[FALSE].displayList = NULL;
+    sShadowBatches[TRUE].displayList = NULL;
+    mtxf_identity(sShadowBatchIdentity);
+}
+
+/**
+ * Return the display list of the batch for decal or non-decal shadows, or NULL if it
+ * hasn't been started this frame.
+ */
+Gfx *get_shadow_batch(s32 isDecal) {
+    return sShadowBatches[isDecal != FALSE].displayList;
+}
+
+/**
+ * Start the batch for decal or non-decal shadows, with vertices relative to origin.
+ * The caller appends the returned display list with the matrix from get_shadow_batch_matrix.
+ */
+Gfx *start_shadow_batch(s32 isDecal, Vec3f origin) {
+    struct ShadowBatch *batch = &sShadowBatches[isDecal != FALSE];
+
+    batch->verts = alloc_display_list(MAX_BATCHED_SHADOWS * 4 * sizeof(Vtx));
+    batch->displayList = alloc_display_list((2 + MAX_BATCHED_SHADOWS + (MAX_BATCHED_SHADOWS / SHADOW_BATCH_GROUP)) * sizeof(Gfx));
+    if (batch->verts == NULL || batch->displayList == NULL) {
+        batch->displayList = NULL;
+        return NULL;
+    }
+
+    vec3f_copy(batch->origin, origin);
+    batch->count = 0;
+    batch->head = batch->displayList;
+    gSPDisplayList(batch->head++, dl_shadow_batch_circle);
+    gSPBranchList(batch->head, dl_shadow_batch_end);
+
+    return batch->displayList;
+}
+
+/**
+ * Set mtx to the world space transform of a batch's vertices.
+ */
+void get_shadow_batch_matrix(Mat4 mtx, s32 isDecal) {
+    struct ShadowBatch *batch = &sShadowBatches[isDecal != FALSE];
+
+    mtxf_identity(mtx);
+    mtx[0][0] = mtx[1][1] = mtx[2][2] = (1.0f / SHADOW_BATCH_PRECISION);
+    vec3f_copy(mtx[3], batch->origin);
+}
+
+/**
+ * Add the shadow set up by find_shadow_below_xyz to its layer's batch. pos is the
+ * shadow's position on the floor. Return FALSE if it has to be drawn on its own instead.
+ */
+s32 add_shadow_to_batch(Vec3f pos, s16 yaw) {
+    struct ShadowBatch *batch = &sShadowBatches[s->isDecal != FALSE];
+    Vec3f relPos;
+    Mat4 mtx;
+    Vtx *v;
+    s32 i, index;
+
+    if (batch->displayList == NULL || batch->count >= MAX_BATCHED_SHADOWS) {
+        return FALSE;
+    }
+
+    vec3f_diff(relPos, pos, batch->origin);
+    if (ABS(relPos[0]) > SHADOW_BATCH_RANGE
+        || ABS(relPos[1]) > SHADOW_BATCH_RANGE
+        || ABS(relPos[2]) > SHADOW_BATCH_RANGE) {
+        return FALSE;
+    }
+
+    mtxf_shadow(mtx, sShadowBatchIdentity, s->floorNormal, relPos, s->scale, yaw);
+
+    // Same corners as vertex_shadow.
+    v = &batch->verts[batch->count * 4];
+    for (i = 0; i < 4; i++) {
+        f32 cornerX = ((i & 1) ? 1.0f : -1.0f);
+        f32 cornerZ = ((i & 2) ? 1.0f : -1.0f);
+
+        v[i].v.ob[0] = ((mtx[3][0] + (mtx[0][0] * cornerX) + (mtx[2][0] * cornerZ)) * SHADOW_BATCH_PRECISION);
+        v[i].v.ob[1] = ((mtx[3][1] + (mtx[0][1] * cornerX) + (mtx[2][1] * cornerZ)) * SHADOW_BATCH_PRECISION);
+        v[i].v.ob[2] = ((mtx[3][2] + (mtx[0][2] * cornerX) + (mtx[2][2] * cornerZ)) * SHADOW_BATCH_PRECISION);
+        v[i].v.flag = 0;
+        v[i].v.tc[0] = (cornerX * SHADOW_TEX_COORD);
+        v[i].v.tc[1] = (cornerZ * SHADOW_TEX_COORD);
+        v[i].v.cn[0] = 0xFF;
+        v[i].v.cn[1] = 0xFF;
+        v[i].v.cn[2] = 0xFF;
+        v[i].v.cn[3] = s->solidity;
+    }
+
+    // Start a new group, or widen the current group's vertex load to include this shadow.
+    index = (batch->count % SHADOW_BATCH_GROUP);
+    if (index == 0) {
+        batch->vertexLoad = batch->head++;
+    }
+    gSPVertex(batch->vertexLoad, &batch->verts[(batch->count - index) * 4], ((index + 1) * 4), 0);
+
+    index *= 4;
+    gSP2Triangles(batch->head++, (index + 0), (index + 2), (index + 1), 0x0,
+                                 (index + 1), (index + 2), (index + 3), 0x0);
+    gSPBranchList(batch->head, dl_shadow_batch_end);
+
+    batch->count++;
+    return TRUE;
+}
+#endif
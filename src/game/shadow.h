@@ -101,5 +101,15 @@ extern struct Shadow gCurrShadow;
  * with the given initial solidity and "shadowType" (described above).
  */
 Gfx *create_shadow_below_xyz(Vec3f pos, s16 shadowScale, u8 shadowSolidity, s8 shadowType, s8 shifted);
+s32 find_shadow_below_xyz(Vec3f pos, s16 shadowScale, u8 shadowSolidity, s8 shadowType, s8 shifted);
+Gfx *create_shadow_display_list(s8 shadowType);
+
+#ifdef BATCH_CIRCLE_SHADOWS
+void reset_shadow_batches(void);
+Gfx *get_shadow_batch(s32 isDecal);
+Gfx *start_shadow_batch(s32 isDecal, Vec3f origin);
+void get_shadow_batch_matrix(Mat4 mtx, s32 isDecal);
+s32 add_shadow_to_batch(Vec3f pos, s16 yaw);
+#endif
 
 #endif // SHADOW_H
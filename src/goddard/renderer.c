@@ -1165,6 +1165,7 @@ void gdm_init(void *blockpool, u32 size) {
     sMemBlockPoolUsed = 0;
     sAllocMemory = 0;
     init_mem_block_lists();
+    reset_synced_vn_groups();
     gd_reset_sfx();
     imout();
 }
@@ -22,6 +22,10 @@ struct ObjNet *gGdSkinNet; // @ 801BAAF0
 static s32 D_801BAAF4;
 static s32 sNetCount; // @ 801BAAF8
 
+// Vertex groups whose linked `Vtx`s all hold the same position and normal (see convert_gd_verts_to_Vn)
+static struct ObjGroup *sSyncedVnGroups[16];
+static s32 sNumSyncedVnGroups = 0;
+
 /* 2406E0 -> 240894 */
 void compute_net_bounding_box(struct ObjNet *net) {
     reset_bounding_box();
@@ -297,47 +301,67 @@ void func_80192CCC(struct ObjNet *net) {
     }
 }
 
+/**
+ * Returns whether convert_gd_verts_to_Vn() has already written every `Vtx` of `grp` once,
+ * and remembers that it has from now on.
+ */
+static s32 vn_group_synced(struct ObjGroup *grp) {
+    s32 i;
+
+    for (i = 0; i < sNumSyncedVnGroups; i++) {
+        if (sSyncedVnGroups[i] == grp) {
+            return TRUE;
+        }
+    }
+
+    // If the table is full, the group is just written in full every frame
+    if (sNumSyncedVnGroups < ARRAY_COUNT(sSyncedVnGroups)) {
+        sSyncedVnGroups[sNumSyncedVnGroups++] = grp;
+    }
+    return FALSE;
+}
+
+/**
+ * Copies the positions and normals of the `ObjVertex`es in `grp` into the `Vtx`s
+ * they were drawn with, which the shape's display list keeps using from frame to frame.
+ * A vertex whose converted values already match the `Vtx` it was first drawn with
+ * hasn't moved, so it and the rest of its linked `Vtx`s are skipped. That only holds
+ * once every linked `Vtx` has been written, as faces can be drawn with their own normal.
+ */
 /* 241768 -> 241AB4; orig name: func_80192F98 */
 void convert_gd_verts_to_Vn(struct ObjGroup *grp) {
-    UNUSED u8 filler1[20];
-    Vtx *vn;       // 28
-    u8 nx, ny, nz; // 24, 25, 26
-    UNUSED u8 filler2[4];
-    register struct VtxLink *vtxlink; // a1
-#ifndef GBI_FLOATS
-    register s16 *vnPos;              // a2
-#endif
-    register s16 x;                   // a3
-    register s16 y;                   // t0
-    register s16 z;                   // t1
-    register struct ObjVertex *vtx;   // t2
-    register struct ListNode *link;      // t3
-    struct GdObj *obj;                // sp4
+    register struct VtxLink *vtxlink;
+    register struct ObjVertex *vtx;
+    register struct ListNode *link;
+    register Vtx *vn;
+    s16 x, y, z;
+    s8 nx, ny, nz; // the same type as Vtx_tn.n, so the synced check compares the stored values
+    s32 synced = vn_group_synced(grp);
 
     for (link = grp->firstMember; link != NULL; link = link->next) {
-        obj = link->obj;
-        vtx = (struct ObjVertex *) obj;
+        vtx = (struct ObjVertex *) link->obj;
+        if ((vtxlink = vtx->gbiVerts) == NULL) {
+            continue;
+        }
+
         x = (s16) vtx->pos.x;
         y = (s16) vtx->pos.y;
         z = (s16) vtx->pos.z;
-
         nx = (u8)(vtx->normal.x * 255.0f);
         ny = (u8)(vtx->normal.y * 255.0f);
         nz = (u8)(vtx->normal.z * 255.0f);
 
-        for (vtxlink = vtx->gbiVerts; vtxlink != NULL; vtxlink = vtxlink->prev) {
-#ifndef GBI_FLOATS
-            vnPos = vtxlink->data->n.ob;
-            vn = vtxlink->data;
-            *vnPos++ = x;
-            *vnPos++ = y;
-            *vnPos++ = z;
-#else
+        vn = vtxlink->data;
+        if (synced && vn->n.ob[0] == x && vn->n.ob[1] == y && vn->n.ob[2] == z
+            && vn->n.n[0] == nx && vn->n.n[1] == ny && vn->n.n[2] == nz) {
+            continue;
+        }
+
+        for (; vtxlink != NULL; vtxlink = vtxlink->prev) {
             vn = vtxlink->data;
             vn->n.ob[0] = x;
             vn->n.ob[1] = y;
             vn->n.ob[2] = z;
-#endif
             vn->n.n[0] = nx;
             vn->n.n[1] = ny;
             vn->n.n[2] = nz;
@@ -345,38 +369,38 @@ void convert_gd_verts_to_Vn(struct ObjGroup *grp) {
     }
 }
 
+/**
+ * Same as convert_gd_verts_to_Vn(), for positions only. Every `Vtx` linked to a vertex
+ * was drawn at the same position, so they are always in sync.
+ */
 /* 241AB4 -> 241BCC; orig name: func_801932E4 */
 void convert_gd_verts_to_Vtx(struct ObjGroup *grp) {
-    UNUSED u8 filler[24];
-    register struct VtxLink *vtxlink; // a1
-#ifndef GBI_FLOATS
-    register s16 *vtxcoords;          // a2
-#endif
-    register s16 x;                   // a3
-    register s16 y;                   // t0
-    register s16 z;                   // t1
-    register struct ObjVertex *vtx;   // t2
-    register struct ListNode *link;      // t3
-    struct GdObj *obj;                // sp4
+    register struct VtxLink *vtxlink;
+    register struct ObjVertex *vtx;
+    register struct ListNode *link;
+    register Vtx *v;
+    s16 x, y, z;
 
     for (link = grp->firstMember; link != NULL; link = link->next) {
-        obj = link->obj;
-        vtx = (struct ObjVertex *) obj;
+        vtx = (struct ObjVertex *) link->obj;
+        if ((vtxlink = vtx->gbiVerts) == NULL) {
+            continue;
+        }
+
         x = (s16) vtx->pos.x;
         y = (s16) vtx->pos.y;
         z = (s16) vtx->pos.z;
 
-        for (vtxlink = vtx->gbiVerts; vtxlink != NULL; vtxlink = vtxlink->prev) {
-#ifndef GBI_FLOATS
-            vtxcoords = vtxlink->data->v.ob;
-            vtxcoords[0] = x;
-            vtxcoords[1] = y;
-            vtxcoords[2] = z;
-#else
-            vtxlink->data->v.ob[0] = x;
-            vtxlink->data->v.ob[1] = y;
-            vtxlink->data->v.ob[2] = z;
-#endif
+        v = vtxlink->data;
+        if (v->v.ob[0] == x && v->v.ob[1] == y && v->v.ob[2] == z) {
+            continue;
+        }
+
+        for (; vtxlink != NULL; vtxlink = vtxlink->prev) {
+            v = vtxlink->data;
+            v->v.ob[0] = x;
+            v->v.ob[1] = y;
+            v->v.ob[2] = z;
         }
     }
 }
@@ -525,3 +549,11 @@ void gd_print_net(struct ObjNet *net) {
 void reset_net_count(void) {
     sNetCount = 0;
 }
+
+/**
+ * Forgets which vertex groups have been synced, since the groups of a new
+ * head are made in the same memory as the old ones.
+ */
+void reset_synced_vn_groups(void) {
+    sNumSyncedVnGroups = 0;
+}
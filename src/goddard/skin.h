@@ -16,5 +16,6 @@ void convert_net_verts(struct ObjNet *net);
 void move_nets(struct ObjGroup *group);
 void func_80193848(struct ObjGroup *group);
 void reset_net_count(void);
+void reset_synced_vn_groups(void);
 
 #endif // GD_SKIN_H
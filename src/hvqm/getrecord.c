@@ -10,6 +10,7 @@
 /* 1999-02-22 */
 
 #include <ultra64.h>
+#include <macros.h>
 #include <HVQM2File.h>
 #include "hvqm.h"
 
@@ -74,4 +75,194 @@ get_record( HVQM2Record *headerbuf, void *bodybuf, u16 type, u8 *stream, OSIoMes
   return stream;
 }
 
+/*
+ * What the DMA in flight of a record ring is reading
+ */
+#define RECORD_DMA_IDLE    0
+#define RECORD_DMA_HEADER  1
+#define RECORD_DMA_BODY    2
+
+static void
+start_record_dma( HVQMRecordRing *ring, void *dest, u8 *src, u32 len )
+{
+  osInvalDCache( dest, (s32)len );
+  while ( osPiStartDma( &ring->mb, ring->pri, OS_READ, (u32)src, dest, len, ring->mq ) == -1 ) {}
+}
+
+static void
+start_next_record( HVQMRecordRing *ring )
+{
+  if ( ring->dma_state != RECORD_DMA_IDLE || ring->count == HVQM_RECORDS_AHEAD || ring->remain == 0 ) return;
+
+  ring->dma_start = osGetTime();
+  ring->dma_state = RECORD_DMA_HEADER;
+  start_record_dma( ring, ring->slots[(ring->read + ring->count) % HVQM_RECORDS_AHEAD].header, 
+		    ring->stream, sizeof(HVQM2Record) );
+  ring->stream += sizeof(HVQM2Record);
+}
+
+/*
+ * void hvqm_record_ring_init(HVQMRecordRing *ring, u16 type, u8 *bodybuf, 
+ *                            u32 body_size, OSMesgQueue *mq)
+ *
+ * Arguments
+ *     ring      The record ring
+ *     type      The record type to read, HVQM2_AUDIO or HVQM2_VIDEO
+ *     bodybuf   Buffer of HVQM_RECORDS_AHEAD record bodies
+ *     body_size Size of each record body in bodybuf
+ *     mq        Message queue receiving notice of DMA end from PI manager
+ *
+ * Explanation:
+ *   Sets up a ring that reads the records of "type" ahead of the decoder.
+ * While the decoder works on one record, the next ones are read into the
+ * ring by asynchronous DMA, so PI contention only stalls the decoder once 
+ * the ring has run dry.
+ *
+ *   The ring does not read anything until hvqm_record_ring_rewind().
+ * Every message that arrives on "mq" for the ring must be passed to 
+ * hvqm_record_ring_dma_done(), and "mq" must have room for one message.
+ * A ring must only be used by one thread.
+ *
+ *   "bodybuf" and "body_size" must have 16byte alignment.
+ */
+void
+hvqm_record_ring_init( HVQMRecordRing *ring, u16 type, u8 *bodybuf, u32 body_size, OSMesgQueue *mq )
+{
+  int i;
+
+  for ( i = 0; i < HVQM_RECORDS_AHEAD; i++ ) {
+    ring->slots[i].body = bodybuf + (i * body_size);
+  }
+  ring->type = type;
+  ring->pri = (type == HVQM2_AUDIO) ? OS_MESG_PRI_HIGH : OS_MESG_PRI_NORMAL;
+  ring->mq = mq;
+  ring->stream = NULL;
+  ring->remain = 0;
+  ring->dma_state = RECORD_DMA_IDLE;
+  ring->read = 0;
+  ring->count = 0;
+  ring->dma_usec = 0;
+  ring->dma_usec_max = 0;
+  ring->stall_usec = 0;
+}
+
+/*
+ * void hvqm_record_ring_rewind(HVQMRecordRing *ring, u8 *stream, u32 records)
+ *
+ * Explanation:
+ *   Drops every record read so far and starts reading the "records" 
+ * records of the ring's type from the HVQM2 data address "stream".
+ */
+void
+hvqm_record_ring_rewind( HVQMRecordRing *ring, u8 *stream, u32 records )
+{
+  if ( ring->dma_state != RECORD_DMA_IDLE ) {
+    osRecvMesg( ring->mq, (OSMesg *)NULL, OS_MESG_BLOCK );
+    ring->dma_state = RECORD_DMA_IDLE;
+  }
+
+  ring->stream = stream;
+  ring->remain = records;
+  ring->read = 0;
+  ring->count = 0;
+  start_next_record( ring );
+}
+
+/*
+ * void hvqm_record_ring_dma_done(HVQMRecordRing *ring)
+ *
+ * Explanation:
+ *   Handles the end of the ring's DMA in flight, and starts the next one.
+ * Records of other types are skipped over, just like get_record().
+ */
+void
+hvqm_record_ring_dma_done( HVQMRecordRing *ring )
+{
+  HVQMRecordSlot *slot = &ring->slots[(ring->read + ring->count) % HVQM_RECORDS_AHEAD];
+  HVQM2Record *header = (HVQM2Record *)slot->header;
+  u32 record_size;
+
+  if ( ring->dma_state == RECORD_DMA_HEADER ) {
+    record_size = load32( header->size );
+    if ( load16( header->type ) != ring->type ) {
+      ring->stream += record_size;
+      start_record_dma( ring, slot->header, ring->stream, sizeof(HVQM2Record) );
+      ring->stream += sizeof(HVQM2Record);
+      return;
+    }
+    if ( record_size > 0 ) {
+      ring->dma_state = RECORD_DMA_BODY;
+      start_record_dma( ring, slot->body, ring->stream, record_size );
+      ring->stream += record_size;
+      return;
+    }
+  }
+
+  ring->dma_usec = OS_CYCLES_TO_USEC( osGetTime() - ring->dma_start );
+  if ( ring->dma_usec > ring->dma_usec_max ) ring->dma_usec_max = ring->dma_usec;
+
+  ring->dma_state = RECORD_DMA_IDLE;
+  ++ring->count;
+  --ring->remain;
+  start_next_record( ring );
+}
+
+/*
+ * void hvqm_record_ring_poll(HVQMRecordRing *ring)
+ *
+ * Explanation:
+ *   Handles any DMA ends that have arrived without waiting. Only call it 
+ * while the ring's "mq" receives nothing else.
+ */
+void
+hvqm_record_ring_poll( HVQMRecordRing *ring )
+{
+  while ( ring->dma_state != RECORD_DMA_IDLE 
+	  && osRecvMesg( ring->mq, (OSMesg *)NULL, OS_MESG_NOBLOCK ) == 0 ) {
+    hvqm_record_ring_dma_done( ring );
+  }
+}
+
+/*
+ * HVQMRecordSlot *hvqm_record_ring_get(HVQMRecordRing *ring)
+ *
+ * Explanation:
+ *   Returns the oldest record read, waiting for it if the ring has run 
+ * dry. The record stays valid until hvqm_record_ring_release().
+ *
+ * Returned value:
+ *     The record, or NULL if every record has been read
+ */
+HVQMRecordSlot *
+hvqm_record_ring_get( HVQMRecordRing *ring )
+{
+  OSTime stall_start;
+
+  if ( ring->count == 0 ) {
+    stall_start = osGetTime();
+    while ( ring->count == 0 && ring->dma_state != RECORD_DMA_IDLE ) {
+      osRecvMesg( ring->mq, (OSMesg *)NULL, OS_MESG_BLOCK );
+      hvqm_record_ring_dma_done( ring );
+    }
+    ring->stall_usec += OS_CYCLES_TO_USEC( osGetTime() - stall_start );
+    if ( ring->count == 0 ) return NULL;
+  }
+
+  return &ring->slots[ring->read];
+}
+
+/*
+ * void hvqm_record_ring_release(HVQMRecordRing *ring)
+ *
+ * Explanation:
+ *   Frees the record returned by hvqm_record_ring_get() to read ahead into.
+ */
+void
+hvqm_record_ring_release( HVQMRecordRing *ring )
+{
+  if ( ++ring->read == HVQM_RECORDS_AHEAD ) ring->read = 0;
+  --ring->count;
+  start_next_record( ring );
+}
+
 /* end */
@@ -7,7 +7,6 @@
 #include "hvqm.h"
 
 #define AUDIO_DMA_MSG_SIZE 1
-static OSIoMesg     audioDmaMesgBlock;
 static OSMesgQueue  audioDmaMessageQ;
 static OSMesg       audioDmaMessages[AUDIO_DMA_MSG_SIZE];
 
@@ -22,10 +21,21 @@ static OSMesgQueue  videoDmaMessageQ;
 static OSMesg       videoDmaMessages[VIDEO_DMA_MSG_SIZE];
 
 /***********************************************************************
- * SP event (SP task end) message queue
+ * SP event (SP task end) message queue, which also receives the end 
+ * of DMA notifications of the video record ring so that records are 
+ * read ahead while the RSP decodes.
  ***********************************************************************/
+#define  SP_MSG_SIZE  2
+#define  SP_DONE_MSG  ((OSMesg)1)
 static OSMesgQueue  spMesgQ;
-static OSMesg       spMesgBuf;
+static OSMesg       spMesgBuf[SP_MSG_SIZE];
+
+/***********************************************************************
+ * Rings of video and audio records read ahead of the decoders
+ ***********************************************************************/
+HVQMRecordRing hvqm_video_ring;
+HVQMRecordRing hvqm_audio_ring;
+HVQMStats hvqm_stats;
 
 /***********************************************************************
  * RSP task data and parameter for the HVQM2 microcode
@@ -42,9 +52,6 @@ u8 hvqm_headerBuf[sizeof(HVQM2Header) + 16];
  ***********************************************************************/
 static u32 total_frames;	/* Total number of video records (frames) */
 static u32 total_audio_records;	/* Total number of audio records */
-static void *video_streamP;	/* Video record read-in pointer */
-static void *audio_streamP;	/* Audio record read-in pointer */
-static u32 audio_remain;	/* Counter for remaining number of audio records to read */
 static u32 video_remain;	/* Counter for remaining number of video records to read */
 static u64 disptime;		/* Counter for scheduled display time of next video frame */
 static ADPCMstate adpcm_state;	/* Buffer for state information passed to the ADPCM decoder */
@@ -59,32 +66,60 @@ extern u8 _capcomSegmentRomStart[];
 extern u8 _seinSegmentRomStart[];
 
 static u32 next_audio_record( void *pcmbuf ) {
-  ALIGNED16 u8 header_buffer[sizeof(HVQM2Record)+16];
+  HVQMRecordSlot *record;
   HVQM2Record *record_header;
   HVQM2Audio *audio_headerP;
   u32 samples;
 
-  if ( audio_remain == 0 ) return 0;
+  hvqm_record_ring_poll( &hvqm_audio_ring );
+  record = hvqm_record_ring_get( &hvqm_audio_ring );
+  if ( record == NULL ) return 0;
 
-  record_header = OS_DCACHE_ROUNDUP_ADDR(header_buffer);
-  audio_streamP = get_record(record_header, adpcmbuf, HVQM2_AUDIO, audio_streamP, &audioDmaMesgBlock, &audioDmaMessageQ);
-  --audio_remain;
-
-  audio_headerP = (HVQM2Audio *)adpcmbuf;
+  record_header = (HVQM2Record *)record->header;
+  audio_headerP = (HVQM2Audio *)record->body;
   samples = load32(audio_headerP->samples);
   adpcmDecode(&audio_headerP[1], (u32)load16(record_header->format), samples, pcmbuf, 1, &adpcm_state);
+  hvqm_record_ring_release( &hvqm_audio_ring );
 
   return samples;
 }
 
+/*
+ * Called by the timekeeper thread while the HVQM thread waits in tkStart(), 
+ * so it can safely rewind the video ring as well.
+ */
 static tkAudioProc rewind( void ) {
-  video_streamP = audio_streamP = (u32)_capcomSegmentRomStart + sizeof(HVQM2Header);
-  audio_remain = total_audio_records;
+  u8 *stream = (u8 *)_capcomSegmentRomStart + sizeof(HVQM2Header);
+
+  hvqm_record_ring_rewind( &hvqm_audio_ring, stream, total_audio_records );
+  hvqm_record_ring_rewind( &hvqm_video_ring, stream, total_frames );
   video_remain = total_frames;
   disptime = 0;
   return &next_audio_record;
 }
 
+/*
+ * Waits for the HVQM2 task to end, reading video records ahead meanwhile.
+ */
+static void wait_sp_task( void ) {
+  OSMesg msg;
+
+  for ( ; ; ) {
+    osRecvMesg( &spMesgQ, &msg, OS_MESG_BLOCK );
+    if ( msg == SP_DONE_MSG ) break;
+    hvqm_record_ring_dma_done( &hvqm_video_ring );
+  }
+}
+
+/*
+ * Handles the video ring's DMA ends that have arrived, without waiting, 
+ * so it keeps reading ahead while the CPU decodes. Only called while no 
+ * HVQM2 task runs, when spMesgQ receives nothing but the ring's messages.
+ */
+static void poll_video_ring( void ) {
+  hvqm_record_ring_poll( &hvqm_video_ring );
+}
+
 HVQM2Header *hvqm_header;
 
 static OSMesgQueue   hvqmMesgQ;
@@ -102,11 +137,14 @@ void hvqm_main_proc() {
     
     hvqm_header = OS_DCACHE_ROUNDUP_ADDR( hvqm_headerBuf );
     
-    osCreateMesgQueue( &spMesgQ, &spMesgBuf, 1 );
-    osSetEventMesg( OS_EVENT_SP, &spMesgQ, NULL );
+    osCreateMesgQueue( &spMesgQ, spMesgBuf, SP_MSG_SIZE );
+    osSetEventMesg( OS_EVENT_SP, &spMesgQ, SP_DONE_MSG );
     
     osCreateMesgQueue( &audioDmaMessageQ, audioDmaMessages, AUDIO_DMA_MSG_SIZE );
     osCreateMesgQueue( &videoDmaMessageQ, videoDmaMessages, VIDEO_DMA_MSG_SIZE );
+    hvqm_record_ring_init( &hvqm_audio_ring, HVQM2_AUDIO, adpcmbuf, AUDIO_RECORD_BUF_SIZE, &audioDmaMessageQ );
+    hvqm_record_ring_init( &hvqm_video_ring, HVQM2_VIDEO, hvqbuf, HVQ_RECORD_BUF_SIZE, &spMesgQ );
+    bzero( &hvqm_stats, sizeof(hvqm_stats) );
     createTimekeeper();
     
     hvqm2InitSP1(0xff);
@@ -139,11 +177,12 @@ void hvqm_main_proc() {
     for ( ; ; ) {
 
         //while ( video_remain > 0 ) {
-            u8 header_buffer[sizeof(HVQM2Record)+16];
+            HVQMRecordSlot *record;
             HVQM2Record *record_header;
             u16 frame_format;
             int bufno;
-            OSMesg msg;
+
+            poll_video_ring();
 
             if ( disptime > 0 && tkGetTime() > 0) {
                 if ( tkGetTime() < (disptime - (usec_per_frame * 2)) ) {
@@ -153,11 +192,9 @@ void hvqm_main_proc() {
                 }
             }
             
-            record_header = OS_DCACHE_ROUNDUP_ADDR( header_buffer );
-            
-            video_streamP = get_record(record_header, hvqbuf, 
-                        HVQM2_VIDEO, video_streamP, 
-                        &videoDmaMesgBlock, &videoDmaMessageQ);
+            record = hvqm_record_ring_get( &hvqm_video_ring );
+            if ( record == NULL ) break;
+            record_header = (HVQM2Record *)record->header;
                         
             //! SYNC VIDEO code
 
@@ -166,12 +203,14 @@ void hvqm_main_proc() {
                   release_all_cfb();
                   do {
                     disptime += usec_per_frame;
+                    ++hvqm_stats.frames_dropped;
+                    hvqm_record_ring_release( &hvqm_video_ring );
                     if ( --video_remain == 0 ) break;
-                    video_streamP = get_record( record_header, hvqbuf, 
-				    HVQM2_VIDEO, video_streamP, 
-				    &videoDmaMesgBlock, &videoDmaMessageQ );
+                    record = hvqm_record_ring_get( &hvqm_video_ring );
+                    if ( record == NULL ) break;
+                    record_header = (HVQM2Record *)record->header;
                   } while (load16( record_header->format ) != HVQM2_VIDEO_KEYFRAME || tkGetTime() > disptime );
-                  if ( video_remain == 0 ) break;
+                  if ( video_remain == 0 || record == NULL ) break;
                 }
             }
             
@@ -188,16 +227,19 @@ void hvqm_main_proc() {
                 bufno = prev_bufno;
             } else {
                 int status;
+                OSTime decode_start;
                 bufno = get_cfb(); /* Get the frame buffer */
+                decode_start = osGetTime();
 
                 /*
                  * Process first half in the CPU
                  */
                 hvqtask.t.flags = 0;
-                status = hvqm2DecodeSP1( hvqbuf, frame_format, 
+                status = hvqm2DecodeSP1( record->body, frame_format, 
                            &gFramebuffers[bufno][screen_offset], 
                            &gFramebuffers[prev_bufno][screen_offset], 
                            hvqwork, &hvq_sparg, hvq_spfifo );
+                poll_video_ring();
 
                 osWritebackDCacheAll();
 
@@ -207,9 +249,16 @@ void hvqm_main_proc() {
                 if ( status > 0 ) {
                     osInvalDCache( (void *)gFramebuffers[bufno], sizeof gFramebuffers[bufno] );
                     osSpTaskStart( &hvqtask );
-                    osRecvMesg( &spMesgQ, NULL, OS_MESG_BLOCK );
+                    wait_sp_task();
+                }
+
+                hvqm_stats.decode_usec = OS_CYCLES_TO_USEC( osGetTime() - decode_start );
+                if ( hvqm_stats.decode_usec > hvqm_stats.decode_usec_max ) {
+                    hvqm_stats.decode_usec_max = hvqm_stats.decode_usec;
                 }
             }
+            hvqm_record_ring_release( &hvqm_video_ring );
+            ++hvqm_stats.frames_decoded;
         
         keep_cfb( bufno );
         
@@ -1,6 +1,7 @@
 #ifndef HVQM_H
 #define HVQM_H
 
+#include <macros.h>
 
 /*
  * Size of the data area for the HVQ microcode
@@ -17,6 +18,14 @@
  */
 #define AUDIO_RECORD_SIZE_MAX  5000
 
+/*
+ * Number of records of each type read ahead of the decoder, and the
+ * size of each record's buffer rounded up to whole data cache lines
+ */
+#define HVQM_RECORDS_AHEAD     4
+#define HVQ_RECORD_BUF_SIZE    OS_DCACHE_ROUNDUP_SIZE(HVQ_DATASIZE_MAX)
+#define AUDIO_RECORD_BUF_SIZE  OS_DCACHE_ROUNDUP_SIZE(AUDIO_RECORD_SIZE_MAX)
+
 #define MAXWIDTH  320
 #define MAXHEIGHT 240
 
@@ -100,6 +109,52 @@ void romcpy(void *dest, void *src, u32 len, s32 pri, OSIoMesg *mb, OSMesgQueue *
  */
 u8 *get_record(HVQM2Record *headerbuf, void *bodybuf, u16 type, u8 *stream, OSIoMesg *mb, OSMesgQueue *mq);
 
+/*
+ * Ring of records read ahead by asynchronous PI DMA (in getrecord.c)
+ */
+typedef struct {
+  ALIGNED16 u8 header[OS_DCACHE_ROUNDUP_SIZE(sizeof(HVQM2Record))]; /* Record header (HVQM2Record) */
+  u8 *body;			/* Record body */
+} HVQMRecordSlot;
+
+typedef struct {
+  HVQMRecordSlot slots[HVQM_RECORDS_AHEAD];
+  u16 type;			/* Record type read into this ring */
+  s32 pri;			/* Priority of the DMA requests */
+  u8 *stream;			/* Address of the next record header to read */
+  u32 remain;			/* Records of this type not yet read */
+  s32 dma_state;		/* What the DMA in flight is reading, if any */
+  s32 read;			/* Slot of the oldest record read */
+  s32 count;			/* Number of records read and not yet released */
+  OSTime dma_start;		/* When reading the record in flight started */
+  u32 dma_usec;			/* Time taken to read the last record [usec] */
+  u32 dma_usec_max;		/* Longest time taken to read a record [usec] */
+  u32 stall_usec;		/* Total time spent waiting for records [usec] */
+  OSIoMesg mb;			/* I/O message block request sent to PI manager */
+  OSMesgQueue *mq;		/* Message queue receiving notice of DMA end */
+} HVQMRecordRing;
+
+void hvqm_record_ring_init(HVQMRecordRing *ring, u16 type, u8 *bodybuf, u32 body_size, OSMesgQueue *mq);
+void hvqm_record_ring_rewind(HVQMRecordRing *ring, u8 *stream, u32 records);
+void hvqm_record_ring_dma_done(HVQMRecordRing *ring);
+void hvqm_record_ring_poll(HVQMRecordRing *ring);
+HVQMRecordSlot *hvqm_record_ring_get(HVQMRecordRing *ring);
+void hvqm_record_ring_release(HVQMRecordRing *ring);
+
+/*
+ * Playback statistics (in hvqm.c)
+ */
+typedef struct {
+  u32 frames_decoded;		/* Video records decoded */
+  u32 frames_dropped;		/* Video records skipped to catch up with the audio */
+  u32 decode_usec;		/* Time taken to decode the last frame in the CPU and RSP [usec] */
+  u32 decode_usec_max;		/* Longest time taken to decode a frame [usec] */
+} HVQMStats;
+
+extern HVQMStats hvqm_stats;
+extern HVQMRecordRing hvqm_video_ring;
+extern HVQMRecordRing hvqm_audio_ring;
+
 /*
  * in cfbkeep.c
  */
@@ -14,6 +14,7 @@
 #include "game/object_helpers.h"
 #include "game/object_list_processor.h"
 #include "game/print.h"
+#include "game/rendering_graph_node.h"
 #include "game/save_file.h"
 #include "game/segment2.h"
 #include "game/segment7.h"
@@ -2002,10 +2003,31 @@ void print_file_select_strings(void) {
  * Geo function that prints file select strings and the cursor.
  */
 Gfx *geo_file_select_strings_and_menu_cursor(s32 callContext, UNUSED struct GraphNode *node, UNUSED Mat4 mtx) {
+#ifdef UNLOCK_FPS_INTERPOLATION
+    static struct GeoStepCache sMenuStep;
+    Gfx *skip;
+
+    if (callContext == GEO_CONTEXT_RENDER) {
+        // The menu timers and cursor input advance once per game step, so the strings and cursor
+        // are drawn into their own display list, which the frames between steps draw again.
+        if (GEO_STEP_CACHED(&sMenuStep)) {
+            gSPDisplayList(gDisplayListHead++, VIRTUAL_TO_PHYSICAL(sMenuStep.gfx));
+            return NULL;
+        }
+        skip = gDisplayListHead++;
+        GEO_STEP_CACHE_SAVE(&sMenuStep, gDisplayListHead);
+        print_file_select_strings();
+        print_menu_cursor();
+        gSPEndDisplayList(gDisplayListHead++);
+        gSPBranchList(skip, VIRTUAL_TO_PHYSICAL(gDisplayListHead));
+        gSPDisplayList(gDisplayListHead++, VIRTUAL_TO_PHYSICAL(sMenuStep.gfx));
+    }
+#else
     if (callContext == GEO_CONTEXT_RENDER) {
         print_file_select_strings();
         print_menu_cursor();
     }
+#endif
     return NULL;
 }
 
@@ -11,6 +11,7 @@
 #include "types.h"
 #include "buffers/framebuffers.h"
 #include "game/game_init.h"
+#include "game/rendering_graph_node.h"
 #include "audio/external.h"
 
 // frame counts for the zoom in, hold, and zoom out of title model
@@ -36,6 +37,11 @@ static s32 sGameOverTableIndex;
 static s16 sIntroFrameCounter;
 static s32 sTmCopyrightAlpha;
 
+// The intro callbacks count game steps, so the frames between steps draw the step's display list again.
+static struct GeoStepCache sLogoStep;
+static struct GeoStepCache sTmCopyrightStep;
+static struct GeoStepCache sGameOverStep;
+
 /**
  * Geo callback to render the "Super Mario 64" logo on the title screen
  */
@@ -46,6 +52,8 @@ Gfx *geo_intro_super_mario_64_logo(s32 callContext, struct GraphNode *node, UNUS
 
     if (callContext != GEO_CONTEXT_RENDER) {
         sIntroFrameCounter = 0;
+    } else if (GEO_STEP_CACHED(&sLogoStep)) {
+        dl = sLogoStep.gfx;
     } else if (callContext == GEO_CONTEXT_RENDER) {
         f32 *scaleTable1 = segmented_to_virtual(intro_seg7_table_scale_1);
         f32 *scaleTable2 = segmented_to_virtual(intro_seg7_table_scale_2);
@@ -77,6 +85,7 @@ Gfx *geo_intro_super_mario_64_logo(s32 callContext, struct GraphNode *node, UNUS
         gSPEndDisplayList(dlIter);
 
         sIntroFrameCounter++;
+        GEO_STEP_CACHE_SAVE(&sLogoStep, dl);
     }
     return dl;
 }
@@ -91,6 +100,8 @@ Gfx *geo_intro_tm_copyright(s32 callContext, struct GraphNode *node, UNUSED void
 
     if (callContext != GEO_CONTEXT_RENDER) { // reset
         sTmCopyrightAlpha = 0;
+    } else if (GEO_STEP_CACHED(&sTmCopyrightStep)) {
+        dl = sTmCopyrightStep.gfx;
     } else if (callContext == GEO_CONTEXT_RENDER) { // draw
         dl = alloc_display_list(5 * sizeof(*dl));
         dlIter = dl;
@@ -113,6 +124,7 @@ Gfx *geo_intro_tm_copyright(s32 callContext, struct GraphNode *node, UNUSED void
                 sTmCopyrightAlpha = 255;
             }
         }
+        GEO_STEP_CACHE_SAVE(&sTmCopyrightStep, dl);
     }
     return dl;
 }
@@ -231,6 +243,8 @@ Gfx *geo_intro_gameover_backdrop(s32 callContext, struct GraphNode *node, UNUSED
         for (i = 0; i < ARRAY_COUNT(gameOverBackgroundTable); ++i) {
             gameOverBackgroundTable[i] = INTRO_BACKGROUND_GAME_OVER;
         }
+    } else if (GEO_STEP_CACHED(&sGameOverStep)) {
+        dl = sGameOverStep.gfx;
     } else { // draw
         dl = alloc_display_list(16 * sizeof(*dl));
         dlIter = dl;
@@ -259,6 +273,7 @@ Gfx *geo_intro_gameover_backdrop(s32 callContext, struct GraphNode *node, UNUSED
         }
         gSPDisplayList(dlIter++, &title_screen_bg_dl_end);
         gSPEndDisplayList(dlIter);
+        GEO_STEP_CACHE_SAVE(&sGameOverStep, dl);
     }
     return dl;
 }
@@ -289,6 +304,7 @@ s8 sFaceToggleOrder[] = {
 };
 
 s8 sFaceCounter = 0;
+static struct GeoStepCache sFaceStep;
 
 void intro_gen_face_texrect(Gfx **dlIter) {
     s32 x;
@@ -377,6 +393,8 @@ Gfx *geo_intro_face_easter_egg(s32 callContext, struct GraphNode *node, UNUSED v
             sFaceVisible[i] = 0;
         }
 
+    } else if (GEO_STEP_CACHED(&sFaceStep)) {
+        dl = sFaceStep.gfx;
     } else if (callContext == GEO_CONTEXT_RENDER) {
         if (sFaceCounter == 0) {
             if (gPlayer1Controller->buttonPressed & Z_TRIG) {
@@ -399,6 +417,7 @@ Gfx *geo_intro_face_easter_egg(s32 callContext, struct GraphNode *node, UNUSED v
                 dl = intro_draw_face(image, 40, 40);
             }
         }
+        GEO_STEP_CACHE_SAVE(&sFaceStep, dl);
     }
 
     return dl;
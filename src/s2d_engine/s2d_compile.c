@@ -0,0 +1,289 @@
+#include <ultra64.h>
+#include <PR/gs2dex.h>
+
+#include "config.h"
+
+#include "s2d_draw.h"
+#include "s2d_print.h"
+#include "s2d_ustdlib.h"
+#include "s2d_error.h"
+
+#define qu510(n) ((u16)((n)*0x0400))
+#define CLAMP_0(x) ((x < 0) ? 0 : x)
+
+extern void f3d_rdp_init(void);
+extern void setup_s2d_texture(int idx);
+extern void draw_f3d_dropshadow(char c, int x, int y, uObjMtx *ds);
+extern void draw_f3d_glyph(char c, int x, int y, uObjMtx *mt);
+
+// Same placement mtx_pipeline builds every frame for s2d_print
+static void s2d_set_sub_mtx(uObjSubMtx *m, int x, int y, float scale) {
+	m->m.X = x << 2;
+	m->m.Y = y << 2;
+	m->m.BaseScaleX = qu510(1.0f / scale);
+	m->m.BaseScaleY = qu510(1.0f / scale);
+}
+
+static void s2d_reset_layout_state(struct s2d_layout_state *state) {
+	state->red = state->green = state->blue = 255;
+	state->alpha = 255;
+	state->drop_shadow = FALSE;
+	state->drop_x = 0;
+	state->drop_y = 0;
+	state->scale = 1.0f;
+}
+
+// Remembers where a line starts, so a later recompile can resume from it.
+static void s2d_start_line(struct s2d_text *text, struct s2d_layout_state *state, int src_start) {
+	struct s2d_line *line;
+
+	if (text->num_lines >= S2D_TEXT_MAX_LINES) return;
+
+	line = &text->lines[text->num_lines++];
+	line->src_start = src_start;
+	line->first_glyph = text->num_glyphs;
+	line->state = *state;
+}
+
+// Aligns the glyphs of the line that was just laid out and builds their matrices.
+static void s2d_finish_line(struct s2d_text *text, struct s2d_layout_state *state, int first_glyph, int bank) {
+	int width = state->x - state->orig_x;
+	int shift = 0;
+	int i;
+
+	switch (text->align) {
+		case ALIGN_CENTER:
+			shift = width / 2;
+			break;
+		case ALIGN_RIGHT:
+			shift = width;
+	}
+
+	for (i = first_glyph; i < text->num_glyphs; i++) {
+		struct s2d_glyph *g = &text->glyphs[i];
+
+		g->x -= shift;
+		s2d_set_sub_mtx(&g->mtx[bank], g->x, g->y, g->scale);
+		s2d_set_sub_mtx(&g->mtx_shadow[bank], g->x + g->drop_x, g->y + g->drop_y, g->scale);
+	}
+}
+
+void s2d_text_compile(struct s2d_text *text, int x, int y, int align, const char *str) {
+	char *tbl = segmented_to_virtual(s2d_kerning_table);
+	struct s2d_layout_state state;
+	int bank = text->bank ^ 1;
+	int first_glyph;
+	int line = 0;
+	int i;
+	char *p;
+
+	if (s2d_check_align(align) != 0) return;
+	if (s2d_check_str(str)     != 0) return;
+
+	if (text->num_lines > 0 && x == text->x && y == text->y && align == text->align) {
+		for (i = 0; i < text->max_len && str[i] != '\0' && str[i] == text->src[i]; i++);
+		if (i == text->max_len || str[i] == text->src[i]) return;
+
+		// everything before the line holding the first change is laid out the same
+		while (line + 1 < text->num_lines && text->lines[line + 1].src_start <= i) line++;
+	} else {
+		text->x = x;
+		text->y = y;
+		text->align = align;
+		text->num_lines = 0;
+		text->num_glyphs = 0;
+
+		s2d_reset_layout_state(&state);
+		state.orig_x = state.x = x;
+		state.y = y;
+		s2d_start_line(text, &state, 0);
+	}
+
+	// the drawn bank may still be in use by the RDP, so the glyphs that are
+	// kept get their matrices copied into the other bank instead
+	state = text->lines[line].state;
+	text->num_glyphs = text->lines[line].first_glyph;
+	text->num_lines = line + 1;
+	for (i = 0; i < text->num_glyphs; i++) {
+		text->glyphs[i].mtx[bank] = text->glyphs[i].mtx[text->bank];
+		text->glyphs[i].mtx_shadow[bank] = text->glyphs[i].mtx_shadow[text->bank];
+	}
+
+	for (i = text->lines[line].src_start; i < text->max_len && str[i] != '\0'; i++) {
+		text->src[i] = str[i];
+	}
+	text->src[i] = '\0';
+
+	first_glyph = text->num_glyphs;
+	p = text->src + text->lines[line].src_start;
+
+	while (*p != '\0') {
+		char current_char = *p;
+
+		switch (current_char) {
+			case CH_SCALE:
+				CH_SKIP(p);
+				state.scale = (f32)s2d_atoi(p, &p) / 100.0f;
+				break;
+			case CH_ROT:
+				// not drawn by s2d_snprint either
+				CH_SKIP(p);
+				s2d_atoi(p, &p);
+				break;
+			case CH_TRANSLATE:
+				s2d_finish_line(text, &state, first_glyph, bank);
+				CH_SKIP(p);
+				state.orig_x = state.x = s2d_atoi(p, &p);
+				CH_SKIP(p);
+				CH_SKIP(p);
+				state.y = s2d_atoi(p, &p);
+				first_glyph = text->num_glyphs;
+				s2d_start_line(text, &state, (p + 1) - text->src);
+				break;
+			case CH_COLOR:
+				CH_SKIP(p);
+				state.red = s2d_atoi(p, &p);
+				CH_SKIP(p);	CH_SKIP(p);
+
+				state.green = s2d_atoi(p, &p);
+				CH_SKIP(p);	CH_SKIP(p);
+
+				state.blue = s2d_atoi(p, &p);
+				CH_SKIP(p);	CH_SKIP(p);
+
+				state.alpha = s2d_atoi(p, &p);
+				break;
+			case CH_DROPSHADOW:
+				state.drop_shadow = TRUE;
+				CH_SKIP(p);
+				state.drop_x = s2d_atoi(p, &p);
+				CH_SKIP(p);	CH_SKIP(p);
+				state.drop_y = s2d_atoi(p, &p);
+				break;
+			case CH_BUTTON:
+				if (p[1] != '\0') CH_SKIP(p);
+				break;
+			case '\n':
+				s2d_finish_line(text, &state, first_glyph, bank);
+				state.x = state.orig_x;
+				state.y += TEX_HEIGHT / TEX_RES;
+				first_glyph = text->num_glyphs;
+				s2d_start_line(text, &state, (p + 1) - text->src);
+				break;
+			case '\t':
+				state.x += TAB_WIDTH_H / TEX_RES;
+				break;
+			case '\v':
+				state.x += TAB_WIDTH_V / TEX_RES;
+				state.y += TEX_HEIGHT / TEX_RES;
+				break;
+			case CH_RESET:
+				s2d_reset_layout_state(&state);
+				break;
+			case CH_SEPARATOR:
+				break;
+			default:
+				if (text->num_glyphs < text->max_len) {
+					struct s2d_glyph *g = &text->glyphs[text->num_glyphs++];
+
+					g->c = current_char;
+					g->x = state.x;
+					g->y = state.y;
+					g->scale = state.scale;
+					g->red = state.red;
+					g->green = state.green;
+					g->blue = state.blue;
+					g->alpha = state.alpha;
+					g->drop_shadow = state.drop_shadow;
+					g->drop_x = state.drop_x;
+					g->drop_y = state.drop_y;
+				}
+
+				state.x += (tbl[(int) current_char] * (BASE_SCALE * state.scale));
+		}
+		if (*p == '\0') break;
+		p++;
+	}
+
+	s2d_finish_line(text, &state, first_glyph, bank);
+	text->bank = bank;
+}
+
+static void s2d_set_glyph_color(struct s2d_glyph *g) {
+	s2d_red = g->red;
+	s2d_green = g->green;
+	s2d_blue = g->blue;
+	s2d_alpha = g->alpha;
+	myScale = g->scale;
+}
+
+static void s2d_draw_compiled_dropshadow(struct s2d_glyph *g, int bank) {
+	gDPPipeSync(gdl_head++);
+	gSPObjSubMatrix(gdl_head++, &g->mtx_shadow[bank]);
+	setup_s2d_texture(g->c);
+
+	if (s2d_red != 0
+		&& s2d_green != 0
+		&& s2d_blue != 0
+		) {
+		gDPPipeSync(gdl_head++);
+		gDPSetEnvColor(gdl_head++,
+				   CLAMP_0(s2d_red - 100),
+				   CLAMP_0(s2d_green - 100),
+				   CLAMP_0(s2d_blue - 100),
+				   s2d_alpha);
+		gSPObjRectangleR(gdl_head++, &s2d_font);
+		gDPSetEnvColor(gdl_head++, s2d_red, s2d_green, s2d_blue, s2d_alpha);
+	}
+}
+
+static void s2d_draw_compiled_glyph(struct s2d_glyph *g, int bank) {
+	gDPPipeSync(gdl_head++);
+	gSPObjSubMatrix(gdl_head++, &g->mtx[bank]);
+	setup_s2d_texture(g->c);
+	gSPObjRectangleR(gdl_head++, &s2d_font);
+}
+
+void s2d_text_draw(struct s2d_text *text) {
+	int emulator = IS_RUNNING_ON_EMULATOR;
+	int i;
+
+	if (text->num_glyphs == 0) return;
+
+	if (emulator) {
+		s2d_rdp_init();
+	} else {
+		f3d_rdp_init();
+	}
+
+	for (i = 0; i < text->num_glyphs; i++) {
+		struct s2d_glyph *g = &text->glyphs[i];
+
+		if (!g->drop_shadow) continue;
+
+		s2d_set_glyph_color(g);
+		if (emulator) {
+			s2d_draw_compiled_dropshadow(g, text->bank);
+		} else {
+			draw_f3d_dropshadow(g->c, g->x + g->drop_x, g->y + g->drop_y, NULL);
+		}
+	}
+
+	for (i = 0; i < text->num_glyphs; i++) {
+		struct s2d_glyph *g = &text->glyphs[i];
+
+		s2d_set_glyph_color(g);
+		if (emulator) {
+			s2d_draw_compiled_glyph(g, text->bank);
+		} else {
+			draw_f3d_glyph(g->c, g->x, g->y, NULL);
+		}
+	}
+
+	myScale = 1.0f;
+}
+
+void s2d_print_compiled(struct s2d_text *text, int x, int y, int align, const char *str) {
+	s2d_text_compile(text, x, y, align, str);
+	s2d_text_draw(text);
+}
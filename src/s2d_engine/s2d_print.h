@@ -1,3 +1,6 @@
+#ifndef S2D_PRINT_H
+#define S2D_PRINT_H
+
 #include <ultra64.h>
 #include <PR/gs2dex.h>
 
@@ -33,3 +36,61 @@
 
 extern void s2d_print_alloc(int x, int y, int align, const char *str);
 extern void s2d_type_print(int x, int y, int align, const char *str, uObjMtx *buf, int *pos);
+
+/**
+ * Precompiled text: s2d_text_compile parses a string once into laid out
+ * glyphs, and s2d_text_draw only emits their commands. Recompiling with the
+ * same string does nothing, and a changed string is only re-laid out from the
+ * first line that differs.
+ *
+ * BUTTON codes aren't supported, since they depend on the input every frame.
+ */
+#define S2D_TEXT_MAX_LINES 16
+
+struct s2d_layout_state {
+	short orig_x, x, y;
+	short drop_x, drop_y;
+	unsigned char red, green, blue, alpha;
+	unsigned char drop_shadow;
+	float scale;
+};
+
+struct s2d_glyph {
+	uObjSubMtx mtx[2];        // S2DEX placement of the glyph, one per matrix bank
+	uObjSubMtx mtx_shadow[2]; // and of its drop shadow
+	short x, y;
+	short drop_x, drop_y;
+	float scale;
+	unsigned char c;
+	unsigned char red, green, blue, alpha;
+	unsigned char drop_shadow;
+};
+
+struct s2d_line {
+	short src_start;
+	short first_glyph;
+	struct s2d_layout_state state;
+};
+
+struct s2d_text {
+	char *src;                 // copy of the compiled string
+	struct s2d_glyph *glyphs;
+	int max_len;               // capacity of both buffers, in characters
+	int num_glyphs;
+	int num_lines;
+	int x, y, align;
+	int bank;                  // matrices being drawn; a recompile writes the other bank
+	struct s2d_line lines[S2D_TEXT_MAX_LINES];
+};
+
+// Declares a compiled text called name that holds up to len characters.
+#define S2D_TEXT(name, len) \
+	static char name##_src[(len) + 1]; \
+	static struct s2d_glyph name##_glyphs[len]; \
+	static struct s2d_text name = { name##_src, name##_glyphs, (len) }
+
+extern void s2d_text_compile(struct s2d_text *text, int x, int y, int align, const char *str);
+extern void s2d_text_draw(struct s2d_text *text);
+extern void s2d_print_compiled(struct s2d_text *text, int x, int y, int align, const char *str);
+
+#endif
@@ -0,0 +1,418 @@
+/**
+ * Software model of the n_aspMain audio microcode (rsp/audio.s), used by the
+ * host renderer in place of the RSP. Only the commands emitted by the US/JP
+ * synthesis code are implemented.
+ *
+ * The vector arithmetic is reproduced with plain integer math, so the output is
+ * deterministic and close to, but not bit-exact with, real hardware.
+ */
+
+#include <string.h>
+
+#include <ultra64.h>
+
+#include "aspmain.h"
+
+#define DMEM_SIZE 0x1000
+// Room on both sides for the resampler history and for counts that get rounded up.
+#define DMEM_SLACK 0x100
+
+#define ROUND_UP_8(x)  (((x) + 7) & ~7)
+#define ROUND_UP_16(x) (((x) + 15) & ~15)
+#define ROUND_UP_32(x) (((x) + 31) & ~31)
+
+#define DMEM_U8(addr)  (&sDmem.u8[DMEM_SLACK + ((addr) & (DMEM_SIZE - 1))])
+#define DMEM_S16(addr) ((s16 *) DMEM_U8(addr))
+#define DRAM_PTR(addr) ((u8 *) (uintptr_t) (addr))
+
+static union {
+    u8 u8[DMEM_SLACK + DMEM_SIZE + DMEM_SLACK];
+    s16 s16[(DMEM_SLACK + DMEM_SIZE + DMEM_SLACK) / 2];
+} sDmem;
+
+static struct {
+    u16 in;
+    u16 out;
+    u16 nbytes;
+    u16 dryRight;
+    u16 wetLeft;
+    u16 wetRight;
+
+    s16 vol[2];
+    s16 target[2];
+    s32 rate[2];
+    s16 volDry;
+    s16 volWet;
+
+    s16 adpcmTable[8][2][8];
+    s16 *adpcmLoopState;
+} sAsp;
+
+// Copied from the data section of rsp/audio.s (DMEM 0xC0): 64 phases of a 4-tap filter.
+static const s16 sResampleTable[64][4] = {
+    { 0x0c39, 0x66ad, 0x0d46, 0xffdf }, { 0x0b39, 0x6696, 0x0e5f, 0xffd8 },
+    { 0x0a44, 0x6669, 0x0f83, 0xffd0 }, { 0x095a, 0x6626, 0x10b4, 0xffc8 },
+    { 0x087d, 0x65cd, 0x11f0, 0xffbf }, { 0x07ab, 0x655e, 0x1338, 0xffb6 },
+    { 0x06e4, 0x64d9, 0x148c, 0xffac }, { 0x0628, 0x643f, 0x15eb, 0xffa1 },
+    { 0x0577, 0x638f, 0x1756, 0xff96 }, { 0x04d1, 0x62cb, 0x18cb, 0xff8a },
+    { 0x0435, 0x61f3, 0x1a4c, 0xff7e }, { 0x03a4, 0x6106, 0x1bd7, 0xff71 },
+    { 0x031c, 0x6007, 0x1d6c, 0xff64 }, { 0x029f, 0x5ef5, 0x1f0b, 0xff56 },
+    { 0x022a, 0x5dd0, 0x20b3, 0xff48 }, { 0x01be, 0x5c9a, 0x2264, 0xff3a },
+    { 0x015b, 0x5b53, 0x241e, 0xff2c }, { 0x0101, 0x59fc, 0x25e0, 0xff1e },
+    { 0x00ae, 0x5896, 0x27a9, 0xff10 }, { 0x0063, 0x5720, 0x297a, 0xff02 },
+    { 0x001f, 0x559d, 0x2b50, 0xfef4 }, { 0xffe2, 0x540d, 0x2d2c, 0xfee8 },
+    { 0xffac, 0x5270, 0x2f0d, 0xfedb }, { 0xff7c, 0x50c7, 0x30f3, 0xfed0 },
+    { 0xff53, 0x4f14, 0x32dc, 0xfec6 }, { 0xff2e, 0x4d57, 0x34c8, 0xfebd },
+    { 0xff0f, 0x4b91, 0x36b6, 0xfeb6 }, { 0xfef5, 0x49c2, 0x38a5, 0xfeb0 },
+    { 0xfedf, 0x47ed, 0x3a95, 0xfeac }, { 0xfece, 0x4611, 0x3c85, 0xfeab },
+    { 0xfec0, 0x4430, 0x3e74, 0xfeac }, { 0xfeb6, 0x424a, 0x4060, 0xfeaf },
+    { 0xfeaf, 0x4060, 0x424a, 0xfeb6 }, { 0xfeac, 0x3e74, 0x4430, 0xfec0 },
+    { 0xfeab, 0x3c85, 0x4611, 0xfece }, { 0xfeac, 0x3a95, 0x47ed, 0xfedf },
+    { 0xfeb0, 0x38a5, 0x49c2, 0xfef5 }, { 0xfeb6, 0x36b6, 0x4b91, 0xff0f },
+    { 0xfebd, 0x34c8, 0x4d57, 0xff2e }, { 0xfec6, 0x32dc, 0x4f14, 0xff53 },
+    { 0xfed0, 0x30f3, 0x50c7, 0xff7c }, { 0xfedb, 0x2f0d, 0x5270, 0xffac },
+    { 0xfee8, 0x2d2c, 0x540d, 0xffe2 }, { 0xfef4, 0x2b50, 0x559d, 0x001f },
+    { 0xff02, 0x297a, 0x5720, 0x0063 }, { 0xff10, 0x27a9, 0x5896, 0x00ae },
+    { 0xff1e, 0x25e0, 0x59fc, 0x0101 }, { 0xff2c, 0x241e, 0x5b53, 0x015b },
+    { 0xff3a, 0x2264, 0x5c9a, 0x01be }, { 0xff48, 0x20b3, 0x5dd0, 0x022a },
+    { 0xff56, 0x1f0b, 0x5ef5, 0x029f }, { 0xff64, 0x1d6c, 0x6007, 0x031c },
+    { 0xff71, 0x1bd7, 0x6106, 0x03a4 }, { 0xff7e, 0x1a4c, 0x61f3, 0x0435 },
+    { 0xff8a, 0x18cb, 0x62cb, 0x04d1 }, { 0xff96, 0x1756, 0x638f, 0x0577 },
+    { 0xffa1, 0x15eb, 0x643f, 0x0628 }, { 0xffac, 0x148c, 0x64d9, 0x06e4 },
+    { 0xffb6, 0x1338, 0x655e, 0x07ab }, { 0xffbf, 0x11f0, 0x65cd, 0x087d },
+    { 0xffc8, 0x10b4, 0x6626, 0x095a }, { 0xffd0, 0x0f83, 0x6669, 0x0a44 },
+    { 0xffd8, 0x0e5f, 0x6696, 0x0b39 }, { 0xffdf, 0x0d46, 0x66ad, 0x0c39 },
+};
+
+const char *gAspMainOpNames[ASPMAIN_NUM_OPCODES] = {
+    "SPNOOP", "ADPCM", "CLEARBUFF", "ENVMIXER", "LOADBUFF", "RESAMPLE", "SAVEBUFF", "SEGMENT",
+    "SETBUFF", "SETVOL", "DMEMMOVE", "LOADADPCM", "MIXER", "INTERLEAVE", "POLEF", "SETLOOP",
+};
+
+static s16 clamp16(s32 v) {
+    if (v < -0x8000) {
+        return -0x8000;
+    }
+    if (v > 0x7fff) {
+        return 0x7fff;
+    }
+    return v;
+}
+
+static s32 clamp32(s64 v) {
+    if (v < -0x7fffffffLL - 1) {
+        return -0x7fffffff - 1;
+    }
+    if (v > 0x7fffffffLL) {
+        return 0x7fffffff;
+    }
+    return v;
+}
+
+// The RSP DMA engine ignores the low 3 bits of both addresses and transfers whole
+// 8 byte words, which the sample loading code in synthesis.c relies on.
+static void asp_load_buffer(u32 dramAddr) {
+    memcpy(DMEM_U8(sAsp.in & ~7), DRAM_PTR(dramAddr & ~7), ROUND_UP_8(sAsp.nbytes));
+}
+
+static void asp_save_buffer(u32 dramAddr) {
+    memcpy(DRAM_PTR(dramAddr & ~7), DMEM_U8(sAsp.out & ~7), ROUND_UP_8(sAsp.nbytes));
+}
+
+static void asp_load_adpcm_book(u32 count, u32 dramAddr) {
+    if (count > sizeof(sAsp.adpcmTable)) {
+        count = sizeof(sAsp.adpcmTable);
+    }
+    memcpy(sAsp.adpcmTable, DRAM_PTR(dramAddr), count);
+}
+
+static void asp_set_buffer(u8 flags, u16 in, u16 out, u16 count) {
+    if (flags & A_AUX) {
+        sAsp.dryRight = in;
+        sAsp.wetLeft = out;
+        sAsp.wetRight = count;
+    } else {
+        sAsp.in = in;
+        sAsp.out = out;
+        sAsp.nbytes = count;
+    }
+}
+
+static void asp_set_volume(u8 flags, u16 vol, u16 voltgt, u16 volrate) {
+    if (flags & A_AUX) {
+        sAsp.volDry = vol;
+        sAsp.volWet = volrate;
+    } else if (flags & A_VOL) {
+        sAsp.vol[(flags & A_LEFT) ? 0 : 1] = vol;
+    } else {
+        sAsp.target[(flags & A_LEFT) ? 0 : 1] = vol;
+        sAsp.rate[(flags & A_LEFT) ? 0 : 1] = (voltgt << 16) | volrate;
+    }
+}
+
+static void asp_clear_buffer(u16 addr, u32 count) {
+    memset(DMEM_U8(addr), 0, ROUND_UP_16(count));
+}
+
+static void asp_dmem_move(u16 in, u16 out, u16 count) {
+    memmove(DMEM_U8(out), DMEM_U8(in), ROUND_UP_16(count));
+}
+
+static void asp_mix(s16 gain, u16 in, u16 out) {
+    s16 *src = DMEM_S16(in);
+    s16 *dst = DMEM_S16(out);
+    s32 n = ROUND_UP_32(sAsp.nbytes) / 2;
+    s32 i;
+
+    for (i = 0; i < n; i++) {
+        dst[i] = clamp16((dst[i] * 0x7fff + src[i] * gain + 0x4000) >> 15);
+    }
+}
+
+static void asp_interleave(u16 left, u16 right) {
+    s16 *l = DMEM_S16(left);
+    s16 *r = DMEM_S16(right);
+    s16 *dst = DMEM_S16(sAsp.out);
+    s32 n = ROUND_UP_16(sAsp.nbytes) / 2;
+    s32 i;
+
+    for (i = 0; i < n; i++) {
+        *dst++ = l[i];
+        *dst++ = r[i];
+    }
+}
+
+static void asp_adpcm_decode(u8 flags, s16 *state) {
+    u8 *in = DMEM_U8(sAsp.in);
+    s16 *out = DMEM_S16(sAsp.out);
+    s32 nbytes = ROUND_UP_32(sAsp.nbytes);
+
+    if (flags & A_INIT) {
+        memset(out, 0, 16 * sizeof(s16));
+    } else if (flags & A_LOOP) {
+        memcpy(out, sAsp.adpcmLoopState, 16 * sizeof(s16));
+    } else {
+        memcpy(out, state, 16 * sizeof(s16));
+    }
+    out += 16;
+
+    while (nbytes > 0) {
+        s32 shift = *in >> 4;
+        s16 (*book)[8] = sAsp.adpcmTable[*in++ & 7];
+        s32 half;
+
+        // Each 9 byte frame holds a header and 16 4-bit residuals, predicted in two groups of 8.
+        for (half = 0; half < 2; half++) {
+            s16 residuals[8];
+            s16 prev2 = out[-2];
+            s16 prev1 = out[-1];
+            s32 j, k;
+
+            for (j = 0; j < 4; j++) {
+                residuals[j * 2 + 0] = (s16)((((*in >> 4) ^ 8) - 8) * (1 << shift));
+                residuals[j * 2 + 1] = (s16)((((*in & 0xf) ^ 8) - 8) * (1 << shift));
+                in++;
+            }
+            for (j = 0; j < 8; j++) {
+                s32 acc = book[0][j] * prev2 + book[1][j] * prev1 + residuals[j] * (1 << 11);
+
+                for (k = 0; k < j; k++) {
+                    acc += book[1][j - k - 1] * residuals[k];
+                }
+                *out++ = clamp16(acc >> 11);
+            }
+        }
+        nbytes -= 16 * sizeof(s16);
+    }
+    memcpy(state, out - 16, 16 * sizeof(s16));
+}
+
+static void asp_resample(u8 flags, u16 pitch, s16 *state) {
+    s16 *inInitial = DMEM_S16(sAsp.in);
+    s16 *in = inInitial;
+    s16 *out = DMEM_S16(sAsp.out);
+    s32 nbytes = ROUND_UP_16(sAsp.nbytes);
+    s16 tmp[16];
+    u32 pitchAcc;
+    s32 i;
+
+    if (flags & A_INIT) {
+        memset(tmp, 0, sizeof(tmp));
+    } else {
+        memcpy(tmp, state, sizeof(tmp));
+    }
+
+    // The four source samples kept from the previous call are placed just before the input.
+    in -= 4;
+    pitchAcc = (u16) tmp[4];
+    memcpy(in, tmp, 4 * sizeof(s16));
+
+    do {
+        for (i = 0; i < 8; i++) {
+            const s16 *tap = sResampleTable[pitchAcc * 64 >> 16];
+            s32 sample = ((in[0] * tap[0] + 0x4000) >> 15) + ((in[1] * tap[1] + 0x4000) >> 15)
+                       + ((in[2] * tap[2] + 0x4000) >> 15) + ((in[3] * tap[3] + 0x4000) >> 15);
+
+            *out++ = clamp16(sample);
+            pitchAcc += pitch << 1;
+            in += pitchAcc >> 16;
+            pitchAcc &= 0xffff;
+        }
+        nbytes -= 8 * sizeof(s16);
+    } while (nbytes > 0);
+
+    memcpy(state, in, 4 * sizeof(s16));
+    state[4] = pitchAcc;
+}
+
+static void asp_env_mixer(u8 flags, s16 *state) {
+    s16 *in = DMEM_S16(sAsp.in);
+    s16 *dry[2] = { DMEM_S16(sAsp.out), DMEM_S16(sAsp.dryRight) };
+    s16 *wet[2] = { DMEM_S16(sAsp.wetLeft), DMEM_S16(sAsp.wetRight) };
+    s32 n = ROUND_UP_16(sAsp.nbytes) / 2;
+    // Volumes are 16.16 and kept per lane; every 8 samples each lane is scaled by the rate.
+    s32 vols[2][8];
+    s32 rates[2];
+    s16 targets[2];
+    s16 volDry, volWet;
+    s32 c, i;
+
+    if (flags & A_INIT) {
+        volDry = sAsp.volDry;
+        volWet = sAsp.volWet;
+        for (c = 0; c < 2; c++) {
+            s32 step = (s32)(((s64) sAsp.vol[c] * (sAsp.rate[c] - 0x10000)) / 8);
+
+            rates[c] = sAsp.rate[c];
+            targets[c] = sAsp.target[c];
+            for (i = 0; i < 8; i++) {
+                vols[c][i] = clamp32(((s64) sAsp.vol[c] << 16) + (s64) step * (i + 1));
+            }
+        }
+    } else {
+        memcpy(vols, state, sizeof(vols));
+        targets[0] = state[32];
+        rates[0] = (state[33] << 16) | (u16) state[34];
+        targets[1] = state[35];
+        rates[1] = (state[36] << 16) | (u16) state[37];
+        volDry = state[38];
+        volWet = state[39];
+    }
+
+    for (; n > 0; n -= 8) {
+        for (i = 0; i < 8; i++) {
+            s16 sample = *in++;
+
+            for (c = 0; c < 2; c++) {
+                s32 vol = vols[c][i] >> 16;
+                s16 scaled;
+
+                if (rates[c] >= 0x10000 ? vol > targets[c] : vol < targets[c]) {
+                    vol = targets[c];
+                }
+                scaled = (sample * vol) >> 15;
+                *dry[c] = clamp16(*dry[c] + ((scaled * volDry) >> 15));
+                dry[c]++;
+                if (flags & A_AUX) {
+                    *wet[c] = clamp16(*wet[c] + ((scaled * volWet) >> 15));
+                    wet[c]++;
+                }
+            }
+        }
+        for (c = 0; c < 2; c++) {
+            for (i = 0; i < 8; i++) {
+                vols[c][i] = clamp32(((s64) vols[c][i] * rates[c]) >> 16);
+            }
+        }
+    }
+
+    memcpy(state, vols, sizeof(vols));
+    state[32] = targets[0];
+    state[33] = rates[0] >> 16;
+    state[34] = rates[0];
+    state[35] = targets[1];
+    state[36] = rates[1] >> 16;
+    state[37] = rates[1];
+    state[38] = volDry;
+    state[39] = volWet;
+}
+
+void aspmain_reset(void) {
+    memset(&sDmem, 0, sizeof(sDmem));
+    memset(&sAsp, 0, sizeof(sAsp));
+}
+
+void aspmain_run_task(u64 *cmdList, s32 numCmds, struct AspMainStats *stats) {
+    Acmd *cmd = (Acmd *) cmdList;
+    s32 updateStart = 0;
+    s32 interleaved = FALSE;
+    s32 i;
+
+    stats->numUpdates = 0;
+
+    for (i = 0; i < numCmds; i++, cmd++) {
+        u32 w0 = cmd->words.w0;
+        u32 w1 = cmd->words.w1;
+        u8 op = w0 >> 24;
+        u8 flags = (w0 >> 16) & 0xff;
+
+        if (op < ASPMAIN_NUM_OPCODES) {
+            stats->opCounts[op]++;
+        } else {
+            stats->unknownOps++;
+            continue;
+        }
+
+        switch (op) {
+            case A_SPNOOP:
+            case A_SEGMENT:
+            case A_POLEF:
+                break;
+            case A_ADPCM:
+                asp_adpcm_decode(flags, (s16 *) DRAM_PTR(w1));
+                break;
+            case A_CLEARBUFF:
+                asp_clear_buffer(w0 & 0xffffff, w1);
+                break;
+            case A_ENVMIXER:
+                asp_env_mixer(flags, (s16 *) DRAM_PTR(w1));
+                break;
+            case A_LOADBUFF:
+                asp_load_buffer(w1);
+                break;
+            case A_RESAMPLE:
+                asp_resample(flags, w0 & 0xffff, (s16 *) DRAM_PTR(w1));
+                break;
+            case A_SAVEBUFF:
+                asp_save_buffer(w1);
+                if (interleaved && stats->numUpdates < ASPMAIN_MAX_UPDATES) {
+                    stats->updateCmds[stats->numUpdates++] = i + 1 - updateStart;
+                    updateStart = i + 1;
+                }
+                interleaved = FALSE;
+                break;
+            case A_SETBUFF:
+                asp_set_buffer(flags, w0 & 0xffff, w1 >> 16, w1 & 0xffff);
+                break;
+            case A_SETVOL:
+                asp_set_volume(flags, w0 & 0xffff, w1 >> 16, w1 & 0xffff);
+                break;
+            case A_DMEMMOVE:
+                asp_dmem_move(w0 & 0xffffff, w1 >> 16, w1 & 0xffff);
+                break;
+            case A_LOADADPCM:
+                asp_load_adpcm_book(w0 & 0xffffff, w1);
+                break;
+            case A_MIXER:
+                asp_mix(w0 & 0xffff, w1 >> 16, w1 & 0xffff);
+                break;
+            case A_INTERLEAVE:
+                asp_interleave(w1 >> 16, w1 & 0xffff);
+                interleaved = TRUE;
+                break;
+            case A_SETLOOP:
+                sAsp.adpcmLoopState = (s16 *) DRAM_PTR(w1);
+                break;
+        }
+    }
+}
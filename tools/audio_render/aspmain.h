@@ -0,0 +1,24 @@
+#ifndef ASPMAIN_H
+#define ASPMAIN_H
+
+#include <PR/ultratypes.h>
+
+// Opcodes are 8 bits wide, but the n_aspMain ucode only implements the first 16.
+#define ASPMAIN_NUM_OPCODES 16
+#define ASPMAIN_MAX_UPDATES 16
+
+struct AspMainStats {
+    u32 opCounts[ASPMAIN_NUM_OPCODES];
+    u32 unknownOps;
+    // Command count of each audio update in the last task. An update ends with the
+    // aInterleave + aSaveBuffer pair that writes it to the AI buffer.
+    u32 updateCmds[ASPMAIN_MAX_UPDATES];
+    s32 numUpdates;
+};
+
+void aspmain_reset(void);
+void aspmain_run_task(u64 *cmdList, s32 numCmds, struct AspMainStats *stats);
+
+extern const char *gAspMainOpNames[ASPMAIN_NUM_OPCODES];
+
+#endif // ASPMAIN_H
@@ -0,0 +1,314 @@
+/**
+ * audio_render: runs the game's audio engine (src/audio) on the host and renders
+ * a sequence to a WAV file. The RSP audio task is executed by a C model of the
+ * microcode (aspmain.c), so the output only depends on the inputs and can be
+ * diffed between builds. Per frame and per audio update command counts and the
+ * CPU time spent in synthesis and in the microcode are reported, which makes it
+ * usable as a benchmark for audio settings (BETTER_REVERB, EXPAND_AUDIO_HEAP,
+ * session presets, ...).
+ *
+ * Build with `make audio-render`, which also assembles the sound data for the host.
+ *
+ * Usage: audio_render [options] <sound data dir>
+ *   -s <seq>         sequence to play on the level player (default 0x0C)
+ *   -p <preset>      audio session preset passed to sound_reset (default 0)
+ *   -n <frames>      number of 60 Hz frames to render (default 1800)
+ *   -e <bits>@<frame> play a sound effect on that frame, may be repeated
+ *   -o <file.wav>    write the rendered audio
+ *   -c <file.csv>    write per frame statistics
+ *   -q               only print the summary line
+ */
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <ultra64.h>
+
+#include "audio/data.h"
+#include "audio/external.h"
+#include "audio/heap.h"
+#include "audio/load.h"
+
+#include "aspmain.h"
+#include "host_stubs.h"
+
+#define MAX_SFX_EVENTS 256
+
+struct SfxEvent {
+    s32 soundBits;
+    u32 frame;
+};
+
+struct FrameStats {
+    u32 cmds;
+    u32 updates;
+    u32 maxUpdateCmds;
+    u64 synthNs;
+    u64 ucodeNs;
+};
+
+static struct SfxEvent sSfxEvents[MAX_SFX_EVENTS];
+static s32 sNumSfxEvents;
+
+static FILE *sWavFile;
+static u32 sWavFrames;
+static u64 sOutputHash = 0xcbf29ce484222325ULL;
+
+static u64 time_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void write_le(FILE *f, u32 value, s32 size) {
+    s32 i;
+
+    for (i = 0; i < size; i++) {
+        fputc((value >> (i * 8)) & 0xff, f);
+    }
+}
+
+static void write_wav_header(FILE *f, u32 frequency, u32 numFrames) {
+    u32 dataSize = numFrames * 4;
+
+    fwrite("RIFF", 1, 4, f);
+    write_le(f, 36 + dataSize, 4);
+    fwrite("WAVEfmt ", 1, 8, f);
+    write_le(f, 16, 4);
+    write_le(f, 1, 2); // PCM
+    write_le(f, 2, 2);
+    write_le(f, frequency, 4);
+    write_le(f, frequency * 4, 4);
+    write_le(f, 4, 2);
+    write_le(f, 16, 2);
+    fwrite("data", 1, 4, f);
+    write_le(f, dataSize, 4);
+}
+
+/**
+ * Called for every buffer handed to the AI. Hashes the samples (FNV-1a) so two
+ * renders can be compared without keeping the WAV around.
+ */
+static void output_samples(s16 *samples, u32 numFrames) {
+    u32 i;
+
+    for (i = 0; i < numFrames * 2; i++) {
+        u16 sample = samples[i];
+
+        sOutputHash = (sOutputHash ^ (sample & 0xff)) * 0x100000001b3ULL;
+        sOutputHash = (sOutputHash ^ (sample >> 8)) * 0x100000001b3ULL;
+        if (sWavFile != NULL) {
+            write_le(sWavFile, sample, 2);
+        }
+    }
+    sWavFrames += numFrames;
+}
+
+static void load_file(const char *dir, const char *name, u8 *dest, size_t capacity) {
+    char path[1024];
+    FILE *f;
+    size_t size;
+
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    f = fopen(path, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "audio_render: can't open %s\n", path);
+        exit(1);
+    }
+    size = fread(dest, 1, capacity, f);
+    if (size == capacity && fgetc(f) != EOF) {
+        fprintf(stderr, "audio_render: %s is larger than 0x%zx bytes\n", path, capacity);
+        exit(1);
+    }
+    fclose(f);
+}
+
+static void load_sound_data(const char *dir) {
+#if IS_64_BIT
+    // Audio commands only hold 32 bits of each DRAM address (see Awords in abi.h).
+    if ((uintptr_t) gAudioHeap + DOUBLE_SIZE_ON_64_BIT(AUDIO_HEAP_SIZE) > 0xFFFFFFFFU
+        || (uintptr_t) gSoundDataRaw + SOUND_DATA_TBL_MAX > 0xFFFFFFFFU) {
+        fprintf(stderr, "audio_render: audio buffers must be below 4 GiB, link with -no-pie\n");
+        exit(1);
+    }
+#endif
+    load_file(dir, "sound_data.ctl", gSoundDataADSR, SOUND_DATA_CTL_MAX);
+    load_file(dir, "sound_data.tbl", gSoundDataRaw, SOUND_DATA_TBL_MAX);
+    load_file(dir, "sequences.bin", gMusicData, SOUND_DATA_SEQ_MAX);
+    load_file(dir, "bank_sets", gBankSetsData, SOUND_DATA_BANK_SETS_MAX);
+}
+
+static void add_sfx_event(const char *arg) {
+    char *end;
+    s32 bits = strtoul(arg, &end, 0);
+
+    if (*end != '@' || sNumSfxEvents == MAX_SFX_EVENTS) {
+        fprintf(stderr, "audio_render: bad sound event '%s', expected <bits>@<frame>\n", arg);
+        exit(1);
+    }
+    sSfxEvents[sNumSfxEvents].soundBits = bits;
+    sSfxEvents[sNumSfxEvents].frame = strtoul(end + 1, NULL, 0);
+    sNumSfxEvents++;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [-s seq] [-p preset] [-n frames] [-e bits@frame]... [-o out.wav] [-c stats.csv] [-q] <sound data dir>\n",
+            prog);
+    exit(1);
+}
+
+int main(int argc, char **argv) {
+    struct AspMainStats ucodeStats;
+    struct FrameStats frame, total, peak;
+    const char *wavPath = NULL;
+    const char *csvPath = NULL;
+    FILE *csvFile = NULL;
+    s32 seqId = 0x0C;
+    s32 preset = 0;
+    u32 numFrames = 1800;
+    u32 taskFrames = 0;
+    u32 totalUpdates = 0;
+    s32 quiet = FALSE;
+    u32 i;
+    s32 j;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "s:p:n:e:o:c:q")) != -1) {
+        switch (opt) {
+            case 's': seqId = strtol(optarg, NULL, 0); break;
+            case 'p': preset = strtol(optarg, NULL, 0); break;
+            case 'n': numFrames = strtoul(optarg, NULL, 0); break;
+            case 'e': add_sfx_event(optarg); break;
+            case 'o': wavPath = optarg; break;
+            case 'c': csvPath = optarg; break;
+            case 'q': quiet = TRUE; break;
+            default: usage(argv[0]);
+        }
+    }
+    if (optind != argc - 1) {
+        usage(argv[0]);
+    }
+
+    load_sound_data(argv[optind]);
+    if (wavPath != NULL) {
+        sWavFile = fopen(wavPath, "wb");
+        if (sWavFile == NULL) {
+            fprintf(stderr, "audio_render: can't create %s\n", wavPath);
+            return 1;
+        }
+        write_wav_header(sWavFile, 0, 0);
+    }
+    if (csvPath != NULL) {
+        csvFile = fopen(csvPath, "w");
+        if (csvFile == NULL) {
+            fprintf(stderr, "audio_render: can't create %s\n", csvPath);
+            return 1;
+        }
+        fprintf(csvFile, "frame,cmds,updates,max_update_cmds,synth_us,ucode_us\n");
+    }
+
+    gHostAi.output = output_samples;
+    aspmain_reset();
+    bzero(&ucodeStats, sizeof(ucodeStats));
+    bzero(&total, sizeof(total));
+    bzero(&peak, sizeof(peak));
+
+    // Same order as thread4_sound and the level loading code.
+    audio_init();
+    sound_init();
+    sound_reset(preset);
+    play_music(SEQ_PLAYER_LEVEL, SEQUENCE_ARGS(4, seqId), 0);
+
+    for (i = 0; i < numFrames; i++) {
+        struct SPTask *task;
+        u64 start;
+
+        // The game loop runs at 30 Hz and queues its sounds before ticking the audio thread.
+        if ((i & 1) == 0) {
+            for (j = 0; j < sNumSfxEvents; j++) {
+                if (sSfxEvents[j].frame == i || sSfxEvents[j].frame == i + 1) {
+                    play_sound(sSfxEvents[j].soundBits, gGlobalSoundSource);
+                }
+            }
+            audio_signal_game_loop_tick();
+        }
+
+        bzero(&frame, sizeof(frame));
+        start = time_ns();
+        task = create_next_audio_frame_task();
+        frame.synthNs = time_ns() - start;
+
+        if (task != NULL) {
+            frame.cmds = task->task.t.data_size / sizeof(u64);
+            start = time_ns();
+            aspmain_run_task(task->task.t.data_ptr, frame.cmds, &ucodeStats);
+            frame.ucodeNs = time_ns() - start;
+
+            frame.updates = ucodeStats.numUpdates;
+            for (j = 0; j < ucodeStats.numUpdates; j++) {
+                frame.maxUpdateCmds = MAX(frame.maxUpdateCmds, ucodeStats.updateCmds[j]);
+            }
+            taskFrames++;
+            totalUpdates += frame.updates;
+        }
+        host_ai_vblank();
+
+        total.cmds += frame.cmds;
+        total.synthNs += frame.synthNs;
+        total.ucodeNs += frame.ucodeNs;
+        peak.cmds = MAX(peak.cmds, frame.cmds);
+        peak.maxUpdateCmds = MAX(peak.maxUpdateCmds, frame.maxUpdateCmds);
+        peak.synthNs = MAX(peak.synthNs, frame.synthNs);
+        peak.ucodeNs = MAX(peak.ucodeNs, frame.ucodeNs);
+
+        if (csvFile != NULL) {
+            fprintf(csvFile, "%u,%u,%u,%u,%.2f,%.2f\n", i, frame.cmds, frame.updates, frame.maxUpdateCmds,
+                    frame.synthNs / 1000.0, frame.ucodeNs / 1000.0);
+        }
+    }
+
+    if (sWavFile != NULL) {
+        fseek(sWavFile, 0, SEEK_SET);
+        write_wav_header(sWavFile, gAiFrequency, sWavFrames);
+        fclose(sWavFile);
+    }
+    if (csvFile != NULL) {
+        fclose(csvFile);
+    }
+
+    if (taskFrames == 0) {
+        fprintf(stderr, "audio_render: no audio tasks were created\n");
+        return 1;
+    }
+
+    if (!quiet) {
+        printf("frequency:      %d Hz, %d updates/frame, %d notes\n", gAiFrequency, gAudioUpdatesPerFrame,
+               gMaxSimultaneousNotes);
+        printf("frames:         %u (%u with a task), %u samples, %u AI underruns\n", numFrames, taskFrames,
+               sWavFrames, gHostAi.underruns);
+        printf("cmds/frame:     avg %.1f, max %u\n", (f64) total.cmds / taskFrames, peak.cmds);
+        printf("cmds/update:    avg %.1f, max %u\n", totalUpdates ? (f64) total.cmds / totalUpdates : 0.0,
+               peak.maxUpdateCmds);
+        printf("synthesis:      avg %.2f us, max %.2f us\n", total.synthNs / 1000.0 / taskFrames,
+               peak.synthNs / 1000.0);
+        printf("microcode:      avg %.2f us, max %.2f us\n", total.ucodeNs / 1000.0 / taskFrames,
+               peak.ucodeNs / 1000.0);
+        printf("commands:\n");
+        for (j = 0; j < ASPMAIN_NUM_OPCODES; j++) {
+            if (ucodeStats.opCounts[j] != 0) {
+                printf("  %-12s %u\n", gAspMainOpNames[j], ucodeStats.opCounts[j]);
+            }
+        }
+        if (ucodeStats.unknownOps != 0) {
+            printf("  %-12s %u\n", "unknown", ucodeStats.unknownOps);
+        }
+    }
+    printf("hash %016llx cmds %u synth_us %.0f ucode_us %.0f\n", (unsigned long long) sOutputHash, total.cmds,
+           total.synthNs / 1000.0, total.ucodeNs / 1000.0);
+    return 0;
+}
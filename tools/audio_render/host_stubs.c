@@ -0,0 +1,166 @@
+/**
+ * Host replacements for the libultra calls and game globals the audio engine
+ * links against. The renderer is single threaded, so message queues never
+ * block and PI DMA completes immediately.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ultra64.h>
+#include <PR/libaudio.h>
+
+#include "types.h"
+#include "level_table.h"
+#include "audio/data.h"
+#include "game/area.h"
+#include "game/game_init.h"
+#include "game/level_update.h"
+#include "game/main.h"
+#include "game/object_list_processor.h"
+#include "game/vc_check.h"
+
+#include "host_stubs.h"
+
+#define VI_NTSC_CLOCK 48681812
+
+ALIGNED16 u8 gAudioHeap[DOUBLE_SIZE_ON_64_BIT(AUDIO_HEAP_SIZE)];
+
+// Filled from the files written by assemble_sound.py, see load_sound_data() in audio_render.c.
+ALIGNED16 u8 gSoundDataADSR[SOUND_DATA_CTL_MAX];
+ALIGNED16 u8 gSoundDataRaw[SOUND_DATA_TBL_MAX];
+ALIGNED16 u8 gMusicData[SOUND_DATA_SEQ_MAX];
+ALIGNED16 u8 gBankSetsData[SOUND_DATA_BANK_SETS_MAX];
+
+// Only the addresses of the ucode segments are taken.
+u64 rspbootTextStart[1], rspbootTextEnd[1];
+u64 aspMainTextStart[1], aspMainTextEnd[1];
+u64 aspMainDataStart[1], aspMainDataEnd[1];
+
+struct Config gConfig = { .audioFrequency = 1.0f };
+struct MarioState gMarioStates[1];
+s16 gCurrLevelNum = LEVEL_CASTLE_GROUNDS;
+s16 gCurrAreaIndex = 1;
+s16 gMarioCurrentRoom;
+s8 gAudioEnabled = TRUE;
+// audio_reset_session would otherwise spin until the (nonexistent) audio thread runs a frame.
+u8 gIsVC = TRUE;
+// BETTER_REVERB picks its console settings from this.
+u8 gIsConsole = TRUE;
+
+struct AudioInterface gHostAi;
+
+void osSyncPrintf(UNUSED const char *fmt, ...) {
+}
+
+void osInvalDCache(UNUSED void *vaddr, UNUSED s32 nbytes) {
+}
+
+void osWritebackDCache(UNUSED void *vaddr, UNUSED s32 nbytes) {
+}
+
+void osWritebackDCacheAll(void) {
+}
+
+void osCreateMesgQueue(OSMesgQueue *mq, OSMesg *msg, s32 count) {
+    mq->mtqueue = NULL;
+    mq->fullqueue = NULL;
+    mq->validCount = 0;
+    mq->first = 0;
+    mq->msgCount = count;
+    mq->msg = msg;
+}
+
+s32 osSendMesg(OSMesgQueue *mq, OSMesg msg, UNUSED s32 flag) {
+    if (mq->validCount >= mq->msgCount) {
+        return -1;
+    }
+    mq->msg[(mq->first + mq->validCount) % mq->msgCount] = msg;
+    mq->validCount++;
+    return 0;
+}
+
+s32 osRecvMesg(OSMesgQueue *mq, OSMesg *msg, s32 flag) {
+    if (mq->validCount == 0) {
+        if (flag == OS_MESG_BLOCK) {
+            // Nothing else runs that could ever send it.
+            fprintf(stderr, "audio_render: blocking receive on an empty queue\n");
+            exit(1);
+        }
+        return -1;
+    }
+    if (msg != NULL) {
+        *msg = mq->msg[mq->first];
+    }
+    mq->first = (mq->first + 1) % mq->msgCount;
+    mq->validCount--;
+    return 0;
+}
+
+s32 osPiStartDma(OSIoMesg *mb, UNUSED s32 priority, UNUSED s32 direction, u32 devAddr, void *vAddr,
+                 u32 nbytes, OSMesgQueue *mq) {
+    // ROM addresses are the host addresses of the sound data arrays.
+    memcpy(vAddr, (void *) (uintptr_t) devAddr, nbytes);
+    if (mq != NULL) {
+        osSendMesg(mq, mb, OS_MESG_NOBLOCK);
+    }
+    return 0;
+}
+
+void alSeqFileNew(ALSeqFile *f, u8 *base) {
+    s32 i;
+
+    for (i = 0; i < f->seqCount; i++) {
+        f->seqArray[i].offset = base + (uintptr_t) f->seqArray[i].offset;
+    }
+}
+
+s32 osAiSetFrequency(u32 frequency) {
+    u32 dacRate = (u32)((f32) VI_NTSC_CLOCK / frequency + 0.5f);
+
+    gHostAi.frequency = VI_NTSC_CLOCK / dacRate;
+    return gHostAi.frequency;
+}
+
+/**
+ * The AI plays one buffer while holding the next. osAiGetLength reports what is
+ * left of the playing one, which drives how much the game synthesizes per frame.
+ */
+u32 osAiGetLength(void) {
+    return gHostAi.remaining[0] * 4;
+}
+
+s32 osAiSetNextBuffer(void *vaddr, u32 nbytes) {
+    // Real hardware would drop a third buffer; keep it so that nothing the game made is lost.
+    if (gHostAi.remaining[0] == 0) {
+        gHostAi.remaining[0] = nbytes / 4;
+    } else {
+        gHostAi.remaining[1] += nbytes / 4;
+    }
+    if (gHostAi.output != NULL) {
+        gHostAi.output(vaddr, nbytes / 4);
+    }
+    return 0;
+}
+
+void host_ai_vblank(void) {
+    u32 played = gHostAi.frequency / 60;
+
+    while (played != 0 && gHostAi.remaining[0] != 0) {
+        u32 n = MIN(played, gHostAi.remaining[0]);
+
+        gHostAi.remaining[0] -= n;
+        played -= n;
+        if (gHostAi.remaining[0] == 0) {
+            gHostAi.remaining[0] = gHostAi.remaining[1];
+            gHostAi.remaining[1] = 0;
+        } else {
+            break;
+        }
+    }
+    if (played != 0) {
+        gHostAi.underruns++;
+    }
+}
@@ -0,0 +1,29 @@
+#ifndef HOST_STUBS_H
+#define HOST_STUBS_H
+
+#include <PR/ultratypes.h>
+
+// Capacities of the sound data arrays that stand in for the ROM.
+#define SOUND_DATA_CTL_MAX       0x400000
+#define SOUND_DATA_TBL_MAX       0x4000000
+#define SOUND_DATA_SEQ_MAX       0x400000
+#define SOUND_DATA_BANK_SETS_MAX 0x10000
+
+struct AudioInterface {
+    u32 frequency;
+    // Samples left in the playing buffer and in the queued one.
+    u32 remaining[2];
+    u32 underruns;
+    void (*output)(s16 *samples, u32 numFrames);
+};
+
+extern u8 gSoundDataADSR[];
+extern u8 gSoundDataRaw[];
+extern u8 gMusicData[];
+extern u8 gBankSetsData[];
+
+extern struct AudioInterface gHostAi;
+
+void host_ai_vblank(void);
+
+#endif // HOST_STUBS_H
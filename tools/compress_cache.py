@@ -0,0 +1,228 @@
+#!/usr/bin/env python3
+"""Content-addressed cache for compressed segments.
+
+Wraps an encoder command (rncpack, mio0, slienc, gzip, ...) and keys its output
+on the SHA-1 of the input bytes, the encoder command line and the encoder
+binary itself. Cache hits are copied straight out of the cache directory, so
+segments whose bytes did not change are never recompressed, even after a
+`make clean`.
+
+The encoder command is given after `--`. `{in}` and `{out}` are replaced with
+the input and output paths. If the command has no `{out}`, its stdout is used
+as the output (for `gzip -c`).
+
+Single file (used by the *rules.mk files, make -j runs these in parallel):
+    compress_cache.py -d .compress_cache -l build/compress.log in.bin out.szp -- tools/rncpack p {in} {out} -m1
+
+Batch (compresses every cache miss on a pool of worker threads):
+    compress_cache.py -d .compress_cache -j 8 --batch list.txt -- tools/mio0 {in} {out}
+    where list.txt contains one "<input> <output>" pair per line.
+
+Report and prune (called at the end of a build):
+    compress_cache.py -d .compress_cache -l build/compress.log --report --max-size 512
+"""
+
+import argparse
+import hashlib
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+CACHE_VERSION = b"compress_cache v1\0"
+
+encoder_hashes = {}
+
+
+def hash_file(path):
+    h = hashlib.sha1()
+    with open(path, "rb") as f:
+        for block in iter(lambda: f.read(1 << 16), b""):
+            h.update(block)
+    return h.digest()
+
+
+def encoder_hash(exe):
+    # Hash the encoder binary so rebuilding a tool with different output invalidates its entries.
+    if exe not in encoder_hashes:
+        path = exe if os.path.sep in exe else shutil.which(exe)
+        encoder_hashes[exe] = hash_file(path) if path and os.path.isfile(path) else exe.encode()
+    return encoder_hashes[exe]
+
+
+def cache_key(cmd, in_path):
+    h = hashlib.sha1(CACHE_VERSION)
+    h.update(encoder_hash(cmd[0]))
+    h.update("\0".join(cmd).encode())
+    h.update(b"\0")
+    h.update(hash_file(in_path))
+    return h.hexdigest()
+
+
+def cache_path(cache_dir, key):
+    return os.path.join(cache_dir, key[:2], key)
+
+
+def atomic_copy(src, dst):
+    out_dir = os.path.dirname(dst) or "."
+    os.makedirs(out_dir, exist_ok=True)
+    fd, tmp = tempfile.mkstemp(dir=out_dir, prefix=".tmp-")
+    os.close(fd)
+    try:
+        shutil.copyfile(src, tmp)
+        os.replace(tmp, dst)
+    except BaseException:
+        os.unlink(tmp)
+        raise
+
+
+def run_encoder(cmd, in_path, out_path):
+    args = [a.replace("{in}", in_path).replace("{out}", out_path) for a in cmd]
+    if any("{out}" in a for a in cmd):
+        subprocess.run(args, check=True)
+    else:
+        with open(out_path, "wb") as f:
+            subprocess.run(args, check=True, stdout=f)
+
+
+def log_result(log_path, line):
+    if log_path is None:
+        return
+    # O_APPEND writes this small are atomic, so parallel make jobs can share the log.
+    fd = os.open(log_path, os.O_WRONLY | os.O_APPEND | os.O_CREAT, 0o644)
+    try:
+        os.write(fd, (line + "\n").encode())
+    finally:
+        os.close(fd)
+
+
+def compress_one(cache_dir, log_path, cmd, in_path, out_path):
+    key = cache_key(cmd, in_path)
+    entry = cache_path(cache_dir, key)
+
+    if os.path.isfile(entry):
+        atomic_copy(entry, out_path)
+        os.utime(entry)
+        log_result(log_path, "hit %s" % in_path)
+        return True
+
+    start = time.monotonic()
+    run_encoder(cmd, in_path, out_path)
+    elapsed = time.monotonic() - start
+
+    os.makedirs(os.path.dirname(entry), exist_ok=True)
+    atomic_copy(out_path, entry)
+    log_result(log_path, "miss %s %.3f" % (in_path, elapsed))
+    return False
+
+
+def read_batch(list_path):
+    pairs = []
+    with open(list_path) as f:
+        for line in f:
+            tokens = line.split()
+            if len(tokens) == 2:
+                pairs.append(tokens)
+            elif tokens:
+                sys.exit("%s: expected '<input> <output>', got: %s" % (list_path, line.strip()))
+    return pairs
+
+
+def compress_batch(cache_dir, log_path, cmd, pairs, jobs):
+    # The encoders are separate processes, so threads are enough to keep every core busy.
+    with ThreadPoolExecutor(max_workers=jobs) as pool:
+        futures = [pool.submit(compress_one, cache_dir, log_path, cmd, i, o) for i, o in pairs]
+        hits = sum(1 for f in futures if f.result())
+    print("Compressed %d files: %d cache hits, %d misses" % (len(pairs), hits, len(pairs) - hits))
+
+
+def prune(cache_dir, max_bytes):
+    entries = []
+    for root, _, files in os.walk(cache_dir):
+        for name in files:
+            path = os.path.join(root, name)
+            st = os.stat(path)
+            entries.append((st.st_mtime, st.st_size, path))
+
+    total = sum(e[1] for e in entries)
+    removed = 0
+    # Hits refresh the mtime, so the oldest entries are the least recently used ones.
+    for _, size, path in sorted(entries):
+        if total <= max_bytes:
+            break
+        os.unlink(path)
+        total -= size
+        removed += 1
+    return removed
+
+
+def report(cache_dir, log_path, max_mb):
+    hits = misses = 0
+    miss_time = 0.0
+    if log_path is not None and os.path.isfile(log_path):
+        with open(log_path) as f:
+            for line in f:
+                tokens = line.split()
+                if not tokens:
+                    continue
+                if tokens[0] == "hit":
+                    hits += 1
+                elif tokens[0] == "miss":
+                    misses += 1
+                    miss_time += float(tokens[2])
+        os.unlink(log_path)
+
+    total = hits + misses
+    if total > 0:
+        print("Compression cache: %d/%d hits (%.1f%%), %d recompressed in %.2fs of encoder time"
+              % (hits, total, 100.0 * hits / total, misses, miss_time))
+
+    if max_mb > 0 and os.path.isdir(cache_dir):
+        removed = prune(cache_dir, max_mb * 1024 * 1024)
+        if removed > 0:
+            print("Compression cache: pruned %d old entries" % removed)
+
+
+def main():
+    argv = sys.argv[1:]
+    cmd = []
+    if "--" in argv:
+        split = argv.index("--")
+        argv, cmd = argv[:split], argv[split + 1:]
+
+    parser = argparse.ArgumentParser(description="Content-addressed cache for compressed segments.",
+                                     usage="%(prog)s [options] [<input> <output>] -- <encoder command>")
+    parser.add_argument("-d", "--cache-dir", default=".compress_cache", help="cache directory")
+    parser.add_argument("-l", "--log", help="append hit/miss records to this file")
+    parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count() or 1, help="worker threads for --batch")
+    parser.add_argument("--batch", metavar="LIST", help="file with one '<input> <output>' pair per line")
+    parser.add_argument("--report", action="store_true", help="print and clear the hit rate from --log")
+    parser.add_argument("--max-size", type=int, default=0, metavar="MB", help="with --report, prune the cache to this size")
+    parser.add_argument("files", nargs="*")
+    args = parser.parse_args(argv)
+
+    if args.report:
+        report(args.cache_dir, args.log, args.max_size)
+        return
+
+    if not cmd:
+        parser.error("missing encoder command after --")
+    if not any("{in}" in a for a in cmd):
+        parser.error("encoder command must contain {in}")
+
+    try:
+        if args.batch is not None:
+            compress_batch(args.cache_dir, args.log, cmd, read_batch(args.batch), max(args.jobs, 1))
+        elif len(args.files) == 2:
+            compress_one(args.cache_dir, args.log, cmd, args.files[0], args.files[1])
+        else:
+            parser.error("expected <input> <output> or --batch")
+    except subprocess.CalledProcessError as e:
+        sys.exit("compress_cache: encoder failed with exit code %d: %s" % (e.returncode, " ".join(e.cmd)))
+
+
+if __name__ == "__main__":
+    main()
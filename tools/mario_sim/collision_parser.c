@@ -0,0 +1,335 @@
+/**
+ * Reads a collision array written with the COL_* macros from surface_terrains.h
+ * (levels/<level>/areas/<n>/collision.inc.c) and expands it into the same
+ * TerrainData stream the compiler would have produced, so it can be handed to
+ * load_area_terrain without building the level.
+ *
+ * Special objects are skipped: the harness has no objects to spawn, and leaving
+ * out the TERRAIN_LOAD_OBJECTS section keeps spawn_special_objects from running.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ultra64.h>
+
+#include "surface_terrains.h"
+
+#include "collision_parser.h"
+
+#define MAX_MACRO_ARGS 8
+
+struct SurfaceName {
+    const char *name;
+    s32 value;
+};
+
+// Generated from the SurfaceTypes enum by the Makefile.
+static const struct SurfaceName sSurfaceNames[] = {
+#include "surface_names.inc.c"
+};
+
+struct TerrainBuffer {
+    TerrainData *data;
+    s32 count;
+    s32 capacity;
+};
+
+static const char *sPath;
+static s32 sLine;
+
+static void parse_error(const char *fmt, const char *arg) {
+    fprintf(stderr, "mario_sim: %s:%d: ", sPath, sLine);
+    fprintf(stderr, fmt, arg);
+    fputc('\n', stderr);
+    exit(1);
+}
+
+static void push(struct TerrainBuffer *buf, s32 value) {
+    if (buf->count == buf->capacity) {
+        buf->capacity = (buf->capacity == 0) ? 0x1000 : buf->capacity * 2;
+        buf->data = realloc(buf->data, buf->capacity * sizeof(TerrainData));
+        if (buf->data == NULL) {
+            parse_error("%s", "out of memory");
+        }
+    }
+    buf->data[buf->count++] = value;
+}
+
+/**
+ * Reads the whole file with comments replaced by spaces. Newlines are kept so
+ * that errors can report the line.
+ */
+static char *read_source(const char *path) {
+    FILE *f = fopen(path, "rb");
+    char *src, *p;
+    long size;
+
+    if (f == NULL) {
+        fprintf(stderr, "mario_sim: can't open %s\n", path);
+        exit(1);
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    src = malloc(size + 1);
+    if (src == NULL || fread(src, 1, size, f) != (size_t) size) {
+        fprintf(stderr, "mario_sim: can't read %s\n", path);
+        exit(1);
+    }
+    src[size] = '\0';
+    fclose(f);
+
+    for (p = src; *p != '\0'; p++) {
+        if (p[0] == '/' && p[1] == '/') {
+            while (*p != '\0' && *p != '\n') {
+                *p++ = ' ';
+            }
+            if (*p == '\0') {
+                break;
+            }
+        } else if (p[0] == '/' && p[1] == '*') {
+            while (*p != '\0' && !(p[0] == '*' && p[1] == '/')) {
+                if (*p != '\n') {
+                    *p = ' ';
+                }
+                p++;
+            }
+            if (*p == '\0') {
+                break;
+            }
+            p[0] = p[1] = ' ';
+            p++;
+        }
+    }
+    return src;
+}
+
+static char *skip_space(char *p) {
+    while (isspace((unsigned char) *p)) {
+        if (*p == '\n') {
+            sLine++;
+        }
+        p++;
+    }
+    return p;
+}
+
+static s32 count_lines(const char *start, const char *end) {
+    s32 lines = 0;
+
+    while (start < end) {
+        if (*start++ == '\n') {
+            lines++;
+        }
+    }
+    return lines;
+}
+
+/**
+ * Finds the opening brace of the array, either the one with the given name or
+ * the first Collision array in the file.
+ */
+static char *find_array(char *src, const char *arrayName) {
+    char *p = src;
+
+    while ((p = strstr(p, "Collision")) != NULL) {
+        char *name, *end;
+
+        p = skip_space(p + strlen("Collision"));
+        name = p;
+        while (isalnum((unsigned char) *p) || *p == '_') {
+            p++;
+        }
+        end = p;
+        if (end == name || *skip_space(p) != '[') {
+            continue;
+        }
+        if (arrayName == NULL || ((size_t)(end - name) == strlen(arrayName)
+                                  && strncmp(name, arrayName, end - name) == 0)) {
+            p = strchr(p, '{');
+            if (p != NULL) {
+                sLine = 1 + count_lines(src, p);
+            }
+            return p;
+        }
+    }
+    return NULL;
+}
+
+static s32 parse_value(char *arg) {
+    char *end;
+    s32 value;
+    u32 i;
+
+    while (isspace((unsigned char) *arg)) {
+        arg++;
+    }
+    end = arg + strlen(arg);
+    while (end > arg && isspace((unsigned char) end[-1])) {
+        *--end = '\0';
+    }
+
+    if (isalpha((unsigned char) *arg) || *arg == '_') {
+        for (i = 0; i < ARRAY_COUNT(sSurfaceNames); i++) {
+            if (strcmp(sSurfaceNames[i].name, arg) == 0) {
+                return sSurfaceNames[i].value;
+            }
+        }
+        parse_error("unknown name '%s'", arg);
+    }
+
+    value = strtol(arg, &end, 0);
+    if (end == arg || *end != '\0') {
+        parse_error("can't parse '%s'", arg);
+    }
+    return value;
+}
+
+/**
+ * Splits "a, b, c)" into arguments, returning the number found. The text is
+ * modified in place and *pp is moved past the closing parenthesis.
+ */
+static s32 split_args(char **pp, char **args) {
+    char *p = *pp;
+    s32 numArgs = 0;
+
+    p = skip_space(p);
+    if (*p == ')') {
+        *pp = p + 1;
+        return 0;
+    }
+    while (TRUE) {
+        if (numArgs == MAX_MACRO_ARGS) {
+            parse_error("%s", "too many arguments");
+        }
+        args[numArgs++] = p;
+        while (*p != ',' && *p != ')') {
+            if (*p == '\0') {
+                parse_error("%s", "unterminated macro");
+            }
+            if (*p == '\n') {
+                sLine++;
+            }
+            p++;
+        }
+        if (*p == ')') {
+            *p = '\0';
+            *pp = p + 1;
+            return numArgs;
+        }
+        *p++ = '\0';
+    }
+}
+
+static void push_args(struct TerrainBuffer *buf, char **args, s32 numArgs) {
+    s32 i;
+
+    for (i = 0; i < numArgs; i++) {
+        push(buf, parse_value(args[i]));
+    }
+}
+
+TerrainData *parse_collision_file(const char *path, const char *arrayName, struct CollisionStats *stats) {
+    struct TerrainBuffer buf = { NULL, 0, 0 };
+    char *args[MAX_MACRO_ARGS];
+    char *src = read_source(path);
+    char *p;
+    s32 numArgs;
+
+    sPath = path;
+    bzero(stats, sizeof(*stats));
+
+    p = find_array(src, arrayName);
+    if (p == NULL) {
+        parse_error("no collision array '%s'", (arrayName != NULL) ? arrayName : "");
+    }
+    p++;
+
+    while (TRUE) {
+        char *name, *nameEnd;
+
+        p = skip_space(p);
+        while (*p == ',') {
+            p = skip_space(p + 1);
+        }
+        if (*p == '}' || *p == '\0') {
+            parse_error("%s", "array ended without COL_END()");
+        }
+
+        name = p;
+        while (isalnum((unsigned char) *p) || *p == '_') {
+            p++;
+        }
+        nameEnd = p;
+        if (name == nameEnd) {
+            parse_error("unexpected '%.1s'", p);
+        }
+        p = skip_space(p);
+        if (*p != '(') {
+            *nameEnd = '\0';
+            parse_error("expected a macro, got '%s'", name);
+        }
+        *nameEnd = '\0';
+        p++;
+        numArgs = split_args(&p, args);
+
+#define EXPECT_ARGS(n)                                                \
+    if (numArgs != (n)) {                                             \
+        parse_error("wrong number of arguments to %s", name);         \
+    }
+
+        if (strcmp(name, "COL_INIT") == 0) {
+            EXPECT_ARGS(0);
+            push(&buf, TERRAIN_LOAD_VERTICES);
+        } else if (strcmp(name, "COL_VERTEX_INIT") == 0) {
+            EXPECT_ARGS(1);
+            push_args(&buf, args, numArgs);
+        } else if (strcmp(name, "COL_VERTEX") == 0) {
+            EXPECT_ARGS(3);
+            push_args(&buf, args, numArgs);
+            stats->numVertices++;
+        } else if (strcmp(name, "COL_TRI_INIT") == 0) {
+            EXPECT_ARGS(2);
+            push_args(&buf, args, numArgs);
+        } else if (strcmp(name, "COL_TRI") == 0) {
+            EXPECT_ARGS(3);
+            push_args(&buf, args, numArgs);
+#ifdef ALL_SURFACES_HAVE_FORCE
+            push(&buf, 0);
+#endif
+            stats->numTris++;
+        } else if (strcmp(name, "COL_TRI_SPECIAL") == 0) {
+            EXPECT_ARGS(4);
+            push_args(&buf, args, numArgs);
+            stats->numTris++;
+        } else if (strcmp(name, "COL_TRI_STOP") == 0) {
+            EXPECT_ARGS(0);
+            push(&buf, TERRAIN_LOAD_CONTINUE);
+        } else if (strcmp(name, "COL_END") == 0) {
+            EXPECT_ARGS(0);
+            push(&buf, TERRAIN_LOAD_END);
+            break;
+        } else if (strcmp(name, "COL_SPECIAL_INIT") == 0) {
+            EXPECT_ARGS(1);
+        } else if (strncmp(name, "SPECIAL_OBJECT", strlen("SPECIAL_OBJECT")) == 0) {
+            stats->numSpecialObjects++;
+        } else if (strcmp(name, "COL_WATER_BOX_INIT") == 0) {
+            EXPECT_ARGS(1);
+            push(&buf, TERRAIN_LOAD_ENVIRONMENT);
+            push_args(&buf, args, numArgs);
+        } else if (strcmp(name, "COL_WATER_BOX") == 0) {
+            EXPECT_ARGS(6);
+            push_args(&buf, args, numArgs);
+            stats->numWaterBoxes++;
+        } else {
+            parse_error("unknown macro %s", name);
+        }
+#undef EXPECT_ARGS
+    }
+
+    free(src);
+    return buf.data;
+}
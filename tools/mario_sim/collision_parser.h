@@ -0,0 +1,17 @@
+#ifndef COLLISION_PARSER_H
+#define COLLISION_PARSER_H
+
+#include <PR/ultratypes.h>
+
+#include "types.h"
+
+struct CollisionStats {
+    s32 numVertices;
+    s32 numTris;
+    s32 numWaterBoxes;
+    s32 numSpecialObjects; // Parsed but not loaded
+};
+
+TerrainData *parse_collision_file(const char *path, const char *arrayName, struct CollisionStats *stats);
+
+#endif // COLLISION_PARSER_H
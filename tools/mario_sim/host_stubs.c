@@ -0,0 +1,442 @@
+/**
+ * Host replacements for everything Mario's movement code links against apart
+ * from the engine itself. Objects, interactions, the camera, dialogs, audio
+ * and saving are not simulated: spawned objects are scratch structs that are
+ * never updated, and queries about other objects report that there are none.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ultra64.h>
+
+#include "types.h"
+#include "behavior_data.h"
+#include "dialog_ids.h"
+#include "audio/data.h"
+#include "audio/external.h"
+#include "engine/geo_layout.h"
+#include "engine/math_util.h"
+#include "engine/surface_load.h"
+#include "game/area.h"
+#include "game/behavior_actions.h"
+#include "game/camera.h"
+#include "game/game_init.h"
+#include "game/ingame_menu.h"
+#include "game/interaction.h"
+#include "game/level_update.h"
+#include "game/macro_special_objects.h"
+#include "game/main.h"
+#include "game/mario_misc.h"
+#include "game/memory.h"
+#include "game/moving_texture.h"
+#include "game/object_helpers.h"
+#include "game/object_list_processor.h"
+#include "game/save_file.h"
+#include "game/sound_init.h"
+#include "game/spawn_object.h"
+
+#include "host_stubs.h"
+
+// Only the addresses of the behaviors are compared.
+const BehaviorScript bhvBowserKeyCourseExit[1], bhvBowserKeyUnlockDoor[1], bhvCelebrationStar[1], bhvDddWarp[1],
+    bhvEndPeach[1], bhvEndToad[1], bhvGiantPole[1], bhvJumpingBox[1], bhvKoopaShellUnderwater[1],
+    bhvNormalCap[1], bhvSparkleSpawn[1], bhvStaticObject[1], bhvTree[1], bhvUnlockDoorStar[1];
+
+struct MarioState gMarioStates[1];
+struct MarioState *gMarioState = &gMarioStates[0];
+struct Object *gMarioObject;
+struct Object *gCurrentObject;
+struct Area *gCurrentArea;
+struct SpawnInfo *gMarioSpawnInfo;
+struct SpawnInfo gPlayerSpawnInfos[1];
+struct PlayerCameraState gPlayerCameraState[2];
+struct MarioBodyState gBodyStates[2];
+struct Controller gControllers[3];
+struct Controller *gPlayer1Controller = &gControllers[0];
+struct DmaHandlerList gMarioAnimsBuf;
+struct HudDisplay gHudDisplay;
+struct CreditsEntry *gCurrCreditsEntry;
+struct Camera *gCamera;
+struct LakituState gLakituState;
+struct Object *gCutsceneFocus;
+struct GraphNode gObjParentGraphNode;
+struct NumTimesCalled gNumCalls;
+
+TerrainData *gEnvironmentRegions;
+s32 gEnvironmentLevels[20];
+s32 gSurfacesAllocated;
+s32 gSurfaceNodesAllocated;
+s32 gNumStaticSurfaces;
+s32 gNumStaticSurfaceNodes;
+s32 gNumFindFloorMisses;
+s16 gCollisionFlags;
+u32 gTimeStopState;
+s16 gCCMEnteredSlide;
+
+u32 gGlobalTimer;
+u16 gAreaUpdateCounter;
+u32 gAudioRandom;
+f32 gGlobalSoundSource[3];
+s16 gCameraMovementFlags;
+s16 gCurrLevelNum = LEVEL_BOB;
+s16 gCurrSaveFileNum = 1;
+s16 gSaveOptSelectIndex;
+s32 gDialogResponse;
+s8 gDebugLevelSelect;
+s8 gNeverEnteredCastle;
+u8 gLastCompletedCourseNum;
+u8 gLastCompletedStarNum;
+u8 gSpecialTripleJump;
+f32 gPaintingMarioYEntry;
+
+struct HostCounters gHostCounters;
+
+#define NUM_SCRATCH_OBJECTS 16
+
+static struct Object sScratchObjects[NUM_SCRATCH_OBJECTS];
+static s32 sNextScratchObject;
+
+/**
+ * Callers of spawn_object may write to the result, so hand out cleared scratch
+ * objects. They are recycled, the harness never runs their behaviors.
+ */
+static struct Object *scratch_object(void) {
+    struct Object *obj = &sScratchObjects[sNextScratchObject];
+
+    sNextScratchObject = (sNextScratchObject + 1) % NUM_SCRATCH_OBJECTS;
+    bzero(obj, sizeof(*obj));
+    obj->activeFlags = ACTIVE_FLAG_ACTIVE;
+    gHostCounters.spawnedObjects++;
+    return obj;
+}
+
+void *main_pool_alloc(u32 size, UNUSED u32 side) {
+    void *ptr = calloc(1, size);
+
+    if (ptr == NULL) {
+        fprintf(stderr, "mario_sim: out of memory\n");
+        exit(1);
+    }
+    return ptr;
+}
+
+void *alloc_only_pool_alloc(UNUSED struct AllocOnlyPool *pool, s32 size) {
+    return main_pool_alloc(size, MEMORY_POOL_LEFT);
+}
+
+void *segmented_to_virtual(const void *addr) {
+    return (void *) addr;
+}
+
+void *virtual_to_segmented(UNUSED u32 segment, const void *addr) {
+    return (void *) addr;
+}
+
+/**
+ * The animation table is linked into the binary, so "DMA" is a copy into the
+ * animation buffer, the same as load_patchable_table does on console.
+ */
+void setup_dma_table_list(struct DmaHandlerList *list, void *srcAddr, void *buffer) {
+    struct DmaTable *src = srcAddr;
+    u32 size = src->count * sizeof(struct OffsetSizePair) + sizeof(struct DmaTable) - sizeof(struct OffsetSizePair);
+
+    list->dmaTable = main_pool_alloc(size, MEMORY_POOL_LEFT);
+    memcpy(list->dmaTable, src, size);
+    list->dmaTable->srcAddr = srcAddr;
+    list->currentAddr = NULL;
+    list->bufTarget = buffer;
+}
+
+s32 load_patchable_table(struct DmaHandlerList *list, s32 index) {
+    struct DmaTable *table = list->dmaTable;
+
+    if ((u32) index < table->count) {
+        u8 *addr = table->srcAddr + table->anim[index].offset;
+        s32 size = table->anim[index].size;
+
+        if (list->currentAddr != addr) {
+            memcpy(list->bufTarget, addr, size);
+            list->currentAddr = addr;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+// Objects
+
+struct Object *spawn_object(UNUSED struct Object *parent, UNUSED ModelID32 model,
+                            UNUSED const BehaviorScript *behavior) {
+    return scratch_object();
+}
+
+struct Object *spawn_object_abs_with_rot(UNUSED struct Object *parent, UNUSED s16 uselessArg,
+                                         UNUSED ModelID32 model, UNUSED const BehaviorScript *behavior,
+                                         UNUSED s16 x, UNUSED s16 y, UNUSED s16 z, UNUSED s16 rx,
+                                         UNUSED s16 ry, UNUSED s16 rz) {
+    return scratch_object();
+}
+
+void spawn_special_objects(UNUSED s32 areaIndex, UNUSED TerrainData **specialObjList) {
+    // The collision parser never emits TERRAIN_LOAD_OBJECTS.
+}
+
+u32 get_special_objects_size(UNUSED s16 *data) {
+    return 0;
+}
+
+void spawn_macro_objects(UNUSED s32 areaIndex, UNUSED MacroObject *macroObjList) {
+}
+
+void spawn_macro_objects_hardcoded(UNUSED s32 areaIndex, UNUSED MacroObject *macroObjList) {
+}
+
+void spawn_wind_particles(UNUSED s16 pitch, UNUSED s16 yaw) {
+}
+
+void obj_mark_for_deletion(struct Object *obj) {
+    obj->activeFlags = ACTIVE_FLAG_DEACTIVATED;
+}
+
+void obj_set_model(UNUSED struct Object *obj, UNUSED ModelID16 modelID) {
+}
+
+s32 obj_has_model(UNUSED struct Object *obj, UNUSED ModelID16 modelID) {
+    return FALSE;
+}
+
+void obj_scale(UNUSED struct Object *obj, UNUSED f32 scale) {
+}
+
+void obj_build_transform_from_pos_and_angle(UNUSED struct Object *obj, UNUSED s16 posIndex,
+                                            UNUSED s16 angleIndex) {
+}
+
+f32 dist_between_objects(struct Object *obj1, struct Object *obj2) {
+    f32 dx = obj1->oPosX - obj2->oPosX;
+    f32 dy = obj1->oPosY - obj2->oPosY;
+    f32 dz = obj1->oPosZ - obj2->oPosZ;
+
+    return sqrtf(dx * dx + dy * dy + dz * dz);
+}
+
+s32 cur_obj_check_if_near_animation_end(void) {
+    return TRUE;
+}
+
+void cur_obj_init_animation_with_sound(UNUSED s32 animIndex) {
+}
+
+void enable_time_stop(void) {
+    gTimeStopState |= TIME_STOP_ENABLED;
+}
+
+void disable_time_stop(void) {
+    gTimeStopState &= ~TIME_STOP_ENABLED;
+}
+
+void reset_red_coins_collected(void) {
+}
+
+// Interactions
+
+void mario_process_interactions(UNUSED struct MarioState *m) {
+}
+
+void mario_handle_special_floors(UNUSED struct MarioState *m) {
+}
+
+struct Object *mario_get_collided_object(UNUSED struct MarioState *m, UNUSED u32 interactType) {
+    return NULL;
+}
+
+u32 mario_check_object_grab(UNUSED struct MarioState *m) {
+    return FALSE;
+}
+
+void mario_grab_used_object(UNUSED struct MarioState *m) {
+}
+
+void mario_drop_held_object(struct MarioState *m) {
+    m->heldObj = NULL;
+}
+
+void mario_throw_held_object(struct MarioState *m) {
+    m->heldObj = NULL;
+}
+
+void mario_stop_riding_object(struct MarioState *m) {
+    m->riddenObj = NULL;
+}
+
+void mario_stop_riding_and_holding(struct MarioState *m) {
+    m->heldObj = NULL;
+    m->riddenObj = NULL;
+}
+
+void mario_blow_off_cap(struct MarioState *m, UNUSED f32 capSpeed) {
+    m->flags &= ~(MARIO_NORMAL_CAP | MARIO_CAP_IN_HAND | MARIO_CAP_ON_HEAD);
+}
+
+s16 mario_obj_angle_to_object(struct MarioState *m, struct Object *obj) {
+    return atan2s(obj->oPosZ - m->pos[2], obj->oPosX - m->pos[0]);
+}
+
+u32 get_door_save_file_flag(UNUSED struct Object *door) {
+    return 0;
+}
+
+// Level, camera and menus
+
+s16 level_trigger_warp(UNUSED struct MarioState *m, UNUSED s32 warpOp) {
+    gHostCounters.warps++;
+    return 0;
+}
+
+void fade_into_special_warp(UNUSED u32 arg, UNUSED u32 color) {
+    gHostCounters.warps++;
+}
+
+void play_transition(UNUSED s16 transType, UNUSED s16 time, UNUSED u8 red, UNUSED u8 green, UNUSED u8 blue) {
+}
+
+void load_level_init_text(UNUSED u32 arg) {
+}
+
+void set_camera_mode(UNUSED struct Camera *c, UNUSED s16 mode, UNUSED s16 frames) {
+}
+
+void set_camera_shake_from_hit(UNUSED s16 shake) {
+}
+
+f32 camera_approach_f32_symmetric(f32 value, f32 target, f32 increment) {
+    if (value < target) {
+        return MIN(value + ABS(increment), target);
+    }
+    return MAX(value - ABS(increment), target);
+}
+
+void override_viewport_and_clip(UNUSED Vp *a, UNUSED Vp *b, UNUSED u8 c, UNUSED u8 d, UNUSED u8 e) {
+}
+
+void trigger_cutscene_dialog(UNUSED s32 trigger) {
+}
+
+void set_cutscene_message(UNUSED s16 xOffset, UNUSED s16 yOffset, UNUSED s16 msgIndex, UNUSED s16 msgDuration) {
+}
+
+void reset_cutscene_msg_fade(void) {
+}
+
+void dl_rgba16_begin_cutscene_msg_fade(void) {
+}
+
+void dl_rgba16_stop_cutscene_msg_fade(void) {
+}
+
+void print_credits_str_ascii(UNUSED s16 x, UNUSED s16 y, UNUSED const char *str) {
+}
+
+void create_dialog_box(UNUSED s16 dialog) {
+}
+
+void create_dialog_box_with_var(UNUSED s16 dialog, UNUSED s32 dialogVar) {
+}
+
+void create_dialog_inverted_box(UNUSED s16 dialog) {
+}
+
+void create_dialog_box_with_response(UNUSED s16 dialog) {
+}
+
+s32 get_dialog_id(void) {
+    return DIALOG_NONE;
+}
+
+void set_menu_mode(UNUSED s16 mode) {
+}
+
+// Saving
+
+u32 save_file_get_flags(void) {
+    return 0;
+}
+
+void save_file_set_flags(UNUSED u32 flags) {
+}
+
+void save_file_clear_flags(UNUSED u32 flags) {
+}
+
+void save_file_do_save(UNUSED s32 fileIndex) {
+}
+
+s32 save_file_get_cap_pos(UNUSED Vec3s capPos) {
+    return FALSE;
+}
+
+s32 save_file_get_total_star_count(UNUSED s32 fileIndex, UNUSED s32 minCourse, UNUSED s32 maxCourse) {
+    return 0;
+}
+
+// Audio
+
+void play_sound(UNUSED s32 soundBits, UNUSED f32 *pos) {
+    gHostCounters.sounds++;
+}
+
+void stop_sound(UNUSED u32 soundBits, UNUSED f32 *pos) {
+}
+
+void set_sound_moving_speed(UNUSED u8 bank, UNUSED u8 speed) {
+}
+
+void sound_banks_enable(UNUSED u8 player, UNUSED u16 bankMask) {
+}
+
+void play_music(UNUSED u8 player, UNUSED u16 seqArgs, UNUSED u16 fadeTimer) {
+}
+
+void seq_player_lower_volume(UNUSED u8 player, UNUSED u16 fadeDuration, UNUSED u8 percentage) {
+}
+
+void seq_player_unlower_volume(UNUSED u8 player, UNUSED u16 fadeDuration) {
+}
+
+void play_course_clear(UNUSED s32 isKey) {
+}
+
+void play_peachs_jingle(void) {
+}
+
+void play_cutscene_music(UNUSED u16 seqArgs) {
+}
+
+void play_shell_music(void) {
+}
+
+void stop_shell_music(void) {
+}
+
+void fadeout_cap_music(void) {
+}
+
+void stop_cap_music(void) {
+}
+
+void play_infinite_stairs_music(void) {
+}
+
+void raise_background_noise(UNUSED s32 a) {
+}
+
+void lower_background_noise(UNUSED s32 a) {
+}
+
+void enable_background_sound(void) {
+}
+
+void disable_background_sound(void) {
+}
@@ -0,0 +1,15 @@
+#ifndef HOST_STUBS_H
+#define HOST_STUBS_H
+
+#include <PR/ultratypes.h>
+
+// Things the stubs saw happen, reset by the harness every frame.
+struct HostCounters {
+    u32 sounds;
+    u32 spawnedObjects;
+    u32 warps;
+};
+
+extern struct HostCounters gHostCounters;
+
+#endif // HOST_STUBS_H
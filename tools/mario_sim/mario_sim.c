@@ -0,0 +1,403 @@
+/**
+ * mario_sim: runs Mario's movement code (mario.c, mario_step.c, the
+ * mario_actions_*.c files) headless on the host against a level's static
+ * collision, optionally driven by a demo input file. Every frame it counts the
+ * floor/ceiling/wall queries and the ground and air quarter steps, and it
+ * folds Mario's state into a hash, so a run can be used both as a benchmark for
+ * the collision code and as a check that a change did not alter movement.
+ *
+ * Objects, interactions, the camera and audio are stubbed (see host_stubs.c).
+ * The camera faces along the start yaw for the whole run, so stick up always
+ * moves Mario that way.
+ *
+ * Build with `make mario-sim`.
+ *
+ * Usage: mario_sim [options] <collision.inc.c>
+ *   -a <name>        collision array to load (default: the first in the file)
+ *   -d <demo.bin>    demo inputs, in the format of the files in assets/demos
+ *   -n <frames>      number of 30 Hz frames to run (default: the length of
+ *                    the demo, or 300 without one)
+ *   -p <x,y,z>       start position (default: the highest floor at 0,0)
+ *   -y <yaw>         start yaw
+ *   -c <file.csv>    write per frame statistics
+ *   -q               only print the summary line
+ */
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <ultra64.h>
+
+#include "sm64.h"
+#include "engine/graph_node.h"
+#include "engine/math_util.h"
+#include "engine/surface_collision.h"
+#include "engine/surface_load.h"
+#include "game/area.h"
+#include "game/camera.h"
+#include "game/game_init.h"
+#include "game/level_update.h"
+#include "game/mario.h"
+#include "game/memory.h"
+#include "game/object_list_processor.h"
+
+#include "collision_parser.h"
+#include "host_stubs.h"
+
+#define DEFAULT_FRAMES 300
+
+struct FrameStats {
+    u32 floorQueries;
+    u32 ceilQueries;
+    u32 wallQueries;
+    u32 sweepQueries;
+    u32 groundSteps;
+    u32 airSteps;
+    u64 ns;
+};
+
+// Generated by mario_anims_converter.py.
+extern u8 gMarioAnims[];
+
+static struct Object sMarioObject;
+static struct Area sArea;
+static struct Camera sCamera;
+static struct SpawnInfo sSpawnInfo;
+static OSContPad sControllerPad;
+static u8 sMarioAnimsBuf[MARIO_ANIMS_POOL_SIZE];
+
+static struct DemoInput *sDemo;
+static struct DemoInput *sCurrDemoInput;
+static u32 sDemoLength;
+
+static u64 sStateHash = 0xcbf29ce484222325ULL;
+
+static u64 time_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void hash_bytes(const void *data, size_t size) {
+    const u8 *bytes = data;
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        sStateHash = (sStateHash ^ bytes[i]) * 0x100000001b3ULL;
+    }
+}
+
+/**
+ * Folds everything the movement code decides about Mario into the running
+ * hash (FNV-1a), so any difference on any frame changes the result.
+ */
+static void hash_mario_state(struct MarioState *m) {
+    struct AnimInfo *animInfo = &m->marioObj->header.gfx.animInfo;
+
+    hash_bytes(m->pos, sizeof(m->pos));
+    hash_bytes(m->vel, sizeof(m->vel));
+    hash_bytes(&m->forwardVel, sizeof(m->forwardVel));
+    hash_bytes(m->faceAngle, sizeof(m->faceAngle));
+    hash_bytes(&m->action, sizeof(m->action));
+    hash_bytes(&m->actionState, sizeof(m->actionState));
+    hash_bytes(&m->actionTimer, sizeof(m->actionTimer));
+    hash_bytes(&animInfo->animID, sizeof(animInfo->animID));
+    hash_bytes(&animInfo->animFrame, sizeof(animInfo->animFrame));
+}
+
+static void load_demo(const char *path) {
+    FILE *f = fopen(path, "rb");
+    long size;
+
+    if (f == NULL) {
+        fprintf(stderr, "mario_sim: can't open %s\n", path);
+        exit(1);
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    // A terminating entry is appended in case the file lacks one.
+    sDemo = calloc(size / sizeof(struct DemoInput) + 1, sizeof(struct DemoInput));
+    if (sDemo == NULL || size < (long) sizeof(struct DemoInput)
+        || fread(sDemo, sizeof(struct DemoInput), size / sizeof(struct DemoInput), f)
+               != size / sizeof(struct DemoInput)) {
+        fprintf(stderr, "mario_sim: can't read %s\n", path);
+        exit(1);
+    }
+    fclose(f);
+
+    // The first entry holds the level the demo was recorded in, see run_demo_inputs.
+    sCurrDemoInput = &sDemo[1];
+    for (struct DemoInput *input = sCurrDemoInput; input->timer != 0; input++) {
+        sDemoLength += input->timer;
+    }
+}
+
+/**
+ * Copy of adjust_analog_stick in game_init.c, which can't be linked on its own.
+ */
+static void adjust_analog_stick(struct Controller *controller) {
+    controller->stickX = 0;
+    controller->stickY = 0;
+
+    if (controller->rawStickX <= -8) {
+        controller->stickX = controller->rawStickX + 6;
+    }
+    if (controller->rawStickX >= 8) {
+        controller->stickX = controller->rawStickX - 6;
+    }
+    if (controller->rawStickY <= -8) {
+        controller->stickY = controller->rawStickY + 6;
+    }
+    if (controller->rawStickY >= 8) {
+        controller->stickY = controller->rawStickY - 6;
+    }
+
+    controller->stickMag =
+        sqrtf(controller->stickX * controller->stickX + controller->stickY * controller->stickY);
+
+    if (controller->stickMag > 64) {
+        controller->stickX *= 64 / controller->stickMag;
+        controller->stickY *= 64 / controller->stickMag;
+        controller->stickMag = 64;
+    }
+}
+
+/**
+ * Same as run_demo_inputs followed by read_controller_inputs.
+ */
+static void update_controller(void) {
+    struct Controller *controller = &gControllers[0];
+
+    if (sCurrDemoInput != NULL && sCurrDemoInput->timer != 0) {
+        sControllerPad.stick_x = sCurrDemoInput->rawStickX;
+        sControllerPad.stick_y = sCurrDemoInput->rawStickY;
+        sControllerPad.button = ((sCurrDemoInput->buttonMask & 0xF0) << 8) + (sCurrDemoInput->buttonMask & 0xF);
+        if (--sCurrDemoInput->timer == 0) {
+            sCurrDemoInput++;
+        }
+    } else {
+        bzero(&sControllerPad, sizeof(sControllerPad));
+    }
+
+    controller->rawStickX = sControllerPad.stick_x;
+    controller->rawStickY = sControllerPad.stick_y;
+    controller->buttonPressed = sControllerPad.button & (sControllerPad.button ^ controller->buttonDown);
+    controller->buttonDown = sControllerPad.button;
+    adjust_analog_stick(controller);
+}
+
+/**
+ * The animation frame is normally advanced while rendering Mario, see
+ * geo_set_animation_globals.
+ */
+static void update_mario_animation(struct Object *obj) {
+    struct AnimInfo *animInfo = &obj->header.gfx.animInfo;
+
+    if (animInfo->curAnim != NULL) {
+        animInfo->animFrame = geo_update_animation_frame(animInfo, &animInfo->animFrameAccelAssist);
+    }
+    animInfo->animTimer = gAreaUpdateCounter;
+}
+
+static void init_level(const char *collisionPath, const char *arrayName, s32 quiet) {
+    struct CollisionStats stats;
+    TerrainData *data = parse_collision_file(collisionPath, arrayName, &stats);
+
+    alloc_surface_pools();
+    load_area_terrain(0, data, NULL, NULL);
+
+    if (!quiet) {
+        printf("collision:      %d vertices, %d triangles, %d water boxes (%d special objects skipped)\n",
+               stats.numVertices, stats.numTris, stats.numWaterBoxes, stats.numSpecialObjects);
+        printf("surfaces:       %d, %d nodes\n", gNumStaticSurfaces, gNumStaticSurfaceNodes);
+    }
+}
+
+static void init_mario_state(Vec3f startPos, s32 hasStartPos, s16 startYaw) {
+    struct Surface *floor;
+
+    if (!hasStartPos) {
+        startPos[0] = 0.0f;
+        startPos[2] = 0.0f;
+        startPos[1] = find_floor(0.0f, CELL_HEIGHT_LIMIT, 0.0f, &floor);
+        if (floor == NULL) {
+            fprintf(stderr, "mario_sim: no floor at 0,0, pass a start position with -p\n");
+            exit(1);
+        }
+    }
+
+    sCamera.yaw = startYaw + DEGREES(180);
+    sArea.camera = &sCamera;
+    gCurrentArea = &sArea;
+    gCamera = &sCamera;
+
+    vec3f_to_vec3s(sSpawnInfo.startPos, startPos);
+    vec3s_set(sSpawnInfo.startAngle, 0, startYaw, 0);
+    gMarioSpawnInfo = &sSpawnInfo;
+
+    sControllerPad.button = 0;
+    gControllers[0].controllerData = &sControllerPad;
+
+    sMarioObject.activeFlags = ACTIVE_FLAG_ACTIVE;
+    sMarioObject.header.gfx.node.flags = GRAPH_RENDER_ACTIVE;
+    gMarioObject = &sMarioObject;
+    gCurrentObject = &sMarioObject;
+
+    setup_dma_table_list(&gMarioAnimsBuf, gMarioAnims, sMarioAnimsBuf);
+    init_mario_from_save_file();
+    init_mario();
+
+    // Mario can't leave the spot without a floor, see update_mario_geometry_inputs.
+    if (gMarioState->floor == NULL) {
+        fprintf(stderr, "mario_sim: no floor below the start position\n");
+        exit(1);
+    }
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [-a array] [-d demo.bin] [-n frames] [-p x,y,z] [-y yaw] [-c stats.csv] [-q] <collision.inc.c>\n",
+            prog);
+    exit(1);
+}
+
+int main(int argc, char **argv) {
+    struct FrameStats frame, total, peak;
+    const char *arrayName = NULL;
+    const char *demoPath = NULL;
+    const char *csvPath = NULL;
+    FILE *csvFile = NULL;
+    Vec3f startPos = { 0.0f, 0.0f, 0.0f };
+    s32 hasStartPos = FALSE;
+    s16 startYaw = 0;
+    u32 numFrames = 0;
+    u32 actionChanges = 0;
+    u32 prevAction;
+    s32 quiet = FALSE;
+    u32 i;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "a:d:n:p:y:c:q")) != -1) {
+        switch (opt) {
+            case 'a': arrayName = optarg; break;
+            case 'd': demoPath = optarg; break;
+            case 'n': numFrames = strtoul(optarg, NULL, 0); break;
+            case 'p':
+                if (sscanf(optarg, "%f,%f,%f", &startPos[0], &startPos[1], &startPos[2]) != 3) {
+                    usage(argv[0]);
+                }
+                hasStartPos = TRUE;
+                break;
+            case 'y': startYaw = strtol(optarg, NULL, 0); break;
+            case 'c': csvPath = optarg; break;
+            case 'q': quiet = TRUE; break;
+            default: usage(argv[0]);
+        }
+    }
+    if (optind != argc - 1) {
+        usage(argv[0]);
+    }
+
+    if (demoPath != NULL) {
+        load_demo(demoPath);
+        if (numFrames == 0) {
+            numFrames = sDemoLength;
+        }
+    }
+    if (numFrames == 0) {
+        numFrames = DEFAULT_FRAMES;
+    }
+    if (csvPath != NULL) {
+        csvFile = fopen(csvPath, "w");
+        if (csvFile == NULL) {
+            fprintf(stderr, "mario_sim: can't create %s\n", csvPath);
+            return 1;
+        }
+        fprintf(csvFile, "frame,action,x,y,z,forward_vel,floor,ceil,wall,ground_steps,air_steps,us\n");
+    }
+
+    init_level(argv[optind], arrayName, quiet);
+    init_mario_state(startPos, hasStartPos, startYaw);
+    bzero(&total, sizeof(total));
+    bzero(&peak, sizeof(peak));
+    prevAction = gMarioState->action;
+
+    for (i = 0; i < numFrames; i++) {
+        u64 start;
+
+        bzero(&gNumCalls, sizeof(gNumCalls));
+        bzero(&gHostCounters, sizeof(gHostCounters));
+        update_controller();
+
+        start = time_ns();
+        execute_mario_action(gMarioObject);
+        frame.ns = time_ns() - start;
+
+        // Same order as the game loop: area update, then rendering.
+        gAreaUpdateCounter++;
+        gGlobalTimer++;
+        update_mario_animation(gMarioObject);
+        hash_mario_state(gMarioState);
+
+        frame.floorQueries = (u16) gNumCalls.floor;
+        frame.ceilQueries = (u16) gNumCalls.ceil;
+        frame.wallQueries = (u16) gNumCalls.wall;
+        frame.sweepQueries = (u16) gNumCalls.sweep;
+        frame.groundSteps = (u16) gNumCalls.groundQuarterSteps;
+        frame.airSteps = (u16) gNumCalls.airQuarterSteps;
+
+        total.floorQueries += frame.floorQueries;
+        total.ceilQueries += frame.ceilQueries;
+        total.wallQueries += frame.wallQueries;
+        total.sweepQueries += frame.sweepQueries;
+        total.groundSteps += frame.groundSteps;
+        total.airSteps += frame.airSteps;
+        total.ns += frame.ns;
+        peak.floorQueries = MAX(peak.floorQueries, frame.floorQueries);
+        peak.ceilQueries = MAX(peak.ceilQueries, frame.ceilQueries);
+        peak.wallQueries = MAX(peak.wallQueries, frame.wallQueries);
+        peak.sweepQueries = MAX(peak.sweepQueries, frame.sweepQueries);
+        peak.groundSteps = MAX(peak.groundSteps, frame.groundSteps);
+        peak.airSteps = MAX(peak.airSteps, frame.airSteps);
+        peak.ns = MAX(peak.ns, frame.ns);
+
+        if (gMarioState->action != prevAction) {
+            prevAction = gMarioState->action;
+            actionChanges++;
+        }
+
+        if (csvFile != NULL) {
+            fprintf(csvFile, "%u,0x%08x,%.3f,%.3f,%.3f,%.3f,%u,%u,%u,%u,%u,%.2f\n", i, gMarioState->action,
+                    gMarioState->pos[0], gMarioState->pos[1], gMarioState->pos[2], gMarioState->forwardVel,
+                    frame.floorQueries, frame.ceilQueries, frame.wallQueries, frame.groundSteps, frame.airSteps,
+                    frame.ns / 1000.0);
+        }
+    }
+
+    if (csvFile != NULL) {
+        fclose(csvFile);
+    }
+
+    if (!quiet) {
+        printf("frames:         %u, %u action changes\n", numFrames, actionChanges);
+        printf("final:          action 0x%08x pos %.3f %.3f %.3f fvel %.3f yaw 0x%04x\n", gMarioState->action,
+               gMarioState->pos[0], gMarioState->pos[1], gMarioState->pos[2], gMarioState->forwardVel,
+               (u16) gMarioState->faceAngle[1]);
+        printf("floor queries:  avg %.2f, max %u\n", (f64) total.floorQueries / numFrames, peak.floorQueries);
+        printf("ceil queries:   avg %.2f, max %u\n", (f64) total.ceilQueries / numFrames, peak.ceilQueries);
+        printf("wall queries:   avg %.2f, max %u\n", (f64) total.wallQueries / numFrames, peak.wallQueries);
+        printf("sweep queries:  avg %.2f, max %u\n", (f64) total.sweepQueries / numFrames, peak.sweepQueries);
+        printf("ground qsteps:  avg %.2f, max %u\n", (f64) total.groundSteps / numFrames, peak.groundSteps);
+        printf("air qsteps:     avg %.2f, max %u\n", (f64) total.airSteps / numFrames, peak.airSteps);
+        printf("mario update:   avg %.2f us, max %.2f us\n", total.ns / 1000.0 / numFrames, peak.ns / 1000.0);
+    }
+    printf("hash %016llx floor %u ceil %u wall %u steps %u us %.0f\n", (unsigned long long) sStateHash,
+           total.floorQueries, total.ceilQueries, total.wallQueries, total.groundSteps + total.airSteps,
+           total.ns / 1000.0);
+    return 0;
+}
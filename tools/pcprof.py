@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+# Turns the samples dumped by the PC_PROFILER puppyprint page into folded stacks for flamegraph.pl.
+#
+# usage: pcprof.py <log> <build/us_n64/sm64.us.map> [--flat]
+#
+# The log is the UNF or ISViewer output, and can hold several dumps; every sample between a
+# "PCPROF BEGIN" and "PCPROF END" line is counted. Each sample is folded as "caller;function",
+# where the caller comes from the game thread's ra register, so it is only right for leaf functions
+# and can repeat the function itself. Static functions aren't in the map and are counted under the
+# global symbol before them, the same as on the crash screen.
+
+import bisect, sys
+
+def read_map(path):
+	syms = []
+	with open(path) as f:
+		for line in f:
+			# Same filter as mapPacker.py
+			if "0x000000008" in line and "=" not in line and "." not in line and "*" not in line and "load address" not in line:
+				tokens = line.split()
+				syms.append((int(tokens[0], 16), tokens[1]))
+	syms.sort()
+	return [s[0] for s in syms], [s[1] for s in syms]
+
+def read_samples(path):
+	samples = []
+	inDump = False
+	with open(path, errors="replace") as f:
+		for line in f:
+			line = line.strip()
+			if line.startswith("PCPROF BEGIN"):
+				inDump = True
+			elif line.startswith("PCPROF END"):
+				inDump = False
+			elif inDump:
+				tokens = line.split()
+				if len(tokens) == 2:
+					samples.append((int(tokens[0], 16), int(tokens[1], 16)))
+	return samples
+
+def main():
+	args = [a for a in sys.argv[1:] if not a.startswith("--")]
+	if len(args) != 2:
+		print("usage: pcprof.py <log> <map> [--flat]", file=sys.stderr)
+		sys.exit(1)
+
+	addrs, names = read_map(args[1])
+
+	def symbolize(addr):
+		i = bisect.bisect_right(addrs, addr) - 1
+		if addr == 0 or i < 0 or i == len(addrs) - 1:
+			return None
+		return names[i]
+
+	counts = {}
+	for pc, ra in read_samples(args[0]):
+		func = symbolize(pc)
+		if pc == 0:
+			key = "[not running]"
+		elif func is None:
+			key = "[unknown]"
+		elif "--flat" in sys.argv:
+			key = func
+		else:
+			caller = symbolize(ra)
+			key = (caller + ";" + func) if caller is not None else func
+		counts[key] = counts.get(key, 0) + 1
+
+	for key, count in sorted(counts.items(), key=lambda x: -x[1]):
+		print("%s %d" % (key, count))
+
+main()
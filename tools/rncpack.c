@@ -2,14 +2,18 @@
 // Original repo: https://github.com/lab313ru/rnc_propack_source
 
 #include <errno.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #ifndef _WIN32
 #include <sys/stat.h>
+#include <unistd.h>
 #else
 #include <direct.h>
+#include <windows.h>
 #define mkdir(name, mode) mkdir(name)
 #endif
 
@@ -90,6 +94,16 @@ typedef struct vars_s {
     huftable_t raw_table[16];
     huftable_t pos_table[16];
     huftable_t len_table[16];
+
+    // multithreaded packing
+    uint32 threads;
+    uint32 dict_pos;
+    uint32 dict_log_base;
+    uint32 *dict_log;
+    struct spec_s *spec;
+    uint32 spec_reused;
+    uint32 spec_searched;
+    double spec_time;
 } vars_t;
 
 #define RNC_SIGN 0x524E43 // RNC
@@ -245,6 +259,15 @@ vars_t *init_vars()
     v->output_offset = 0;
     v->temp_offset = 0;
 
+    v->threads = 0;
+    v->dict_pos = 0;
+    v->dict_log_base = 0;
+    v->dict_log = NULL;
+    v->spec = NULL;
+    v->spec_reused = 0;
+    v->spec_searched = 0;
+    v->spec_time = 0;
+
     memset(v->tmp_crc_data, 0, sizeof(v->tmp_crc_data));
     memset(v->raw_table, 0, sizeof(v->raw_table));
     memset(v->pos_table, 0, sizeof(v->pos_table));
@@ -511,6 +534,18 @@ void update_bits_table(vars_t *v, huftable_t *data, uint16 bits)
     write_word_be(v->temp, &v->temp_offset, bits);
 }
 
+// The dictionary state before a position is fully described by how encode_matches filled
+// the dict_size slots behind it: whether each position was linked into its hash chain, and
+// the run length stored for it. Recording that per position lets the multithreaded packer
+// prove that a speculative match search ran on exactly the same dictionary as the real one.
+#define DICT_LOG_LINKED 0x10000
+
+void log_dict_entry(vars_t *v, uint32 entry)
+{
+    if (v->dict_log)
+        v->dict_log[v->dict_pos - v->dict_log_base] = entry;
+}
+
 void encode_matches(vars_t *v, uint16 w)
 {
     while (1)
@@ -541,12 +576,14 @@ void encode_matches(vars_t *v, uint16 w)
             count++;
 
         v->mem5[v->last_min_offset & 0x7FFF] = count;
+        log_dict_entry(v, DICT_LOG_LINKED | (uint16)count);
 
         while (1)
         {
             v->last_min_offset = (v->last_min_offset + 1) % v->dict_size;
 
             v->pack_block_start++;
+            v->dict_pos++;
 
             if (!(--w))
                 return;
@@ -555,6 +592,7 @@ void encode_matches(vars_t *v, uint16 w)
                 break;
 
             v->mem5[v->last_min_offset & 0x7FFF] = count;
+            log_dict_entry(v, (uint16)count);
 
             if (v->last_min_offset != v->mem4[v->last_min_offset & 0x7FFF])
             {
@@ -571,6 +609,285 @@ void encode_matches(vars_t *v, uint16 w)
     }
 }
 
+// Multithreaded packing
+//
+// Almost all of the packing time is spent in find_matches. Before the (sequential) packer
+// runs, the input is split into one segment per thread and each thread searches matches for
+// its segment on a private dictionary, starting dict_size + SPEC_WARMUP bytes early so that
+// the dictionary is filled by the time the segment starts. The threads ignore pack block
+// boundaries, so their parse can differ from the real one around block ends.
+//
+// The packer then runs as usual, but before searching at a position it checks whether the
+// thread owning that position searched there too, and whether both dictionaries were built
+// from identical dict_log entries over the last dict_size positions. If so, find_matches would
+// return exactly what the thread found and its result is reused; otherwise the packer searches
+// itself. The output is therefore always byte-identical to the single-threaded packer.
+
+#define SPEC_WARMUP 0x2000
+
+typedef struct spec_worker_s {
+    pthread_t thread;
+    vars_t *v;
+    uint32 start;     // where this thread's dictionary starts empty
+    uint32 first;     // first position the packer takes matches from
+    uint32 end;       // end of the segment
+    uint32 *matches;  // match_count | match_offset << 16 per position, 0 when not searched
+    uint32 *log;      // dict_log of this thread, from start onwards
+    uint32 log_size;
+} spec_worker_t;
+
+typedef struct spec_s {
+    uint8 *data;      // padded copy of the input
+    uint32 size;
+    uint16 *run;      // length of the byte run starting at each position
+    uint32 *log;      // dict_log of the packer
+    spec_worker_t *workers;
+    uint32 count;
+
+    // mismatching dict_log entries between the packer and workers[owner] before checked_pos
+    uint32 owner;
+    uint32 checked_pos;
+    uint32 mismatches;
+
+    uint32 reused;
+    uint32 searched;
+} spec_t;
+
+double get_time()
+{
+#ifdef _WIN32
+    LARGE_INTEGER counter, freq;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&freq);
+    return (double)counter.QuadPart / freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+#endif
+}
+
+uint32 get_cpu_count()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0) ? count : 1;
+#else
+    return 1;
+#endif
+}
+
+void *speculate_matches(void *arg)
+{
+    spec_worker_t *w = (spec_worker_t *)arg;
+    vars_t *v = w->v;
+    spec_t *spec = v->spec;
+
+    init_dicts(v);
+    v->last_min_offset = w->start % v->dict_size;
+    v->dict_pos = w->start;
+    v->dict_log = w->log;
+    v->dict_log_base = w->start;
+
+    v->pack_block_start = &spec->data[w->start];
+    v->pack_block_max = &spec->data[spec->size];
+
+    while ((v->pack_block_start < v->pack_block_max - 1) && v->dict_pos < w->end)
+    {
+        uint32 pos = v->dict_pos;
+
+        // Look no further ahead than the packer's buffer ever reaches, so long runs cost
+        // the same as in the packer.
+        v->pack_block_end = v->pack_block_start + 0xFFFF - v->dict_size;
+        if (v->pack_block_end > v->pack_block_max)
+            v->pack_block_end = v->pack_block_max;
+
+        find_and_check_matches(v);
+        w->matches[pos - w->start] = v->match_count | (v->match_offset << 16);
+
+        encode_matches(v, (v->match_count >= 2) ? v->match_count : 1);
+    }
+
+    return NULL;
+}
+
+uint32 worker_log_entry(spec_worker_t *w, uint32 pos)
+{
+    // positions before the thread started are still in their initial state
+    return (pos >= w->start) ? w->log[pos - w->start] : 0;
+}
+
+int is_dict_log_mismatch(spec_t *spec, spec_worker_t *w, uint32 pos)
+{
+    return spec->log[pos] != worker_log_entry(w, pos);
+}
+
+int reuse_speculative_match(vars_t *v)
+{
+    spec_t *spec = v->spec;
+    uint32 pos = v->dict_pos;
+    uint32 owner = spec->owner;
+
+    while (owner < spec->count - 1 && pos >= spec->workers[owner].end)
+        owner++;
+
+    spec_worker_t *w = &spec->workers[owner];
+    if (pos < w->first || pos >= w->end)
+        return 0;
+
+    uint32 found = w->matches[pos - w->start];
+    if (!found)
+        return 0;
+
+    // find_and_check_matches only looks ahead when the block has room for it
+    if (v->pack_block_max - v->pack_block_start < 3)
+        return 0;
+
+    // The thread's buffer always reaches at least as far as the packer's. Runs and matches
+    // reaching the end of the packer's buffer could be cut short differently.
+    uint32 avail = v->pack_block_end - v->pack_block_start;
+    if (pos + avail != spec->size && (avail <= (uint32)v->max_matches + 1 || spec->run[pos] >= avail || spec->run[pos + 1] >= avail - 1))
+        return 0;
+
+    uint32 window_start = (pos > v->dict_size) ? pos - v->dict_size : 0;
+
+    if (owner != spec->owner || spec->checked_pos < window_start)
+    {
+        spec->owner = owner;
+        spec->mismatches = 0;
+
+        for (uint32 i = window_start; i < pos; ++i)
+            spec->mismatches += is_dict_log_mismatch(spec, w, i);
+    }
+    else
+    {
+        for (uint32 i = spec->checked_pos; i < pos; ++i)
+        {
+            spec->mismatches += is_dict_log_mismatch(spec, w, i);
+
+            if (i >= v->dict_size)
+                spec->mismatches -= is_dict_log_mismatch(spec, w, i - v->dict_size);
+        }
+    }
+
+    spec->checked_pos = pos;
+
+    if (spec->mismatches)
+        return 0;
+
+    v->match_count = found & 0xFFFF;
+    v->match_offset = found >> 16;
+    spec->reused++;
+
+    return 1;
+}
+
+void find_or_reuse_matches(vars_t *v)
+{
+    if (v->spec && reuse_speculative_match(v))
+        return;
+
+    if (v->spec)
+        v->spec->searched++;
+
+    find_and_check_matches(v);
+}
+
+spec_t *start_speculation(vars_t *v)
+{
+    uint32 size = v->unpacked_size;
+    uint32 threads = v->threads ? v->threads : get_cpu_count();
+
+    uint32 warmup = v->dict_size + SPEC_WARMUP;
+
+    // every thread repeats the warmup, so segments much shorter than it are not worth it
+    if (threads > size / (warmup * 2))
+        threads = size / (warmup * 2);
+
+    if (threads < 2)
+        return NULL;
+
+    spec_t *spec = (spec_t *)calloc(1, sizeof(spec_t));
+    spec->size = size;
+    spec->count = threads;
+
+    // two bytes of padding for the hash of the last position
+    spec->data = (uint8 *)calloc(size + 2, 1);
+    memcpy(spec->data, &v->input[v->read_start_offset], size);
+
+    spec->run = (uint16 *)malloc((size + 1) * sizeof(uint16));
+    spec->run[size] = 0;
+    spec->run[size - 1] = 1;
+
+    for (uint32 i = size - 1; i-- > 0;)
+    {
+        if (spec->data[i] != spec->data[i + 1])
+            spec->run[i] = 1;
+        else
+            spec->run[i] = (spec->run[i + 1] < 0xFFFF) ? spec->run[i + 1] + 1 : 0xFFFF;
+    }
+
+    spec->log = (uint32 *)calloc(size + 1, sizeof(uint32));
+    spec->workers = (spec_worker_t *)calloc(threads, sizeof(spec_worker_t));
+
+    for (uint32 i = 0; i < threads; ++i)
+    {
+        spec_worker_t *w = &spec->workers[i];
+
+        w->first = (uint32)((unsigned long long)size * i / threads);
+        w->end = (uint32)((unsigned long long)size * (i + 1) / threads);
+        w->start = (w->first > warmup) ? w->first - warmup : 0;
+
+        w->matches = (uint32 *)calloc(w->end - w->start, sizeof(uint32));
+        w->log_size = w->end - w->start + v->max_matches + 1;
+        w->log = (uint32 *)calloc(w->log_size, sizeof(uint32));
+
+        w->v = (vars_t *)malloc(sizeof(vars_t));
+        memcpy(w->v, v, sizeof(vars_t));
+        w->v->spec = spec;
+        w->v->mem2 = (uint16 *)malloc(0x10000);
+        w->v->mem3 = (uint16 *)malloc(0x10000);
+        w->v->mem4 = (uint16 *)malloc(0x10000);
+        w->v->mem5 = (uint16 *)malloc(0x10000);
+    }
+
+    for (uint32 i = 1; i < threads; ++i)
+        pthread_create(&spec->workers[i].thread, NULL, speculate_matches, &spec->workers[i]);
+
+    speculate_matches(&spec->workers[0]);
+
+    for (uint32 i = 1; i < threads; ++i)
+        pthread_join(spec->workers[i].thread, NULL);
+
+    return spec;
+}
+
+void free_speculation(spec_t *spec)
+{
+    for (uint32 i = 0; i < spec->count; ++i)
+    {
+        spec_worker_t *w = &spec->workers[i];
+
+        free(w->v->mem2);
+        free(w->v->mem3);
+        free(w->v->mem4);
+        free(w->v->mem5);
+        free(w->v);
+        free(w->matches);
+        free(w->log);
+    }
+
+    free(spec->workers);
+    free(spec->log);
+    free(spec->run);
+    free(spec->data);
+    free(spec);
+}
+
 void proc_6(vars_t *v)
 {
     v->v17 = 0;
@@ -601,7 +918,7 @@ void proc_6(vars_t *v)
 
         while ((v->pack_block_start < v->pack_block_max - 1) && v->v17 < 0xFFFE)
         {
-            find_and_check_matches(v);
+            find_or_reuse_matches(v);
 
             if (v->match_count >= 2)
             {
@@ -1069,6 +1386,18 @@ void do_pack_data(vars_t *v)
 
     init_dicts(v);
 
+    v->dict_pos = 0;
+
+    double start = get_time();
+    v->spec = start_speculation(v);
+    v->spec_time = get_time() - start;
+
+    if (v->spec)
+    {
+        v->dict_log = v->spec->log;
+        v->dict_log_base = 0;
+    }
+
     write_dword_be(v->output, &v->output_offset, (RNC_SIGN << 8) | (v->method & 0xFF));
     write_dword_be(v->output, &v->output_offset, v->unpacked_size);
     write_dword_be(v->output, &v->output_offset, 0);
@@ -1120,6 +1449,15 @@ void do_pack_data(vars_t *v)
     free(v->mem3);
     free(v->mem4);
     free(v->mem5);
+
+    v->spec_reused = v->spec ? v->spec->reused : 0;
+    v->spec_searched = v->spec ? v->spec->searched : 0;
+
+    if (v->spec)
+        free_speculation(v->spec);
+
+    v->spec = NULL;
+    v->dict_log = NULL;
 }
 
 int do_pack(vars_t *v)
@@ -1567,12 +1905,54 @@ int do_search(vars_t *v, size_t input_size, int save)
     return has_rncs ? 0 : ((error_code == 6) ? 11 : error_code);
 }
 
+// Packs the input single-threaded and multithreaded, and checks that both outputs match.
+int do_benchmark(vars_t *v)
+{
+    uint32 threads = v->threads ? v->threads : get_cpu_count();
+    uint8 *reference = (uint8 *)malloc(MAX_BUF_SIZE);
+    int error_code;
+
+    v->threads = 1;
+    double start = get_time();
+    if ((error_code = do_pack(v)))
+    {
+        free(reference);
+        return error_code;
+    }
+    double single_time = get_time() - start;
+
+    size_t reference_size = v->output_offset;
+    memcpy(reference, v->output, reference_size);
+
+    v->threads = threads;
+    start = get_time();
+    do_pack(v);
+    double multi_time = get_time() - start;
+
+    double mb = v->file_size / (1024.0 * 1024.0);
+    printf("Input: %u bytes, packed: %zu bytes (method %u)\n", v->file_size, reference_size, v->method);
+    printf("1 thread   : %8.3f s (%6.2f MB/s)\n", single_time, mb / single_time);
+    printf("%-2u threads : %8.3f s (%6.2f MB/s), %.2fx\n", threads, multi_time, mb / multi_time, single_time / multi_time);
+    printf("            (%.3f s searching on threads, %.3f s packing)\n", v->spec_time, multi_time - v->spec_time);
+    printf("Matches reused from threads: %u, searched by packer: %u\n", v->spec_reused, v->spec_searched);
+
+    if (v->output_offset != reference_size || memcmp(reference, v->output, reference_size))
+    {
+        printf("Multithreaded output differs from single-threaded output!\n");
+        error_code = 13;
+    }
+
+    free(reference);
+    return error_code;
+}
+
 void print_usage()
 {
     printf("Unpack        : <u> <infile.bin> [outfile.bin] [-i=hex_offset_to_read_from] [-k=hex_key_if_protected]\n");
     printf("Search        : <s> <infile.bin>\n");
     printf("Seach&Extract : <e> <infile.bin>\n");
-    printf("Pack          : <p> <infile.bin> [outfile.bin] <-m=1|2> [-k=hex_key_to_protect]\n");
+    printf("Pack          : <p> <infile.bin> [outfile.bin] <-m=1|2> [-k=hex_key_to_protect] [-t=threads]\n");
+    printf("Benchmark     : <b> <infile.bin> <-m=1|2> [-t=threads]\n");
 }
 
 int parse_args(int argc, char **argv, vars_t *vars)
@@ -1580,7 +1960,7 @@ int parse_args(int argc, char **argv, vars_t *vars)
     if (argc < 2)
         return 1;
 
-    if (strchr("puse", argv[1][0]))
+    if (strchr("puseb", argv[1][0]))
     {
         switch (argv[1][0])
         {
@@ -1588,6 +1968,7 @@ int parse_args(int argc, char **argv, vars_t *vars)
         case 'u':
         case 's':
         case 'e':
+        case 'b':
             vars->puse_mode = argv[1][0]; break;
         }
     }
@@ -1629,6 +2010,9 @@ int parse_args(int argc, char **argv, vars_t *vars)
                 if (!vars->method || vars->method > 2)
                     return 3;
                 break;
+            case 't':
+                sscanf(arg_ptr, "%u", &vars->threads);
+                break;
             default:
                 break;
             }
@@ -1697,9 +2081,10 @@ int main(int argc, char *argv[])
     case 'u': error_code = do_unpack(v); break;
     case 's':
     case 'e': error_code = do_search(v, v->file_size, v->puse_mode == 'e'); break;
+    case 'b': error_code = do_benchmark(v); break;
     }
 
-    if (!error_code && v->puse_mode != 's' && v->puse_mode != 'e')
+    if (!error_code && v->puse_mode != 's' && v->puse_mode != 'e' && v->puse_mode != 'b')
     {
         FILE *out;
         if (argc <= 3 || ((argv[3][0] == '-') || (argv[3][0] == '/')))
@@ -1,7 +1,7 @@
 # Compress binary file
 $(BUILD_DIR)/%.szp: $(BUILD_DIR)/%.bin
 	$(call print,Compressing:,$<,$@)
-	$(V)$(YAY0TOOL) $< $@
+	$(V)$(call compress,$<,$@,$(YAY0TOOL) {in} {out})
 
 # convert binary szp to object file
 $(BUILD_DIR)/%.szp.o: $(BUILD_DIR)/%.szp